@@ -0,0 +1,202 @@
+// bench_adaptive_sync.cpp
+// Release-to-wake latency of std::latch and std::barrier versus the spin-then-futex
+// AdaptiveLatch and AdaptiveBarrier from cpp20/standard_library/adaptive_sync.hpp,
+// plus phases per second for back-to-back barrier phases.
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp20/standard_library/adaptive_sync.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double ms_between(clock_type::time_point a, clock_type::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Spins (without sleeping) until `delay` has passed, so that the release happens at a
+// well-defined time after the waiters started waiting.
+void busy_delay(std::chrono::microseconds delay) {
+    const auto until = clock_type::now() + delay;
+    while (clock_type::now() < until) std::this_thread::yield();
+}
+
+// Each round: `waiters` threads wait on a fresh latch, the main thread counts it down
+// after `delay`. Every sample is one waiter's time from count_down() to wait() returning.
+template<typename MakeLatch>
+std::vector<double> latch_wake_latency(MakeLatch make_latch, int waiters, int rounds, std::chrono::microseconds delay) {
+    std::vector<double> samples;
+    for (int r = 0; r < rounds; ++r) {
+        auto latch = make_latch();
+        std::vector<clock_type::time_point> woke(static_cast<std::size_t>(waiters));
+        std::vector<std::thread> threads;
+        for (int w = 0; w < waiters; ++w) {
+            threads.emplace_back([&, w] {
+                latch->wait();
+                woke[static_cast<std::size_t>(w)] = clock_type::now();
+            });
+        }
+        busy_delay(delay);
+        const auto released = clock_type::now();
+        latch->count_down();
+        for (std::thread& t : threads) t.join();
+        for (const auto& t : woke) samples.push_back(ms_between(released, t));
+    }
+    return samples;
+}
+
+// Completion function that stamps the moment a barrier phase is released.
+struct StampRelease {
+    std::atomic<clock_type::rep>* released;
+    void operator()() noexcept { released->store(clock_type::now().time_since_epoch().count(), std::memory_order_relaxed); }
+};
+
+// `participants` threads run `phases` barrier phases. In every phase one thread (a
+// different one each time) arrives `delay` late, so the others really wait; each of
+// them records how long after the release (stamped by the completion) it woke up.
+template<typename MakeBarrier>
+std::vector<double> barrier_wake_latency(MakeBarrier make_barrier, int participants, int phases,
+                                         std::chrono::microseconds delay) {
+    std::vector<std::vector<double>> per_thread(static_cast<std::size_t>(participants));
+    std::atomic<clock_type::rep> released{0};
+    auto barrier = make_barrier(participants, StampRelease{&released});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < participants; ++t) {
+        threads.emplace_back([&, t] {
+            for (int p = 0; p < phases; ++p) {
+                const bool late = t == p % participants;
+                if (late) busy_delay(delay);
+                barrier->arrive_and_wait();
+                const auto now = clock_type::now();
+                if (!late) {
+                    const clock_type::time_point rel{clock_type::duration(released.load(std::memory_order_relaxed))};
+                    per_thread[static_cast<std::size_t>(t)].push_back(ms_between(rel, now));
+                }
+                barrier->arrive_and_wait(); // Keeps `released` stable until everyone has read it
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    std::vector<double> samples;
+    for (const auto& v : per_thread) samples.insert(samples.end(), v.begin(), v.end());
+    return samples;
+}
+
+// Back-to-back phases with no work: phases per second.
+template<typename Barrier>
+void barrier_throughput(Barrier& barrier, int participants, int phases) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < participants; ++t) {
+        threads.emplace_back([&] {
+            for (int p = 0; p < phases; ++p) barrier.arrive_and_wait();
+        });
+    }
+    for (std::thread& t : threads) t.join();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("adaptive_sync", bench::parse_args(argc, argv));
+    const int threads = static_cast<int>(bench::int_option(runner.options(), "threads",
+        std::max(2, static_cast<int>(std::thread::hardware_concurrency()))));
+    const int rounds = static_cast<int>(bench::int_option(runner.options(), "rounds", 300));
+    const auto delay = std::chrono::microseconds(bench::int_option(runner.options(), "delay-us", 50));
+    const auto spin = std::chrono::nanoseconds(bench::int_option(runner.options(), "spin-ns",
+        adaptive_detail::default_spin().count()));
+    const int phases = static_cast<int>(bench::int_option(runner.options(), "phases", 20000));
+    runner.add_context("threads", std::to_string(threads));
+    runner.add_context("delay_us", std::to_string(delay.count()));
+    runner.add_context("spin_ns", std::to_string(spin.count()));
+
+    const int waiters = std::max(1, threads - 1);
+    const std::chrono::nanoseconds no_spin(0);
+
+    // --- Latch: release-to-wake latency (one sample per waiter and round) ---
+    if (runner.enabled("latch_wake/std_latch")) {
+        runner.record("latch_wake/std_latch",
+            latch_wake_latency([&] { return std::make_unique<std::latch>(1); }, waiters, rounds, delay), 1);
+    }
+    if (runner.enabled("latch_wake/adaptive")) {
+        runner.record("latch_wake/adaptive",
+            latch_wake_latency([&] { return std::make_unique<AdaptiveLatch>(1, spin); }, waiters, rounds, delay), 1);
+    }
+    if (runner.enabled("latch_wake/futex_only")) {
+        runner.record("latch_wake/futex_only",
+            latch_wake_latency([&] { return std::make_unique<AdaptiveLatch>(1, no_spin); }, waiters, rounds, delay), 1);
+    }
+
+    // --- Barrier: release-to-wake latency (one sample per waiting thread and phase) ---
+    if (runner.enabled("barrier_wake/std_barrier")) {
+        runner.record("barrier_wake/std_barrier", barrier_wake_latency([](int n, StampRelease stamp) {
+            return std::make_unique<std::barrier<StampRelease>>(n, stamp);
+        }, threads, rounds, delay), 1);
+    }
+    if (runner.enabled("barrier_wake/adaptive")) {
+        runner.record("barrier_wake/adaptive", barrier_wake_latency([&](int n, StampRelease stamp) {
+            return std::make_unique<AdaptiveBarrier<StampRelease>>(n, stamp, spin);
+        }, threads, rounds, delay), 1);
+    }
+    if (runner.enabled("barrier_wake/futex_only")) {
+        runner.record("barrier_wake/futex_only", barrier_wake_latency([&](int n, StampRelease stamp) {
+            return std::make_unique<AdaptiveBarrier<StampRelease>>(n, stamp, no_spin);
+        }, threads, rounds, delay), 1);
+    }
+
+    // --- Barrier: back-to-back phases per second ---
+    {
+        std::barrier<> std_barrier(threads);
+        runner.run("barrier_phases/std_barrier", [&] { barrier_throughput(std_barrier, threads, phases); }, double(phases));
+        AdaptiveBarrier<> adaptive(threads, NoCompletion(), spin);
+        runner.run("barrier_phases/adaptive", [&] { barrier_throughput(adaptive, threads, phases); }, double(phases));
+        AdaptiveBarrier<> futex_only(threads, NoCompletion(), no_spin);
+        runner.run("barrier_phases/futex_only", [&] { barrier_throughput(futex_only, threads, phases); }, double(phases));
+    }
+
+    return runner.finish();
+}
+
+/*
+Explanation:
+Measures how late a waiting thread notices that it has been released, the figure that
+limits how short a synchronized phase can usefully be. All latencies are per waiting
+thread; median and p95 are reported (items/s is then simply 1/latency).
+
+-   latch_wake/...: --threads - 1 threads wait on a latch with count 1; after --delay-us
+    the main thread counts it down. Sample: time from count_down() to wait() returning.
+-   barrier_wake/...: --threads threads run --rounds phases; in every phase one thread
+    arrives --delay-us late. Sample: time from the barrier's completion function
+    (the release) to arrive_and_wait() returning in a thread that was waiting.
+-   barrier_phases/...: --phases back-to-back phases without any work (phases per
+    second), i.e. the pure cost of one barrier round trip.
+
+Variants:
+-   std_latch / std_barrier: the standard library (libstdc++ spins briefly, then
+    waits on a futex through std::atomic::wait).
+-   adaptive: `AdaptiveLatch` / `AdaptiveBarrier` spinning for --spin-ns (default
+    20 us, 0 on single-CPU machines), then parking on a futex.
+-   futex_only: the same with no spinning at all (always sleeps in the kernel).
+
+If --delay-us is longer than the spin time, the adaptive waiters are already parked
+at the release, and the difference comes from skipping work in the wake-up path;
+set --spin-ns above the delay to see pure spinning. The waiting threads need cores
+of their own, otherwise every variant measures the scheduler.
+
+Options: --threads=N (default: hardware threads, at least 2), --rounds=N (default 300),
+--delay-us=N (default 50), --spin-ns=N, --phases=N (default 20000), plus the common
+harness options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_adaptive_sync`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_adaptive_sync.cpp -o bench_adaptive_sync -pthread
+./bench_adaptive_sync --threads=4 --spin-ns=100000 --json=adaptive_sync.json
+*/
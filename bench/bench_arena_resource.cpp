@@ -0,0 +1,245 @@
+// bench_arena_resource.cpp
+// Build-and-discard request workloads: each request builds Widgets
+// (cpp14/standard_library/std_make_unique.cpp) and MyDataStructures
+// (cpp11/core_language/initializer_lists.cpp), reads them and throws them away.
+// Global heap with std:: types versus pmr-enabled variants on new/delete,
+// std::pmr::monotonic_buffer_resource and MonotonicArena/ArenaResource from
+// cpp17/standard_library/arena_resource.hpp.
+#include <cstdio>
+#include <initializer_list>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp17/standard_library/arena_resource.hpp"
+
+namespace {
+
+// --- The example types, without printing ---
+
+struct Widget {
+    int id;
+    std::string name;
+    std::vector<double> data;
+
+    Widget(int i, std::string_view n, std::size_t values) : id(i), name(n), data(values, 1.0) {}
+};
+
+struct MyDataStructure {
+    std::vector<int> data_vec;
+    std::string id;
+
+    MyDataStructure(std::string_view identifier, std::initializer_list<int> list) : id(identifier) {
+        for (int val : list) data_vec.push_back(val * 10);
+    }
+};
+
+// --- pmr-enabled variants: the members allocate from the resource they are given,
+// and the allocator_type typedef plus the allocator-extended constructors let a
+// std::pmr container pass its resource on (uses-allocator construction). ---
+
+struct PmrWidget {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    int id;
+    std::pmr::string name;
+    std::pmr::vector<double> data;
+
+    PmrWidget(int i, std::string_view n, std::size_t values, const allocator_type& alloc = {})
+        : id(i), name(n, alloc), data(values, 1.0, alloc) {}
+    PmrWidget(const PmrWidget& other, const allocator_type& alloc)
+        : id(other.id), name(other.name, alloc), data(other.data, alloc) {}
+    PmrWidget(PmrWidget&& other, const allocator_type& alloc)
+        : id(other.id), name(std::move(other.name), alloc), data(std::move(other.data), alloc) {}
+    PmrWidget(PmrWidget&&) noexcept = default;
+};
+
+struct PmrDataStructure {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::vector<int> data_vec;
+    std::pmr::string id;
+
+    PmrDataStructure(std::string_view identifier, std::initializer_list<int> list, const allocator_type& alloc = {})
+        : data_vec(alloc), id(identifier, alloc) {
+        for (int val : list) data_vec.push_back(val * 10);
+    }
+    PmrDataStructure(const PmrDataStructure& other, const allocator_type& alloc)
+        : data_vec(other.data_vec, alloc), id(other.id, alloc) {}
+    PmrDataStructure(PmrDataStructure&& other, const allocator_type& alloc)
+        : data_vec(std::move(other.data_vec), alloc), id(std::move(other.id), alloc) {}
+    PmrDataStructure(PmrDataStructure&&) noexcept = default;
+};
+
+// Upstream resource that counts the calls reaching the global heap.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    long long allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+struct Shape {
+    std::size_t widgets;    // Widgets per request
+    std::size_t values;     // Doubles per widget
+    std::size_t structures; // MyDataStructures per request
+};
+
+// A name longer than std::string's small buffer, so every name allocates.
+std::string_view widget_name(char (&buffer)[64], int request, std::size_t i) {
+    const int n = std::snprintf(buffer, sizeof(buffer), "widget-%zu-of-request-%d", i, request);
+    return std::string_view(buffer, static_cast<std::size_t>(n));
+}
+
+long long std_request(int request, const Shape& shape) {
+    std::vector<Widget> widgets;
+    widgets.reserve(shape.widgets);
+    char buffer[64];
+    for (std::size_t i = 0; i < shape.widgets; ++i)
+        widgets.emplace_back(static_cast<int>(i), widget_name(buffer, request, i), shape.values);
+    std::vector<MyDataStructure> structures;
+    for (std::size_t i = 0; i < shape.structures; ++i)
+        structures.emplace_back("structure-of-the-request", std::initializer_list<int>{1, 2, 3, 4, 5, 6, 7, 8});
+
+    long long sum = 0;
+    for (const Widget& w : widgets) sum += w.id + static_cast<long long>(w.name.size() + w.data.size());
+    for (const MyDataStructure& s : structures) sum += s.data_vec.back() + static_cast<long long>(s.id.size());
+    return sum;
+}
+
+long long pmr_request(int request, const Shape& shape, std::pmr::memory_resource* resource) {
+    std::pmr::vector<PmrWidget> widgets(resource);
+    widgets.reserve(shape.widgets);
+    char buffer[64];
+    for (std::size_t i = 0; i < shape.widgets; ++i)
+        widgets.emplace_back(static_cast<int>(i), widget_name(buffer, request, i), shape.values);
+    std::pmr::vector<PmrDataStructure> structures(resource);
+    for (std::size_t i = 0; i < shape.structures; ++i)
+        structures.emplace_back("structure-of-the-request", std::initializer_list<int>{1, 2, 3, 4, 5, 6, 7, 8});
+
+    long long sum = 0;
+    for (const PmrWidget& w : widgets) sum += w.id + static_cast<long long>(w.name.size() + w.data.size());
+    for (const PmrDataStructure& s : structures) sum += s.data_vec.back() + static_cast<long long>(s.id.size());
+    return sum;
+}
+
+// One request on each kind of memory; all share this signature for the runner.
+struct Variant {
+    const char* name;
+    long long (*handle)(int request, const Shape& shape, CountingResource& upstream, MonotonicArena& arena);
+};
+
+const Variant kVariants[] = {
+    {"std_heap", [](int r, const Shape& s, CountingResource&, MonotonicArena&) { return std_request(r, s); }},
+    {"pmr_new_delete", [](int r, const Shape& s, CountingResource& up, MonotonicArena&) {
+         return pmr_request(r, s, &up);
+     }},
+    {"pmr_monotonic", [](int r, const Shape& s, CountingResource& up, MonotonicArena&) {
+         std::pmr::monotonic_buffer_resource resource(4096, &up); // Fresh blocks every request
+         return pmr_request(r, s, &resource);
+     }},
+    {"pmr_monotonic_stack", [](int r, const Shape& s, CountingResource& up, MonotonicArena&) {
+         alignas(std::max_align_t) char stack[16 * 1024];
+         std::pmr::monotonic_buffer_resource resource(stack, sizeof(stack), &up);
+         return pmr_request(r, s, &resource);
+     }},
+    {"arena_reset", [](int r, const Shape& s, CountingResource&, MonotonicArena& arena) {
+         ArenaResource resource(arena);
+         const long long sum = pmr_request(r, s, &resource);
+         arena.reset(); // Keeps the blocks for the next request
+         return sum;
+     }},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("arena_resource", bench::parse_args(argc, argv));
+    const int requests = static_cast<int>(bench::int_option(runner.options(), "requests", 2000));
+    Shape shape;
+    shape.widgets = static_cast<std::size_t>(bench::int_option(runner.options(), "widgets", 64));
+    shape.values = static_cast<std::size_t>(bench::int_option(runner.options(), "values", 16));
+    shape.structures = static_cast<std::size_t>(bench::int_option(runner.options(), "structures", 16));
+    runner.add_context("requests", std::to_string(requests));
+    runner.add_context("widgets", std::to_string(shape.widgets));
+    runner.add_context("values", std::to_string(shape.values));
+    runner.add_context("structures", std::to_string(shape.structures));
+
+    const long long expected = std_request(0, shape);
+    bool ok = true;
+    std::vector<std::pair<std::string, double>> upstream_per_request;
+
+    for (const Variant& v : kVariants) {
+        const std::string name = std::string("requests/") + v.name;
+        if (!runner.enabled(name)) continue;
+        CountingResource upstream;
+        MonotonicArena arena(4096, &upstream); // Used by arena_reset only
+        if (v.handle(0, shape, upstream, arena) != expected) ok = false;
+
+        runner.run(name, [&] {
+            long long sum = 0;
+            for (int r = 0; r < requests; ++r) sum += v.handle(r, shape, upstream, arena);
+            bench::do_not_optimize(sum);
+        }, double(requests));
+
+        // Calls reaching the upstream resource in a steady state (after the runs above).
+        upstream.allocations = 0;
+        for (int r = 0; r < 100; ++r) bench::do_not_optimize(v.handle(r, shape, upstream, arena));
+        upstream_per_request.emplace_back(v.name, upstream.allocations / 100.0);
+    }
+
+    std::printf("\nUpstream (global heap) allocations per request, steady state:\n");
+    for (const auto& entry : upstream_per_request) {
+        if (entry.first == "std_heap") std::printf("  %-22s (not counted: plain std::allocator)\n", entry.first.c_str());
+        else std::printf("  %-22s %8.1f\n", entry.first.c_str(), entry.second);
+        runner.add_context("upstream_allocations_per_request_" + entry.first, std::to_string(entry.second));
+    }
+
+    if (!ok) std::cout << "ERROR: a variant computed a different request result!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Requests per second for a request-scoped workload. Each request builds --widgets
+Widgets (id, a name longer than the small-string buffer, --values doubles) and
+--structures MyDataStructures (an id string and a vector grown by push_back from an
+initializer list), reads them once, and discards everything:
+-   std_heap: the original types with std::string/std::vector on the global heap:
+    one malloc and one free per string, vector buffer and growth step.
+-   pmr_new_delete: the pmr-enabled types (PmrWidget, PmrDataStructure) on a resource
+    that forwards to new/delete: the cost of the pmr indirection alone.
+-   pmr_monotonic: a std::pmr::monotonic_buffer_resource per request; its blocks are
+    allocated from the heap for every request and returned at its end.
+-   pmr_monotonic_stack: the same with a 16 KiB stack buffer as its first block.
+-   arena_reset: one MonotonicArena for all requests behind an ArenaResource,
+    reset() after each request: the blocks stay, so a steady-state request does not
+    call the heap at all.
+
+The pmr types carry `allocator_type` and allocator-extended constructors, so
+`std::pmr::vector<PmrWidget>` passes its resource on to each widget's name and data
+(uses-allocator construction): everything the request builds lands in the one
+resource. After the timed runs, 100 more requests count the calls that reach the
+global heap per request (printed, and stored in the JSON context); the steady-state
+number for arena_reset is 0.
+
+Options: --requests=N (default 2000), --widgets=N (default 64), --values=N (default
+16), --structures=N (default 16), plus the common harness options (--samples,
+--warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_arena_resource`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_arena_resource.cpp -o bench_arena_resource
+./bench_arena_resource --json=arena_resource.json
+*/
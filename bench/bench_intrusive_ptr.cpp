@@ -0,0 +1,158 @@
+// bench_intrusive_ptr.cpp
+// Shared ownership costs: std::shared_ptr (created with new and with make_shared)
+// versus IntrusivePtr from cpp11/standard_library/intrusive_ptr.hpp with an atomic
+// and with a plain (single-thread) embedded count. Creation, passing by value as
+// process_shared() in smart_pointers.cpp does, and copying whole vectors.
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/standard_library/intrusive_ptr.hpp"
+
+namespace {
+
+struct Resource {
+    explicit Resource(int v) : value(v) {}
+    int value;
+};
+
+struct AtomicResource : RefCounted<AtomicResource> {
+    explicit AtomicResource(int v) : value(v) {}
+    int value;
+};
+
+struct PlainResource : RefCounted<PlainResource, PlainRefCount> {
+    explicit PlainResource(int v) : value(v) {}
+    int value;
+};
+
+// How each variant creates an owner.
+struct SharedNew {
+    typedef std::shared_ptr<Resource> Ptr;
+    static Ptr make(int v) { return Ptr(new Resource(v)); }
+};
+struct SharedMake {
+    typedef std::shared_ptr<Resource> Ptr;
+    static Ptr make(int v) { return std::make_shared<Resource>(v); }
+};
+struct IntrusiveAtomic {
+    typedef IntrusivePtr<AtomicResource> Ptr;
+    static Ptr make(int v) { return make_intrusive<AtomicResource>(v); }
+};
+struct IntrusivePlain {
+    typedef IntrusivePtr<PlainResource> Ptr;
+    static Ptr make(int v) { return make_intrusive<PlainResource>(v); }
+};
+
+// Not inlined, so the by-value parameter really is constructed and destroyed per call.
+template<typename Ptr>
+[[gnu::noinline]] long long consume_by_value(Ptr p) {
+    return p->value;
+}
+
+template<typename Ptr>
+[[gnu::noinline]] long long consume_by_ref(const Ptr& p) {
+    return p->value;
+}
+
+template<typename Variant>
+void run_variant(bench::Runner& runner, const std::string& name, std::size_t count, std::size_t calls, bool& ok) {
+    typedef typename Variant::Ptr Ptr;
+    const long long expected = static_cast<long long>(count) * (static_cast<long long>(count) - 1) / 2;
+
+    // Create `count` owners, then destroy them all.
+    runner.run("create/" + name, [&] {
+        std::vector<Ptr> owners;
+        owners.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) owners.push_back(Variant::make(static_cast<int>(i)));
+        bench::do_not_optimize(owners.data());
+    }, double(count));
+
+    std::vector<Ptr> owners;
+    for (std::size_t i = 0; i < count; ++i) owners.push_back(Variant::make(static_cast<int>(i)));
+
+    // `calls` calls taking the pointer by value: one increment and one decrement each.
+    runner.run("pass_by_value/" + name, [&] {
+        long long sum = 0;
+        for (std::size_t c = 0; c < calls; ++c) sum += consume_by_value<Ptr>(owners[c % count]);
+        bench::do_not_optimize(sum);
+    }, double(calls));
+
+    // Copy the vector of owners (an increment per element), then destroy the copy.
+    runner.run("copy_vector/" + name, [&] {
+        std::vector<Ptr> copy = owners;
+        long long sum = 0;
+        for (const Ptr& p : copy) sum += p->value;
+        if (sum != expected) ok = false;
+    }, double(count));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("intrusive_ptr", bench::parse_args(argc, argv));
+    const std::size_t count = static_cast<std::size_t>(bench::int_option(runner.options(), "count", 100000));
+    const std::size_t calls = static_cast<std::size_t>(bench::int_option(runner.options(), "calls", 1000000));
+    runner.add_context("count", std::to_string(count));
+    runner.add_context("calls", std::to_string(calls));
+    runner.add_context("sizeof_shared_ptr", std::to_string(sizeof(std::shared_ptr<Resource>)));
+    runner.add_context("sizeof_intrusive_ptr", std::to_string(sizeof(IntrusivePtr<AtomicResource>)));
+
+    bool ok = true;
+    run_variant<SharedNew>(runner, "shared_new", count, calls, ok);
+    run_variant<SharedMake>(runner, "shared_make", count, calls, ok);
+    run_variant<IntrusiveAtomic>(runner, "intrusive_atomic", count, calls, ok);
+    run_variant<IntrusivePlain>(runner, "intrusive_plain", count, calls, ok);
+
+    // Baseline: passing by const reference touches no count at all.
+    {
+        std::vector<std::shared_ptr<Resource>> owners;
+        for (std::size_t i = 0; i < count; ++i) owners.push_back(std::make_shared<Resource>(static_cast<int>(i)));
+        runner.run("pass_by_const_ref/shared_make", [&] {
+            long long sum = 0;
+            for (std::size_t c = 0; c < calls; ++c) sum += consume_by_ref(owners[c % count]);
+            bench::do_not_optimize(sum);
+        }, double(calls));
+    }
+
+    if (!ok) std::cout << "ERROR: a copied vector of pointers summed to a wrong value!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Operations per second for four ways of sharing ownership of a small object:
+-   shared_new: `std::shared_ptr<T>(new T)`: two allocations (object and control block).
+-   shared_make: `std::make_shared<T>()`: one allocation holding both.
+-   intrusive_atomic: `IntrusivePtr<T>` with `RefCounted<T>` (atomic count inside T).
+-   intrusive_plain: `IntrusivePtr<T>` with `RefCounted<T, PlainRefCount>`
+    (ordinary integer; single-threaded use only).
+
+Workloads:
+-   create/...: create --count owners into a reserved vector, then destroy them.
+-   pass_by_value/...: --calls calls of a non-inlined function taking the pointer by
+    value, as process_shared() in smart_pointers.cpp does: one count increment and
+    one decrement per call. pass_by_const_ref/shared_make is the same with
+    `const std::shared_ptr<T>&` and shows that passing by reference avoids the cost
+    altogether.
+-   copy_vector/...: copy a vector of --count owners (one increment each), read
+    through every copy, destroy the copy (one decrement each).
+
+On a single thread the atomic instructions are uncontended, so the difference
+between atomic and plain counts is the cost of the locked instruction itself
+(roughly 5-20 cycles); with the objects shared between threads, every atomic
+update also moves the cache line. shared_new additionally touches a control block
+on another cache line. Note that libstdc++ updates `shared_ptr` counts without
+atomic instructions while the program has never started a thread, so in this
+(single-threaded) benchmark shared_* compares most fairly with intrusive_plain;
+any program that starts a thread pays the atomic cost for the rest of its life.
+
+Options: --count=N (default 100000), --calls=N (default 1000000), plus the common
+harness options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_intrusive_ptr`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_intrusive_ptr.cpp -o bench_intrusive_ptr -pthread
+./bench_intrusive_ptr --json=intrusive_ptr.json
+*/
@@ -0,0 +1,186 @@
+// bench_mpmc_queue.cpp
+// Producer/consumer throughput and hand-off latency of the lock-free queues in
+// cpp11/standard_library/mpmc_queue.hpp versus a bounded queue built from
+// std::mutex and std::condition_variable.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/standard_library/mpmc_queue.hpp"
+
+namespace {
+
+// The textbook blocking queue: one lock, "not full" and "not empty" conditions.
+template<typename T>
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(const T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+        items_.push_back(value);
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+    void pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !items_.empty(); });
+        out = items_.front();
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+    }
+
+private:
+    const std::size_t capacity_;
+    std::deque<T> items_;
+    std::mutex mutex_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+// Every producer pushes values 1..n; each consumer pops until it has taken its share.
+// Returns false if the sum of everything popped is wrong.
+template<typename Queue>
+bool run_transfer(Queue& queue, int producers, int consumers, long long per_producer) {
+    const long long total = producers * per_producer;
+    std::atomic<long long> sum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (long long i = 1; i <= per_producer; ++i) queue.push(static_cast<std::uint64_t>(i));
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        const long long share = total / consumers + (c < total % consumers ? 1 : 0);
+        threads.emplace_back([&, share] {
+            long long local = 0;
+            std::uint64_t value = 0;
+            for (long long i = 0; i < share; ++i) {
+                queue.pop(value);
+                local += static_cast<long long>(value);
+            }
+            sum += local;
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    return sum.load() == producers * (per_producer * (per_producer + 1) / 2);
+}
+
+// One message bounces between two threads over two queues; returns each round trip in ms.
+template<typename Queue>
+std::vector<double> run_ping_pong(Queue& ping, Queue& pong, long long round_trips) {
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(round_trips));
+    std::thread echo([&] {
+        std::uint64_t value = 0;
+        for (long long i = 0; i < round_trips; ++i) {
+            ping.pop(value);
+            pong.push(value + 1);
+        }
+    });
+    std::uint64_t value = 0;
+    for (long long i = 0; i < round_trips; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        ping.push(value);
+        pong.pop(value);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    echo.join();
+    return samples;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("mpmc_queue", bench::parse_args(argc, argv));
+    const long long items = bench::int_option(runner.options(), "items", 1000000);
+    const std::size_t capacity = static_cast<std::size_t>(bench::int_option(runner.options(), "capacity", 1024));
+    const long long round_trips = bench::int_option(runner.options(), "round-trips", 20000);
+    runner.add_context("items", std::to_string(items));
+    runner.add_context("capacity", std::to_string(capacity));
+
+    bool ok = true;
+    std::vector<std::pair<int, int>> configs = {{1, 1}, {2, 2}, {4, 4}, {1, 4}, {4, 1}};
+    const long long producers = bench::int_option(runner.options(), "producers", -1);
+    const long long consumers = bench::int_option(runner.options(), "consumers", -1);
+    if (producers > 0 || consumers > 0) {
+        configs = {{static_cast<int>(producers > 0 ? producers : 1), static_cast<int>(consumers > 0 ? consumers : 1)}};
+    }
+
+    for (const auto& config : configs) {
+        const int p = config.first, c = config.second;
+        const long long per_producer = items / p;
+        const double moved = double(per_producer * p);
+        const std::string prefix = "p" + std::to_string(p) + "c" + std::to_string(c) + "/";
+        runner.run(prefix + "mutex_cv", [&] {
+            LockedQueue<std::uint64_t> queue(capacity);
+            ok &= run_transfer(queue, p, c, per_producer);
+        }, moved);
+        runner.run(prefix + "mpmc", [&] {
+            MpmcQueue<std::uint64_t> queue(capacity);
+            ok &= run_transfer(queue, p, c, per_producer);
+        }, moved);
+        if (p == 1 && c == 1) {
+            runner.run(prefix + "spsc", [&] {
+                SpscQueue<std::uint64_t> queue(capacity);
+                ok &= run_transfer(queue, 1, 1, per_producer);
+            }, moved);
+        }
+    }
+
+    // Hand-off latency: every sample is one round trip (two hand-offs).
+    if (runner.enabled("latency/mutex_cv")) {
+        LockedQueue<std::uint64_t> ping(capacity), pong(capacity);
+        runner.record("latency/mutex_cv", run_ping_pong(ping, pong, round_trips), 1);
+    }
+    if (runner.enabled("latency/mpmc")) {
+        MpmcQueue<std::uint64_t> ping(capacity), pong(capacity);
+        runner.record("latency/mpmc", run_ping_pong(ping, pong, round_trips), 1);
+    }
+    if (runner.enabled("latency/spsc")) {
+        SpscQueue<std::uint64_t> ping(capacity), pong(capacity);
+        runner.record("latency/spsc", run_ping_pong(ping, pong, round_trips), 1);
+    }
+
+    if (!ok) std::cout << "ERROR: items were lost or duplicated!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Moves --items 64-bit integers from producer threads to consumer threads and
+reports items per second (construction of the queue included, it is cheap):
+
+-   p<P>c<C>/mutex_cv: a bounded `std::deque` with a `std::mutex` and two
+    `std::condition_variable`s (not full / not empty).
+-   p<P>c<C>/mpmc: `MpmcQueue<std::uint64_t>`.
+-   p1c1/spsc: `SpscQueue<std::uint64_t>` (only valid with one producer and one consumer).
+-   latency/...: round trips of one message between two threads over two queues; the
+    median and p95 come from the individual round trips (items/s is then round
+    trips per second). The lock-free queues hand over by spinning, the mutex queue
+    by sleeping and waking through the kernel.
+
+Consumers check that the sum of all popped values is right, so a lost or duplicated
+item is reported as ERROR. With more threads than cores the spinning queues yield
+and the results mostly measure the scheduler; run with --pin on a machine with
+enough cores for meaningful latencies.
+
+Options: --items=N (default 1000000), --capacity=N (default 1024),
+--producers=N, --consumers=N (one configuration instead of the matrix),
+--round-trips=N (default 20000), plus the common harness options (--samples,
+--warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_mpmc_queue`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_mpmc_queue.cpp -o bench_mpmc_queue -pthread
+./bench_mpmc_queue --producers=4 --consumers=4 --json=mpmc_queue.json
+*/
@@ -0,0 +1,174 @@
+// bench_object_pool.cpp
+// Create/destroy churn of a Widget (id, std::string name, std::vector<double> data,
+// as in cpp14/standard_library/std_make_unique.cpp): std::make_unique versus
+// ObjectPool<Widget>::make_unique from cpp14/standard_library/object_pool.hpp.
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp14/standard_library/object_pool.hpp"
+
+namespace {
+
+// std_make_unique.cpp's Widget without the printing.
+struct Widget {
+    int id;
+    std::string name;
+    std::vector<double> data;
+
+    Widget(int i, const char* n, std::size_t values) : id(i), name(n), data(values, 1.0) {}
+};
+
+// Small deterministic generator for the window workload.
+struct Lcg {
+    std::uint64_t state;
+    std::uint32_t next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<std::uint32_t>(state >> 33);
+    }
+};
+
+// The two ways of getting an owning pointer; both return a unique_ptr-like owner.
+struct StdMakeUnique {
+    typedef std::unique_ptr<Widget> Ptr;
+    explicit StdMakeUnique(ObjectPool<Widget>&) {}
+    Ptr make(int id, std::size_t values) { return std::make_unique<Widget>(id, "widget", values); }
+};
+
+struct PoolMakeUnique {
+    typedef ObjectPool<Widget>::UniquePtr Ptr;
+    explicit PoolMakeUnique(ObjectPool<Widget>& p) : pool(&p) {}
+    Ptr make(int id, std::size_t values) { return pool->make_unique<Widget>(id, "widget", values); }
+    ObjectPool<Widget>* pool;
+};
+
+// Create and immediately destroy: the allocator's best case (LIFO reuse).
+template<typename Maker>
+long long churn(Maker& maker, std::size_t ops, std::size_t values) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+        typename Maker::Ptr p = maker.make(static_cast<int>(i), values);
+        sum += p->id;
+    }
+    return sum;
+}
+
+// A window of `live` objects; each step replaces a random one, so frees and
+// allocations interleave out of order.
+template<typename Maker>
+long long window(Maker& maker, std::size_t ops, std::size_t live, std::size_t values) {
+    std::vector<typename Maker::Ptr> objects;
+    objects.reserve(live);
+    for (std::size_t i = 0; i < live; ++i) objects.push_back(maker.make(static_cast<int>(i), values));
+    Lcg rng{42};
+    long long sum = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+        typename Maker::Ptr& slot = objects[rng.next() % live];
+        sum += slot->id;
+        slot = maker.make(static_cast<int>(i), values);
+    }
+    return sum;
+}
+
+// Create `live` objects, then destroy them all (in creation order).
+template<typename Maker>
+long long batch(Maker& maker, std::size_t live, std::size_t values) {
+    std::vector<typename Maker::Ptr> objects;
+    objects.reserve(live);
+    for (std::size_t i = 0; i < live; ++i) objects.push_back(maker.make(static_cast<int>(i), values));
+    long long sum = 0;
+    for (const auto& p : objects) sum += p->id;
+    return sum;
+}
+
+template<typename Maker>
+void run_variant(bench::Runner& runner, const std::string& name, std::size_t ops, std::size_t live,
+                 std::size_t values, int threads, bool& ok) {
+    ObjectPool<Widget> pool;
+    Maker maker(pool);
+    const long long expected_churn = static_cast<long long>(ops) * (static_cast<long long>(ops) - 1) / 2;
+
+    runner.run("churn/" + name, [&] {
+        if (churn(maker, ops, values) != expected_churn) ok = false;
+    }, double(ops));
+
+    runner.run("window/" + name, [&] {
+        bench::do_not_optimize(window(maker, ops, live, values));
+    }, double(ops));
+
+    runner.run("batch/" + name, [&] {
+        if (batch(maker, live, values) != static_cast<long long>(live) * (static_cast<long long>(live) - 1) / 2) ok = false;
+    }, double(live));
+
+    // Every thread churns on its own (one shared pool; each thread has its own cache).
+    runner.run("churn_threads/" + name, [&] {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                Maker local(pool);
+                if (churn(local, ops, values) != expected_churn) ok = false;
+            });
+        }
+        for (std::thread& w : workers) w.join();
+    }, double(ops) * threads);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("object_pool", bench::parse_args(argc, argv));
+    const std::size_t ops = static_cast<std::size_t>(bench::int_option(runner.options(), "ops", 1000000));
+    const std::size_t live = static_cast<std::size_t>(std::max<long long>(1, bench::int_option(runner.options(), "live", 10000)));
+    const std::size_t values = static_cast<std::size_t>(bench::int_option(runner.options(), "values", 0));
+    const int threads = static_cast<int>(std::max<long long>(1, bench::int_option(runner.options(), "threads", 4)));
+    runner.add_context("ops", std::to_string(ops));
+    runner.add_context("live", std::to_string(live));
+    runner.add_context("values", std::to_string(values));
+    runner.add_context("threads", std::to_string(threads));
+    runner.add_context("sizeof_widget", std::to_string(sizeof(Widget)));
+
+    bool ok = true;
+    run_variant<StdMakeUnique>(runner, "std_make_unique", ops, live, values, threads, ok);
+    run_variant<PoolMakeUnique>(runner, "pool_make_unique", ops, live, values, threads, ok);
+
+    if (!ok) std::cout << "ERROR: a workload saw wrong widget ids!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Widgets per second created and destroyed with `std::make_unique<Widget>` (global
+operator new/delete) and with `ObjectPool<Widget>::make_unique` (slots reused
+through a thread-local free list, refilled from the pool in batches):
+-   churn/...: create one widget and destroy it right away, --ops times. The best case
+    for any allocator: the same block is reused every time.
+-   window/...: keep --live widgets; --ops times replace a random one. Frees and
+    allocations interleave in random order, as with a cache or a set of sessions.
+-   batch/...: create --live widgets, then destroy them all.
+-   churn_threads/...: --threads threads run churn/... at once on one shared pool.
+
+The Widget's name is short enough for std::string's small buffer and its vector is
+empty unless --values is set, so by default the Widget itself is the only allocation
+per iteration. With --values=N each widget also allocates N doubles through
+std::allocator, which both variants pay equally and which dilutes the difference.
+
+The glibc allocator already keeps small per-thread caches (tcache), so the gap is
+the fixed overhead of a general-purpose malloc/free against a push/pop on a free
+list, plus the Widget's own constructor, which both variants run: expect a modest
+gain per object rather than a multiple. window/... and batch/... check that the gain
+holds when blocks do not come back in LIFO order; the pool also keeps its slots
+densely packed in its chunks. Compare the min columns: on a busy machine the medians
+of these short loops are noisy.
+
+Options: --ops=N (default 1000000), --live=N (default 10000), --values=N (default 0),
+--threads=N (default 4), plus the common harness options (--samples, --warmup, --pin,
+--json, --filter).
+
+How to compile (CMake target `bench_object_pool`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_object_pool.cpp -o bench_object_pool -pthread
+./bench_object_pool --json=object_pool.json
+*/
@@ -0,0 +1,209 @@
+// bench_parallel_algorithms.cpp
+// Statistically sound version of the timings in cpp17/standard_library/parallel_algorithms.cpp:
+// sort, transform and reduce under std::execution::seq/par/par_unseq, the work-stealing
+// pool and (for sorting) the parallel radix sorts.
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp17/standard_library/numa_buffer.hpp"
+#include "cpp17/standard_library/radix_sort.hpp"
+#include "cpp17/standard_library/simd_kernels.hpp"
+#include "cpp17/standard_library/work_stealing_pool.hpp"
+
+// Same CPU-bound kernel as parallel_algorithms.cpp
+long long complex_calculation(int val) {
+    long long res = 0;
+    for (int i = 0; i < 500; ++i) {
+        res += static_cast<long long>(val) * val * i / (i + 1);
+        res %= 1000000007;
+    }
+    return res;
+}
+
+int main(int argc, char** argv) {
+    bench::Runner runner("parallel_algorithms", bench::parse_args(argc, argv));
+    const std::size_t data_size = static_cast<std::size_t>(bench::int_option(runner.options(), "size", 2000000));
+    const std::size_t transform_size = static_cast<std::size_t>(bench::int_option(runner.options(), "transform-size", 100000));
+    WorkStealingPool pool(static_cast<unsigned>(bench::int_option(runner.options(), "threads", 0)));
+    runner.add_context("data_size", std::to_string(data_size));
+    runner.add_context("transform_size", std::to_string(transform_size));
+    runner.add_context("pool_workers", std::to_string(pool.size()));
+    runner.add_context("simd_level", simd_level_name(simd_kernels().level));
+
+    std::vector<int> v_orig(data_size);
+    std::iota(v_orig.begin(), v_orig.end(), 1);
+    std::vector<int> reversed(v_orig.rbegin(), v_orig.rend());
+    std::vector<int> work(data_size);
+
+    // --- sort: reversed and random inputs, restored before every sample ---
+    std::vector<int> random_input(data_size);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    for (int& x : random_input) x = dist(rng);
+    std::vector<int> random_sorted = random_input;
+    std::sort(random_sorted.begin(), random_sorted.end());
+
+    struct SortInput { const char* name; const std::vector<int>* input; const std::vector<int>* expected; };
+    for (const SortInput& in : {SortInput{"reversed", &reversed, &v_orig}, SortInput{"random", &random_input, &random_sorted}}) {
+        const std::string prefix = std::string("sort/") + in.name + "/";
+        auto restore = [&] { std::copy(in.input->begin(), in.input->end(), work.begin()); };
+        auto verify = [&](const std::string& name) {
+            if (runner.enabled(name) && work != *in.expected) std::cout << "ERROR: " << name << " did not sort correctly!" << std::endl;
+        };
+        runner.run(prefix + "seq", restore, [&] { std::sort(std::execution::seq, work.begin(), work.end()); }, double(data_size));
+        runner.run(prefix + "par", restore, [&] { std::sort(std::execution::par, work.begin(), work.end()); }, double(data_size));
+        runner.run(prefix + "par_unseq", restore, [&] { std::sort(std::execution::par_unseq, work.begin(), work.end()); }, double(data_size));
+        runner.run(prefix + "pool", restore, [&] { parallel_sort(pool, work.begin(), work.end()); }, double(data_size));
+        verify(prefix + "pool");
+        runner.run(prefix + "radix_msd", restore, [&] { radix_sort_msd(pool, work.begin(), work.end()); }, double(data_size));
+        verify(prefix + "radix_msd");
+        runner.run(prefix + "radix_lsd", restore, [&] { radix_sort_lsd(pool, work.begin(), work.end()); }, double(data_size));
+        verify(prefix + "radix_lsd");
+    }
+
+    // --- key-value radix sort: 64-bit keys with a 32-bit payload ---
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> kv_input(data_size), kv_work;
+    std::mt19937_64 rng64(7);
+    for (std::size_t i = 0; i < data_size; ++i) kv_input[i] = {rng64(), static_cast<std::uint32_t>(i)};
+    auto by_key = [](const auto& p) { return p.first; };
+    auto kv_restore = [&] { kv_work = kv_input; };
+    runner.run("sort_kv/random/seq", kv_restore, [&] {
+        std::sort(std::execution::seq, kv_work.begin(), kv_work.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    }, double(data_size));
+    runner.run("sort_kv/random/par", kv_restore, [&] {
+        std::sort(std::execution::par, kv_work.begin(), kv_work.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    }, double(data_size));
+    runner.run("sort_kv/random/radix_lsd", kv_restore, [&] { radix_sort_lsd(pool, kv_work.begin(), kv_work.end(), by_key); }, double(data_size));
+    runner.run("sort_kv/random/radix_msd", kv_restore, [&] { radix_sort_msd(pool, kv_work.begin(), kv_work.end(), by_key); }, double(data_size));
+
+    // --- transform (CPU bound) ---
+    std::vector<long long> out(transform_size);
+    auto t_first = v_orig.begin();
+    auto t_last = v_orig.begin() + static_cast<std::ptrdiff_t>(std::min(transform_size, data_size));
+    runner.run("transform/seq", [&] { std::transform(std::execution::seq, t_first, t_last, out.begin(), complex_calculation); }, double(transform_size));
+    runner.run("transform/par", [&] { std::transform(std::execution::par, t_first, t_last, out.begin(), complex_calculation); }, double(transform_size));
+    runner.run("transform/par_unseq", [&] { std::transform(std::execution::par_unseq, t_first, t_last, out.begin(), complex_calculation); }, double(transform_size));
+    runner.run("transform/pool", [&] { parallel_transform(pool, t_first, t_last, out.begin(), complex_calculation); }, double(transform_size));
+    for (SimdLevel level : supported_simd_levels()) {
+        const SimdKernels k = simd_kernels_for(level);
+        runner.run(std::string("transform/simd_") + simd_level_name(level),
+                   [&] { k.complex_calculation_map(&*t_first, out.data(), static_cast<std::size_t>(t_last - t_first)); }, double(transform_size));
+    }
+    // Both together: the pool splits the range, every chunk runs the best SIMD kernel.
+    runner.run(std::string("transform/pool+simd_") + simd_level_name(simd_kernels().level), [&] {
+        const int* in = &*t_first;
+        parallel_for(pool, static_cast<std::size_t>(t_last - t_first), 0, [&](std::size_t begin, std::size_t end) {
+            simd_kernels().complex_calculation_map(in + begin, out.data() + begin, end - begin);
+        });
+    }, double(transform_size));
+    bench::do_not_optimize(out.data());
+
+    // --- reduce (memory bound) ---
+    long long sum = 0;
+    runner.run("reduce/seq", [&] { sum = std::reduce(std::execution::seq, v_orig.begin(), v_orig.end(), 0LL); bench::do_not_optimize(sum); }, double(data_size));
+    runner.run("reduce/par", [&] { sum = std::reduce(std::execution::par, v_orig.begin(), v_orig.end(), 0LL); bench::do_not_optimize(sum); }, double(data_size));
+    runner.run("reduce/par_unseq", [&] { sum = std::reduce(std::execution::par_unseq, v_orig.begin(), v_orig.end(), 0LL); bench::do_not_optimize(sum); }, double(data_size));
+    runner.run("reduce/pool", [&] { sum = parallel_reduce(pool, v_orig.begin(), v_orig.end(), 0LL); bench::do_not_optimize(sum); }, double(data_size));
+    for (SimdLevel level : supported_simd_levels()) {
+        const SimdKernels k = simd_kernels_for(level);
+        runner.run(std::string("reduce/simd_") + simd_level_name(level),
+                   [&] { sum = k.sum_i32(v_orig.data(), v_orig.size()); bench::do_not_optimize(sum); }, double(data_size));
+    }
+
+    // --- min/max (memory bound, no widening) ---
+    std::pair<int, int> mm{};
+    auto minmax_with = [&](const auto& policy) {
+        auto [lo, hi] = std::minmax_element(policy, random_input.begin(), random_input.end());
+        mm = {*lo, *hi};
+        bench::do_not_optimize(mm);
+    };
+    runner.run("minmax/seq", [&] { minmax_with(std::execution::seq); }, double(data_size));
+    runner.run("minmax/par", [&] { minmax_with(std::execution::par); }, double(data_size));
+    runner.run("minmax/par_unseq", [&] { minmax_with(std::execution::par_unseq); }, double(data_size));
+    for (SimdLevel level : supported_simd_levels()) {
+        const SimdKernels k = simd_kernels_for(level);
+        runner.run(std::string("minmax/simd_") + simd_level_name(level),
+                   [&] { mm = k.minmax_i32(random_input.data(), random_input.size()); bench::do_not_optimize(mm); }, double(data_size));
+    }
+
+    // --- NUMA placement mode (--numa): the same reduce/sort on differently placed inputs ---
+    if (bench::flag_option(runner.options(), "numa")) {
+        runner.add_context("numa", numa_support_summary());
+        struct Placement { const char* name; NumaPolicy policy; bool parallel_init; };
+        const Placement placements[] = {
+            {"serial_init", NumaPolicy::first_touch, false},  // What std::iota on one thread does
+            {"first_touch", NumaPolicy::first_touch, true},
+            {"interleave", NumaPolicy::interleave, true},
+        };
+        for (const Placement& placement : placements) {
+            if (placement.policy == NumaPolicy::interleave && numa_node_count() < 2) continue;
+            const std::string prefix = std::string("numa/") + placement.name + "/";
+            auto value_at = [&](std::size_t i) { return random_input[i]; };
+            numa_vector<int> data(data_size, NumaAllocator<int>(placement.policy));
+            numa_vector<int> scratch(data_size, NumaAllocator<int>(placement.policy));
+            if (placement.parallel_init) {
+                parallel_first_touch(pool, data.data(), data_size, value_at);
+                parallel_first_touch(pool, scratch.data(), data_size, value_at);
+            } else {
+                for (std::size_t i = 0; i < data_size; ++i) data[i] = scratch[i] = value_at(i);
+            }
+            runner.run(prefix + "reduce_par", [&] { sum = std::reduce(std::execution::par, data.begin(), data.end(), 0LL); bench::do_not_optimize(sum); }, double(data_size));
+            runner.run(prefix + "reduce_pool", [&] { sum = parallel_reduce(pool, data.begin(), data.end(), 0LL); bench::do_not_optimize(sum); }, double(data_size));
+            // Restoring the input rewrites existing pages, which does not move them.
+            auto restore = [&] { std::copy(data.begin(), data.end(), scratch.begin()); };
+            runner.run(prefix + "sort_par", restore, [&] { std::sort(std::execution::par, scratch.begin(), scratch.end()); }, double(data_size));
+            runner.run(prefix + "sort_pool", restore, [&] { parallel_sort(pool, scratch.begin(), scratch.end()); }, double(data_size));
+            if (runner.enabled(prefix + "sort_pool") && !std::equal(scratch.begin(), scratch.end(), random_sorted.begin()))
+                std::cout << "ERROR: " << prefix << "sort_pool did not sort correctly!" << std::endl;
+            std::vector<std::size_t> pages = numa_page_histogram(data.data(), data_size * sizeof(int));
+            std::string histogram;
+            for (std::size_t node = 0; node < pages.size(); ++node) histogram += (node ? "," : "") + std::to_string(pages[node]);
+            if (!histogram.empty()) runner.add_context(prefix + "pages_per_node", histogram);
+        }
+    }
+
+    return runner.finish();
+}
+
+/*
+Explanation:
+`parallel_algorithms.cpp` times every algorithm once, so its numbers include cold
+caches and first-touch page faults and vary from run to run. This benchmark runs
+the same workloads through `bench::Runner` (see `benchmark.hpp`): every variant is
+warmed up, sampled repeatedly, and reported as median/min/p95 plus throughput.
+
+-   sort: 2M ints, once in reversed order and once uniformly random; the input is
+    restored (untimed) before each sample. Besides the three policies and the pool's
+    `parallel_sort`, the parallel MSD and LSD radix sorts from `radix_sort.hpp` run on
+    the same inputs.
+-   sort_kv: 2M (uint64 key, uint32 payload) pairs sorted by key, comparison sort vs radix.
+-   transform: `complex_calculation` over the first 100k elements (CPU bound).
+-   reduce: sum of 2M ints (memory-bandwidth bound).
+-   minmax: `std::minmax_element` over 2M random ints.
+-   simd_*: the explicit kernels from `simd_kernels.hpp`, once per instruction set level
+    the CPU supports (scalar, sse4.1, avx2, avx512), single-threaded, plus the pool
+    running the best kernel per chunk. Set SIMD_MAX_LEVEL=avx2 to cap the detected level.
+
+-   --numa: reduce and sort (`par` and the pool) on 2M random ints whose pages were
+    placed three ways: written by one thread (like `std::iota` in the example),
+    first-touched in parallel by the pool, and interleaved over all nodes with
+    libnuma (skipped on single-node machines). See `numa_buffer.hpp`. The pages per
+    node of each buffer are recorded in the JSON context when libnuma is available.
+
+Options: --size=N, --transform-size=N, --threads=N (pool workers, 0 = all cores), --numa,
+plus the common harness options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_parallel_algorithms`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_parallel_algorithms.cpp -o bench_parallel_algorithms -pthread -ltbb
+(drop `-ltbb` if the TBB headers are not installed; add `-DHAVE_LIBNUMA -lnuma` for interleaving)
+./bench_parallel_algorithms --samples=21 --json=parallel_algorithms.json
+*/
@@ -0,0 +1,150 @@
+// bench_parallel_sum.cpp
+// Scaling of the chunked parallel sum from cpp11/standard_library/parallel_sum.hpp
+// over 1..N threads, with a report that shows where memory bandwidth saturates,
+// plus the cost of partial sums that share cache lines (false sharing).
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/standard_library/parallel_sum.hpp"
+
+namespace {
+
+// The false-sharing variant: every thread adds directly into its element of a
+// packed array. volatile forces one store per element, as a naive
+// `results[t] += v[i]` does when the compiler cannot keep it in a register.
+void packed_sum(const std::vector<int>& v, unsigned threads, std::vector<long long>& partials) {
+    const std::size_t chunk = (v.size() + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            volatile long long* slot = &partials[t];
+            const std::size_t b = std::min(v.size(), t * chunk), e = std::min(v.size(), b + chunk);
+            for (std::size_t i = b; i < e; ++i) *slot = *slot + v[i];
+        });
+    }
+    for (std::thread& w : workers) w.join();
+}
+
+// Same loop with every slot on its own 128-byte line.
+void padded_inplace_sum(const std::vector<int>& v, unsigned threads,
+                        std::vector<parallel_sum_detail::PaddedSlot<long long>>& partials) {
+    const std::size_t chunk = (v.size() + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            volatile long long* slot = &partials[t].value;
+            const std::size_t b = std::min(v.size(), t * chunk), e = std::min(v.size(), b + chunk);
+            for (std::size_t i = b; i < e; ++i) *slot = *slot + v[i];
+        });
+    }
+    for (std::thread& w : workers) w.join();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("parallel_sum", bench::parse_args(argc, argv));
+    const std::size_t size = static_cast<std::size_t>(bench::int_option(runner.options(), "size", 1 << 25));
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned max_threads = static_cast<unsigned>(bench::int_option(runner.options(), "max-threads", hw));
+    runner.add_context("size", std::to_string(size));
+    runner.add_context("bytes", std::to_string(size * sizeof(int)));
+
+    std::vector<int> data(size);
+    std::iota(data.begin(), data.end(), 0);
+    const long long expected = std::accumulate(data.begin(), data.end(), 0LL);
+    bool ok = true;
+    auto check = [&](long long got) { if (got != expected) ok = false; };
+    const double bytes = double(size * sizeof(int));
+
+    runner.run("serial/accumulate", [&] { check(std::accumulate(data.begin(), data.end(), 0LL)); }, double(size));
+
+    // Scaling: 1, 2, 4, ... max_threads (and max_threads itself).
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    struct Point { unsigned threads; double gb_per_s; };
+    std::vector<Point> scaling;
+    for (unsigned t : counts) {
+        const SumPlan plan{t, (size + t - 1) / t};
+        const bench::Result* r = runner.run("threads/" + std::to_string(t),
+            [&] { check(parallel_sum<long long>(data.data(), data.data() + size, plan)); }, double(size));
+        if (r) scaling.push_back(Point{t, bytes / (r->median_ms / 1000.0) / 1e9});
+    }
+    const SumPlan automatic = plan_sum(size);
+    runner.add_context("auto_threads", std::to_string(automatic.threads));
+    runner.run("auto", [&] { check(parallel_sum(data)); }, double(size));
+
+    // False sharing: the same in-place accumulation with packed and padded slots.
+    const std::string fs_threads = std::to_string(max_threads);
+    std::vector<long long> packed(max_threads);
+    runner.run("false_sharing/packed/" + fs_threads, [&] { std::fill(packed.begin(), packed.end(), 0); },
+        [&] {
+            packed_sum(data, max_threads, packed);
+            check(std::accumulate(packed.begin(), packed.end(), 0LL));
+        }, double(size));
+    std::vector<parallel_sum_detail::PaddedSlot<long long>> padded(max_threads);
+    runner.run("false_sharing/padded/" + fs_threads, [&] { for (auto& s : padded) s.value = 0; },
+        [&] {
+            padded_inplace_sum(data, max_threads, padded);
+            long long total = 0;
+            for (auto& s : padded) total += s.value;
+            check(total);
+        }, double(size));
+
+    if (!scaling.empty()) {
+        std::cout << "\nScaling report (" << size * sizeof(int) / (1 << 20) << " MiB):\n";
+        std::cout << "threads      GB/s   speedup  gain vs previous\n";
+        unsigned saturated_at = 0;
+        for (std::size_t i = 0; i < scaling.size(); ++i) {
+            const double speedup = scaling[i].gb_per_s / scaling[0].gb_per_s;
+            const double gain = i == 0 ? 0.0 : scaling[i].gb_per_s / scaling[i - 1].gb_per_s - 1.0;
+            std::printf("%7u  %8.2f  %8.2fx  %s\n", scaling[i].threads, scaling[i].gb_per_s, speedup,
+                        i == 0 ? "-" : (std::to_string(static_cast<int>(gain * 100)) + "%").c_str());
+            if (i > 0 && saturated_at == 0 && gain < 0.10) saturated_at = scaling[i - 1].threads;
+        }
+        if (saturated_at != 0) {
+            std::cout << "Bandwidth saturates at about " << saturated_at << " thread(s) (next step gains < 10%).\n";
+        } else {
+            std::cout << "No saturation up to " << scaling.back().threads << " thread(s).\n";
+        }
+    }
+
+    if (!ok) std::cout << "ERROR: a parallel sum differs from std::accumulate!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+`sum_vector` in `std_thread.cpp` sums on one thread. `parallel_sum()` splits the
+vector into one contiguous chunk per thread. A sum is memory bound, so the speedup
+stops when the threads together use the whole memory bandwidth; this benchmark
+finds that point.
+
+-   serial/accumulate: `std::accumulate` on the calling thread.
+-   threads/<T>: `parallel_sum` with exactly T threads (1, 2, 4, ..., --max-threads),
+    followed by a report of GB/s per thread count and where the next doubling
+    gains less than 10% (bandwidth saturated).
+-   auto: `parallel_sum(v)` with the plan `plan_sum()` picks (in the JSON context).
+-   false_sharing/packed/<T>, false_sharing/padded/<T>: every thread adds each
+    element directly into its partial sum in memory; packed keeps the partial sums
+    adjacent (one cache line bounces between the cores), padded puts each on its
+    own 128-byte slot. Needs at least 2 cores to show a difference.
+
+Use a --size well above the last-level cache (the default is 32M ints, 128 MiB),
+otherwise the report measures cache bandwidth instead of memory bandwidth.
+
+Options: --size=N (elements, default 33554432), --max-threads=N (default: hardware
+threads), plus the common harness options (--samples, --warmup, --pin, --json,
+--filter).
+
+How to compile (CMake target `bench_parallel_sum`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_parallel_sum.cpp -o bench_parallel_sum -pthread
+./bench_parallel_sum --max-threads=16 --json=parallel_sum.json
+*/
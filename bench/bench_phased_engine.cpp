@@ -0,0 +1,155 @@
+// bench_phased_engine.cpp
+// An iterative 1D stencil run three ways: serially, with new threads plus a
+// std::latch for every iteration (the pattern of cpp20/standard_library/std_latch.cpp),
+// and with the persistent std::barrier workers of phased_engine.hpp.
+#include <algorithm>
+#include <iostream>
+#include <latch>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp20/standard_library/phased_engine.hpp"
+
+namespace {
+
+// One explicit heat-diffusion step on [begin, end); the two end cells stay fixed.
+void heat_step(std::span<const double> cur, std::span<double> next, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (i == 0 || i + 1 == cur.size()) {
+            next[i] = cur[i];
+        } else {
+            next[i] = cur[i] + 0.25 * (cur[i - 1] - 2.0 * cur[i] + cur[i + 1]);
+        }
+    }
+}
+
+std::vector<double> initial_rod(std::size_t cells) {
+    std::vector<double> rod(cells, 0.0);
+    rod[0] = 100.0;
+    return rod;
+}
+
+std::vector<double> run_serial(std::size_t cells, std::size_t iterations) {
+    std::vector<double> cur = initial_rod(cells), next = cur;
+    for (std::size_t it = 0; it < iterations; ++it) {
+        heat_step(cur, next, 0, cells);
+        std::swap(cur, next);
+    }
+    return cur;
+}
+
+// Every iteration: spawn `threads` threads, each computes its slice and counts down
+// a fresh latch; the main thread waits, joins, and swaps the buffers.
+std::vector<double> run_spawn_latch(std::size_t cells, std::size_t iterations, unsigned threads) {
+    std::vector<double> cur = initial_rod(cells), next = cur;
+    const std::size_t chunk = (cells + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (std::size_t it = 0; it < iterations; ++it) {
+        std::latch done(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                const std::size_t b = std::min(cells, t * chunk), e = std::min(cells, b + chunk);
+                heat_step(cur, next, b, e);
+                done.count_down();
+            });
+        }
+        done.wait();
+        for (std::thread& w : workers) w.join();
+        workers.clear();
+        std::swap(cur, next);
+    }
+    return cur;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("phased_engine", bench::parse_args(argc, argv));
+    const std::size_t cells = static_cast<std::size_t>(bench::int_option(runner.options(), "cells", 1 << 16));
+    const std::size_t iterations = static_cast<std::size_t>(bench::int_option(runner.options(), "iterations", 500));
+    const unsigned threads = static_cast<unsigned>(
+        bench::int_option(runner.options(), "threads", std::max(1u, std::thread::hardware_concurrency())));
+    runner.add_context("cells", std::to_string(cells));
+    runner.add_context("iterations", std::to_string(iterations));
+    runner.add_context("threads", std::to_string(threads));
+
+    const std::vector<double> expected = run_serial(cells, iterations);
+    bool ok = true;
+    auto check = [&](std::span<const double> got) {
+        if (!std::equal(got.begin(), got.end(), expected.begin(), expected.end())) ok = false;
+    };
+    const double updates = double(cells) * double(iterations);
+
+    runner.run("serial", [&] { check(run_serial(cells, iterations)); }, updates);
+    runner.run("spawn_latch", [&] { check(run_spawn_latch(cells, iterations, threads)); }, updates);
+
+    // Persistent workers: created once here, reused by every sample.
+    {
+        PhasedEngine<double> engine(initial_rod(cells), threads);
+        runner.run("barrier_engine",
+            [&] {
+                // Reset the state with one phase that copies the initial rod.
+                const std::vector<double> rod = initial_rod(cells);
+                engine.run(1, [&rod](std::span<const double>, std::span<double> next, std::size_t b, std::size_t e) {
+                    std::copy(rod.begin() + static_cast<std::ptrdiff_t>(b), rod.begin() + static_cast<std::ptrdiff_t>(e),
+                              next.begin() + static_cast<std::ptrdiff_t>(b));
+                });
+            },
+            [&] {
+                engine.run(iterations, heat_step);
+                check(engine.state());
+            }, updates);
+    }
+
+    // Including the creation and shutdown of the engine's threads.
+    runner.run("barrier_engine_with_startup", [&] {
+        PhasedEngine<double> engine(initial_rod(cells), threads);
+        engine.run(iterations, heat_step);
+        check(engine.state());
+    }, updates);
+
+    // Small grids show the synchronization cost per phase most clearly.
+    const std::size_t small = std::max<std::size_t>(threads * 64, 1024);
+    const std::vector<double> expected_small = run_serial(small, iterations);
+    runner.run("small/spawn_latch", [&] {
+        if (run_spawn_latch(small, iterations, threads) != expected_small) ok = false;
+    }, double(small) * double(iterations));
+    runner.run("small/barrier_engine", [&] {
+        PhasedEngine<double> engine(initial_rod(small), threads);
+        engine.run(iterations, heat_step);
+        if (!std::equal(engine.state().begin(), engine.state().end(), expected_small.begin(), expected_small.end())) ok = false;
+    }, double(small) * double(iterations));
+
+    if (!ok) std::cout << "ERROR: a parallel run differs from the serial result!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+A 1D heat-diffusion stencil (--cells cells, --iterations steps) needs every thread to
+finish step k before any thread starts step k+1. Reports cell updates per second:
+
+-   serial: one thread, two buffers.
+-   spawn_latch: for every step, --threads new `std::thread`s compute one slice each
+    and count down a new `std::latch`; the main thread waits, joins and swaps.
+-   barrier_engine: `PhasedEngine<double>` with --threads participants, created once;
+    every step ends at a `std::barrier` whose completion function swaps the buffers.
+-   barrier_engine_with_startup: the same, including creating and joining the threads.
+-   small/...: the two parallel versions on a small grid (64 cells per thread, at least
+    1024), where the per-step synchronization cost dominates.
+
+All parallel results are compared bit for bit with the serial one (each cell is
+computed by the same expression in every version); differences print an ERROR.
+
+Options: --cells=N (default 65536), --iterations=N (default 500), --threads=N (default:
+hardware threads), plus the common harness options (--samples, --warmup, --pin,
+--json, --filter).
+
+How to compile (CMake target `bench_phased_engine`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_phased_engine.cpp -o bench_phased_engine -pthread
+./bench_phased_engine --threads=8 --iterations=2000 --json=phased_engine.json
+*/
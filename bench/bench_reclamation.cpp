@@ -0,0 +1,247 @@
+// bench_reclamation.cpp
+// Lock-free stack and queue from cpp14/standard_library/lock_free_structures.hpp with
+// hazard pointers and with epoch-based reclamation, against the same structures
+// built on C++20 std::atomic<std::shared_ptr<Node>>, which reclaims nodes through
+// reference counting.
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp14/standard_library/lock_free_structures.hpp"
+
+namespace {
+
+// Treiber stack on std::atomic<std::shared_ptr>: a popped node lives on while any
+// thread still holds a shared_ptr to it.
+template<typename T>
+class SharedPtrStack {
+public:
+    ~SharedPtrStack() {
+        T ignored;
+        while (try_pop(ignored)) {} // Iteratively: a long chain of next pointers would recurse
+    }
+
+    void push(T value) {
+        auto node = std::make_shared<Node>(Node{std::move(value), nullptr});
+        node->next = head_.load();
+        while (!head_.compare_exchange_weak(node->next, node)) {}
+    }
+
+    bool try_pop(T& out) {
+        std::shared_ptr<Node> top = head_.load();
+        while (top && !head_.compare_exchange_weak(top, top->next)) {}
+        if (!top) return false;
+        out = std::move(top->value);
+        return true;
+    }
+
+private:
+    struct Node {
+        T value;
+        std::shared_ptr<Node> next;
+    };
+    std::atomic<std::shared_ptr<Node>> head_;
+};
+
+// Michael-Scott queue on std::atomic<std::shared_ptr>.
+template<typename T>
+class SharedPtrQueue {
+public:
+    SharedPtrQueue() {
+        auto dummy = std::make_shared<Node>();
+        head_.store(dummy);
+        tail_.store(dummy);
+    }
+
+    ~SharedPtrQueue() {
+        T ignored;
+        while (try_pop(ignored)) {}
+    }
+
+    void push(T value) {
+        auto node = std::make_shared<Node>();
+        node->value.emplace(std::move(value));
+        for (;;) {
+            std::shared_ptr<Node> tail = tail_.load();
+            std::shared_ptr<Node> next = tail->next.load();
+            if (tail != tail_.load()) continue;
+            if (!next) {
+                if (tail->next.compare_exchange_weak(next, node)) {
+                    tail_.compare_exchange_strong(tail, node);
+                    return;
+                }
+            } else {
+                tail_.compare_exchange_strong(tail, next);
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        for (;;) {
+            std::shared_ptr<Node> head = head_.load();
+            std::shared_ptr<Node> tail = tail_.load();
+            std::shared_ptr<Node> next = head->next.load();
+            if (head != head_.load()) continue;
+            if (!next) return false;
+            if (head == tail) {
+                tail_.compare_exchange_strong(tail, next);
+                continue;
+            }
+            if (head_.compare_exchange_weak(head, next)) {
+                out = std::move(*next->value); // next is the new dummy
+                next->value.reset();
+                return true;
+            }
+        }
+    }
+
+private:
+    struct Node {
+        std::optional<T> value;
+        std::atomic<std::shared_ptr<Node>> next;
+    };
+    std::atomic<std::shared_ptr<Node>> head_;
+    std::atomic<std::shared_ptr<Node>> tail_;
+};
+
+template<typename F>
+void run_threads(int threads, F body) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(t);
+        });
+    }
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+}
+
+// Every thread alternates push and pop, so the structure stays small and the head
+// (and tail) are as contended as they get.
+template<typename Structure>
+void run_pairs(bench::Runner& runner, const std::string& name, int threads, long long ops, bool& ok) {
+    if (!runner.enabled(name)) return;
+    runner.run(name, [&] {
+        Structure s;
+        std::atomic<long long> popped{0};
+        run_threads(threads, [&](int) {
+            long long sum = 0;
+            for (long long i = 0; i < ops; ++i) {
+                s.push(i);
+                long long v;
+                if (s.try_pop(v)) sum += v;
+            }
+            popped.fetch_add(sum);
+        });
+        long long v;
+        long long rest = 0;
+        while (s.try_pop(v)) rest += v;
+        if (popped.load() + rest != threads * (ops * (ops - 1) / 2)) ok = false;
+    }, double(ops) * threads * 2);
+}
+
+// Half the threads push, the other half pop until everything arrived.
+template<typename Queue>
+void run_producer_consumer(bench::Runner& runner, const std::string& name, int threads, long long ops, bool& ok) {
+    if (!runner.enabled(name)) return;
+    const int producers = std::max(1, threads / 2);
+    const int consumers = std::max(1, threads - producers);
+    runner.run(name, [&] {
+        Queue q;
+        std::atomic<long long> received{0}, sum{0};
+        const long long total = ops * producers;
+        run_threads(producers + consumers, [&](int t) {
+            if (t < producers) {
+                for (long long i = 0; i < ops; ++i) q.push(i);
+                return;
+            }
+            long long local = 0, count = 0, v;
+            while (received.load(std::memory_order_relaxed) < total) {
+                if (q.try_pop(v)) {
+                    local += v;
+                    ++count;
+                    received.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            sum.fetch_add(local);
+        });
+        if (sum.load() != producers * (ops * (ops - 1) / 2)) ok = false;
+    }, double(ops) * producers);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("reclamation", bench::parse_args(argc, argv));
+    const long long ops = bench::int_option(runner.options(), "ops", 200000);
+    const int max_threads = static_cast<int>(std::max(1LL, bench::int_option(runner.options(), "threads", 4)));
+    runner.add_context("ops_per_thread", std::to_string(ops));
+    runner.add_context("atomic_shared_ptr_lock_free",
+                       std::atomic<std::shared_ptr<int>>::is_always_lock_free ? "true" : "false");
+
+    bool ok = true;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        const std::string suffix = "/threads=" + std::to_string(threads);
+        run_pairs<LockFreeStack<long long, HazardReclamation>>(runner, "stack/hazard" + suffix, threads, ops, ok);
+        run_pairs<LockFreeStack<long long, EpochReclamation>>(runner, "stack/epoch" + suffix, threads, ops, ok);
+        run_pairs<SharedPtrStack<long long>>(runner, "stack/atomic_shared_ptr" + suffix, threads, ops, ok);
+        run_pairs<LockFreeQueue<long long, HazardReclamation>>(runner, "queue/hazard" + suffix, threads, ops, ok);
+        run_pairs<LockFreeQueue<long long, EpochReclamation>>(runner, "queue/epoch" + suffix, threads, ops, ok);
+        run_pairs<SharedPtrQueue<long long>>(runner, "queue/atomic_shared_ptr" + suffix, threads, ops, ok);
+    }
+    for (int threads = 2; threads <= std::max(2, max_threads); threads *= 2) {
+        const std::string suffix = "/threads=" + std::to_string(threads);
+        run_producer_consumer<LockFreeQueue<long long, HazardReclamation>>(runner, "spsc_mpmc/hazard" + suffix, threads, ops, ok);
+        run_producer_consumer<LockFreeQueue<long long, EpochReclamation>>(runner, "spsc_mpmc/epoch" + suffix, threads, ops, ok);
+        run_producer_consumer<SharedPtrQueue<long long>>(runner, "spsc_mpmc/atomic_shared_ptr" + suffix, threads, ops, ok);
+    }
+
+    runner.add_context("hazard_pending_after_runs", std::to_string(HazardDomain::global().pending()));
+    runner.add_context("epoch_pending_after_runs", std::to_string(EpochDomain::global().pending()));
+    if (!ok) std::cout << "ERROR: a structure lost or duplicated values!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Operations (pushes + pops) per second for a Treiber stack and a Michael-Scott queue
+with three ways of reclaiming popped nodes:
+-   hazard: `HazardReclamation` (hazard_pointers.hpp): per-node announcements, freed
+    in batches by scans.
+-   epoch: `EpochReclamation` (EpochDomain from rcu.hpp): one pin per operation.
+-   atomic_shared_ptr: the same algorithms on `std::atomic<std::shared_ptr<Node>>`
+    (C++20). libstdc++ implements it with a lock bit in the pointer
+    (`is_always_lock_free` is stored in the JSON context), and each load also updates
+    the node's reference count.
+
+Workloads, with 1, 2, 4, ... --threads threads:
+-   stack/... and queue/...: every thread alternates push and pop --ops times; the sums
+    of pushed and popped values must match.
+-   spsc_mpmc/...: half the threads push --ops values each, the other half pop until
+    all have arrived (one producer and one consumer with 2 threads, hence the name).
+    Items are the pushed values.
+
+Reading the numbers: the epoch variant pays EpochDomain::retire(), which takes a
+mutex and stores a std::function per node, so it trails hazard pointers on
+pop-heavy work even though its read side is cheaper. On a machine with fewer cores
+than threads, preemption inside the lock of `std::atomic<std::shared_ptr>` stalls
+every other thread, while a preempted lock-free operation blocks no one.
+
+Options: --ops=N per thread (default 200000), --threads=N maximum (default 4), plus
+the common harness options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_reclamation`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_reclamation.cpp -o bench_reclamation -pthread
+./bench_reclamation --json=reclamation.json
+*/
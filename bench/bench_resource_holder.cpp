@@ -0,0 +1,191 @@
+// bench_resource_holder.cpp
+// The ResourceHolder of cpp11/core_language/rvalue_references_move_semantics.cpp
+// (without its printing) versus FastResourceHolder from
+// cpp11/core_language/resource_holder.hpp, with std::allocator and with an arena:
+// vector growth, sorting, copying and moving whole vectors of holders.
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/core_language/resource_holder.hpp"
+
+namespace {
+
+// The original class minus the name and the std::cout output: new int[size] on
+// every construction and deep copy, pointer stealing on move.
+class QuietResourceHolder {
+public:
+    explicit QuietResourceHolder(std::size_t s) : data_(new int[s]), size_(s) {
+        for (std::size_t i = 0; i < size_; ++i) data_[i] = static_cast<int>(i);
+    }
+    ~QuietResourceHolder() { delete[] data_; }
+    QuietResourceHolder(const QuietResourceHolder& other) : data_(new int[other.size_]), size_(other.size_) {
+        std::copy(other.data_, other.data_ + size_, data_);
+    }
+    QuietResourceHolder& operator=(const QuietResourceHolder& other) {
+        if (this == &other) return *this;
+        delete[] data_;
+        size_ = other.size_;
+        data_ = new int[size_];
+        std::copy(other.data_, other.data_ + size_, data_);
+        return *this;
+    }
+    QuietResourceHolder(QuietResourceHolder&& other) noexcept : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    QuietResourceHolder& operator=(QuietResourceHolder&& other) noexcept {
+        if (this == &other) return *this;
+        delete[] data_;
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        return *this;
+    }
+    int& operator[](std::size_t i) { return data_[i]; }
+    const int& operator[](std::size_t i) const { return data_[i]; }
+    std::size_t size() const { return size_; }
+
+private:
+    int* data_;
+    std::size_t size_;
+};
+
+// How each variant creates holders; reset() runs when none of its holders is alive.
+struct Legacy {
+    typedef QuietResourceHolder Holder;
+    Holder make(std::size_t size) { return Holder(size); }
+    void reset() {}
+};
+
+struct Fast {
+    typedef FastResourceHolder<int> Holder;
+    Holder make(std::size_t size) { return Holder(size); }
+    void reset() {}
+};
+
+struct FastArena {
+    typedef FastResourceHolder<int, 16, ArenaAllocator<int>> Holder;
+    BumpArena arena{1 << 20};
+    Holder make(std::size_t size) { return Holder(size, ArenaAllocator<int>(arena)); }
+    void reset() { arena.reset(); }
+};
+
+int key(std::size_t i) {
+    return static_cast<int>((static_cast<std::uint32_t>(i) * 2654435761u) >> 1); // Scrambled order
+}
+
+template<typename Variant>
+void run_variant(bench::Runner& runner, const std::string& prefix, std::size_t n, std::size_t size, bool& ok) {
+    typedef typename Variant::Holder Holder;
+    Variant variant;
+    std::vector<Holder> source, target;
+    auto release_all = [&] {
+        std::vector<Holder>().swap(target); // Also gives back the vectors' capacity
+        std::vector<Holder>().swap(source);
+        variant.reset();
+    };
+    auto rebuild = [&] {
+        release_all();
+        source.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            source.push_back(variant.make(size));
+            source.back()[0] = key(i);
+        }
+    };
+    const double items = double(n);
+
+    // push_back without reserve: every reallocation moves all holders.
+    runner.run(prefix + "/growth", release_all, [&] {
+        for (std::size_t i = 0; i < n; ++i) target.push_back(variant.make(size));
+        if (target.back()[size - 1] != static_cast<int>(size - 1)) ok = false;
+    }, items);
+
+    // std::sort by the first element: moves and move assignments only.
+    runner.run(prefix + "/sort", rebuild, [&] {
+        std::sort(source.begin(), source.end(), [](const Holder& a, const Holder& b) { return a[0] < b[0]; });
+        for (std::size_t i = 1; i < n; ++i) {
+            if (source[i - 1][0] > source[i][0]) ok = false;
+        }
+    }, items);
+
+    // Deep copy of the whole vector.
+    runner.run(prefix + "/copy", rebuild, [&] {
+        target = source;
+        if (target.size() != n || target[n - 1][size - 1] != static_cast<int>(size - 1)) ok = false;
+    }, items);
+
+    // Moving every holder into another vector.
+    runner.run(prefix + "/move", rebuild, [&] {
+        target.reserve(n);
+        for (Holder& h : source) target.push_back(std::move(h));
+        if (target[n - 1][0] != key(n - 1)) ok = false;
+    }, items);
+
+    release_all();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("resource_holder", bench::parse_args(argc, argv));
+    const std::size_t n = static_cast<std::size_t>(bench::int_option(runner.options(), "count", 100000));
+    const std::size_t small = static_cast<std::size_t>(bench::int_option(runner.options(), "small", 8));
+    const std::size_t large = static_cast<std::size_t>(bench::int_option(runner.options(), "large", 64));
+    runner.add_context("count", std::to_string(n));
+    runner.add_context("small_size", std::to_string(small));
+    runner.add_context("large_size", std::to_string(large));
+    runner.add_context("sizeof_legacy", std::to_string(sizeof(QuietResourceHolder)));
+    runner.add_context("sizeof_fast", std::to_string(sizeof(Fast::Holder)));
+
+    bool ok = true;
+    const std::pair<std::string, std::size_t> sizes[] = {{"small", small}, {"large", large}};
+    for (const auto& s : sizes) {
+        run_variant<Legacy>(runner, s.first + "/legacy", n, s.second, ok);
+        run_variant<Fast>(runner, s.first + "/fast", n, s.second, ok);
+        run_variant<FastArena>(runner, s.first + "/fast_arena", n, s.second, ok);
+    }
+
+    if (!ok) std::cout << "ERROR: a holder operation produced wrong contents!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Holders per second for four vector-of-holder workloads, with --count holders of
+--small (default 8, fits the 16-element inline buffer) and --large (default 64,
+always on the heap) ints:
+
+-   growth: push_back of fresh holders without reserve(); the vector reallocates
+    log2(count) times and moves every holder each time.
+-   sort: std::sort by the first element (scrambled), which only moves holders.
+-   copy: copy assignment of the whole vector (one deep copy per holder).
+-   move: move every holder into another (reserved) vector.
+
+Variants:
+-   legacy: the original `ResourceHolder` without name and printing: `new int[size]`
+    for every construction and copy, a pointer steal for every move.
+-   fast: `FastResourceHolder<int>` with std::allocator. Small buffers are inline
+    (no allocation; a move copies the elements), large ones behave like legacy.
+-   fast_arena: the same with `ArenaAllocator` over a 1 MiB-chunk `BumpArena`, so
+    large buffers cost a pointer bump and are freed all at once (the arena is
+    reset, keeping its chunks, before every sample).
+
+The "small" rows show the small-buffer optimization (no allocator calls at all),
+the "large" rows the allocator. sizeof of both holder types is stored in the JSON
+context: the inline buffer makes FastResourceHolder larger, which growth and sort
+(which only move holders) pay for. Every workload checks its result; a mismatch prints
+an ERROR.
+
+Options: --count=N (default 100000), --small=N, --large=N, plus the common harness
+options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_resource_holder`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_resource_holder.cpp -o bench_resource_holder
+./bench_resource_holder --json=resource_holder.json
+*/
@@ -0,0 +1,158 @@
+// bench_rw_locks.cpp
+// Replays the reader_thread/writer_thread workload of
+// cpp14/standard_library/std_shared_timed_mutex.cpp without sleeps and printing,
+// to compare std::shared_timed_mutex/std::shared_mutex with the locks in rw_locks.hpp.
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp14/standard_library/rw_locks.hpp"
+
+namespace {
+
+// The shared state: the demo's value plus its log reduced to a counter (the log
+// string itself is a separate problem, see the append log), and a checksum that
+// lets readers detect a torn read.
+struct State {
+    long long value = 0;
+    long long log_entries = 0;
+    long long checksum = 0;
+};
+
+struct Workload {
+    int readers;
+    int writers;
+    long long reads_per_reader;
+    long long writes_per_writer;
+};
+
+std::atomic<long long> g_torn_reads{0};
+
+inline void check(const State& s) {
+    if (s.checksum != s.value + s.log_entries) g_torn_reads.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void modify(State& s) {
+    ++s.value;
+    ++s.log_entries;
+    s.checksum = s.value + s.log_entries;
+}
+
+// Starts all threads, releases them together and joins them.
+template<typename ReadOp, typename WriteOp>
+void run_threads(const Workload& w, ReadOp read, WriteOp write) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < w.readers; ++r) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (long long i = 0; i < w.reads_per_reader; ++i) read();
+        });
+    }
+    for (int wr = 0; wr < w.writers; ++wr) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (long long i = 0; i < w.writes_per_writer; ++i) write();
+        });
+    }
+    go.store(true, std::memory_order_release);
+    for (std::thread& t : threads) t.join();
+}
+
+template<typename RWMutex>
+void run_lock(bench::Runner& runner, const std::string& name, const Workload& w) {
+    RWMutex mutex;
+    State state;
+    const double ops = double(w.readers * w.reads_per_reader + w.writers * w.writes_per_writer);
+    runner.run(name, [&] {
+        run_threads(w,
+            [&] {
+                std::shared_lock<RWMutex> lock(mutex);
+                check(state);
+                bench::do_not_optimize(state.value);
+            },
+            [&] {
+                std::unique_lock<RWMutex> lock(mutex);
+                modify(state);
+            });
+    }, ops);
+}
+
+void run_seqlock(bench::Runner& runner, const std::string& name, const Workload& w) {
+    SeqLock<State> state;
+    const double ops = double(w.readers * w.reads_per_reader + w.writers * w.writes_per_writer);
+    runner.run(name, [&] {
+        run_threads(w,
+            [&] {
+                State s = state.load();
+                check(s);
+                bench::do_not_optimize(s.value);
+            },
+            [&] { state.update([](State s) { modify(s); return s; }); });
+    }, ops);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("rw_locks", bench::parse_args(argc, argv));
+    const long long reads = bench::int_option(runner.options(), "reads", 200000);
+    const long long ratio = std::max(1LL, bench::int_option(runner.options(), "ratio", 100));
+    runner.add_context("reads_per_reader", std::to_string(reads));
+    runner.add_context("reads_per_write", std::to_string(ratio));
+
+    // --readers=R --writers=W runs one configuration; otherwise a small matrix.
+    std::vector<std::pair<int, int>> configs = {{1, 0}, {4, 0}, {4, 1}, {8, 1}, {4, 4}};
+    const long long readers = bench::int_option(runner.options(), "readers", -1);
+    const long long writers = bench::int_option(runner.options(), "writers", -1);
+    if (readers >= 0 || writers >= 0) {
+        configs = {{static_cast<int>(readers >= 0 ? readers : 4), static_cast<int>(writers >= 0 ? writers : 1)}};
+    }
+
+    for (const auto& config : configs) {
+        const Workload w{config.first, config.second, reads, reads / ratio};
+        const std::string prefix = "r" + std::to_string(w.readers) + "w" + std::to_string(w.writers) + "/";
+        run_lock<std::shared_timed_mutex>(runner, prefix + "shared_timed_mutex", w);
+        run_lock<std::shared_mutex>(runner, prefix + "shared_mutex", w);
+        run_lock<DistributedSharedMutex>(runner, prefix + "distributed", w);
+        run_lock<TicketRWLock>(runner, prefix + "ticket", w);
+        run_seqlock(runner, prefix + "seqlock", w);
+    }
+
+    if (g_torn_reads.load() != 0) std::cout << "ERROR: " << g_torn_reads.load() << " readers saw a half-done write!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+`std_shared_timed_mutex.cpp` has writer threads that update `SharedData` under an
+exclusive lock and reader threads that read it under a shared lock. This benchmark
+runs that pattern flat out: every reader performs --reads shared-locked reads, every
+writer performs reads/--ratio exclusive writes, and the throughput (operations per
+second over all threads) is reported for each lock:
+
+-   shared_timed_mutex, shared_mutex: the standard library (pthread rwlock on Linux).
+-   distributed: `DistributedSharedMutex` (per-slot reader counters).
+-   ticket: `TicketRWLock` (writer-preferring, FIFO writers).
+-   seqlock: `SeqLock<State>` (optimistic reads, retried on conflict).
+
+Names are `r<readers>w<writers>/<lock>`. The interesting effect, readers no longer
+fighting over one cache line, needs several cores; on a single core the
+lock-based variants perform about the same. Readers verify a checksum on every read, so a lock
+that lets a reader see a half-written state is reported as an ERROR.
+
+Options: --readers=N, --writers=N (one configuration instead of the matrix),
+--reads=N (per reader, default 200000), --ratio=N (reads per write, default 100),
+plus the common harness options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_rw_locks`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_rw_locks.cpp -o bench_rw_locks -pthread
+./bench_rw_locks --readers=16 --writers=1 --json=rw_locks.json
+*/
@@ -0,0 +1,143 @@
+// bench_thread_pool.cpp
+// Tasks per second for short tasks: a new std::thread per task (as in
+// cpp11/standard_library/std_thread.cpp), std::async, and the reusable ThreadPool
+// from thread_pool.hpp (per-task submit and submit_batch).
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/standard_library/thread_pool.hpp"
+
+namespace {
+
+// A short task: `work` iterations of a cheap integer recurrence.
+long long short_task(long long seed, long long work) {
+    long long x = seed;
+    for (long long i = 0; i < work; ++i) x = x * 6364136223846793005LL + 1442695040888963407LL;
+    return x;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("thread_pool", bench::parse_args(argc, argv));
+    const long long tasks = bench::int_option(runner.options(), "tasks", 10000);
+    const long long work = bench::int_option(runner.options(), "work", 100);
+    const unsigned threads = static_cast<unsigned>(
+        bench::int_option(runner.options(), "threads", std::max(1u, std::thread::hardware_concurrency())));
+    runner.add_context("tasks", std::to_string(tasks));
+    runner.add_context("work_per_task", std::to_string(work));
+    runner.add_context("threads", std::to_string(threads));
+
+    long long expected = 0;
+    for (long long t = 0; t < tasks; ++t) expected ^= short_task(t, work);
+    bool ok = true;
+    auto check = [&](const std::string& name, long long result) {
+        if (result != expected) {
+            std::cout << "ERROR: " << name << " computed a wrong result!" << std::endl;
+            ok = false;
+        }
+    };
+
+    runner.run("serial", [&] {
+        long long acc = 0;
+        for (long long t = 0; t < tasks; ++t) acc ^= short_task(t, work);
+        check("serial", acc);
+    }, double(tasks));
+
+    // One std::thread per task, at most `threads` alive at a time, result via reference.
+    runner.run("spawn/thread_per_task", [&] {
+        long long acc = 0;
+        std::vector<long long> results(threads);
+        std::vector<std::thread> wave;
+        for (long long t = 0; t < tasks; t += threads) {
+            const long long end = std::min<long long>(tasks, t + threads);
+            for (long long i = t; i < end; ++i) {
+                wave.emplace_back([&results, i, t, work] { results[static_cast<std::size_t>(i - t)] = short_task(i, work); });
+            }
+            for (std::thread& th : wave) th.join();
+            wave.clear();
+            for (long long i = t; i < end; ++i) acc ^= results[static_cast<std::size_t>(i - t)];
+        }
+        check("spawn/thread_per_task", acc);
+    }, double(tasks));
+
+    // std::async(std::launch::async) also creates a thread per task in libstdc++.
+    runner.run("spawn/async", [&] {
+        long long acc = 0;
+        std::vector<std::future<long long>> wave;
+        for (long long t = 0; t < tasks; t += threads) {
+            const long long end = std::min<long long>(tasks, t + threads);
+            for (long long i = t; i < end; ++i) wave.push_back(std::async(std::launch::async, short_task, i, work));
+            for (auto& f : wave) acc ^= f.get();
+            wave.clear();
+        }
+        check("spawn/async", acc);
+    }, double(tasks));
+
+    ThreadPool pool(threads);
+
+    runner.run("pool/submit", [&] {
+        std::vector<std::future<long long>> futures;
+        futures.reserve(static_cast<std::size_t>(tasks));
+        for (long long t = 0; t < tasks; ++t) futures.push_back(pool.submit(short_task, t, work));
+        long long acc = 0;
+        for (auto& f : futures) acc ^= f.get();
+        check("pool/submit", acc);
+    }, double(tasks));
+
+    std::vector<std::function<long long()>> jobs;
+    runner.run("pool/submit_batch",
+        [&] {
+            jobs.clear();
+            for (long long t = 0; t < tasks; ++t) jobs.push_back([t, work] { return short_task(t, work); });
+        },
+        [&] {
+            auto futures = pool.submit_batch(jobs.begin(), jobs.end());
+            long long acc = 0;
+            for (auto& f : futures) acc ^= f.get();
+            check("pool/submit_batch", acc);
+        }, double(tasks));
+
+    // Startup cost of the pool itself, for comparison with one spawned thread.
+    runner.run("pool/create_and_shutdown", [&] {
+        ThreadPool fresh(threads);
+        fresh.shutdown();
+    }, 1.0);
+
+    if (!ok) std::cout << "ERROR: results differ from the serial run" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+`std_thread.cpp` creates a new `std::thread` for every task. This benchmark runs
+--tasks short tasks (--work iterations of an integer recurrence each, about a
+hundred nanoseconds by default) and reports tasks per second:
+
+-   serial: all tasks on the calling thread (the work itself, no overhead).
+-   spawn/thread_per_task: one `std::thread` per task, --threads at a time, results
+    returned through a reference like `sum_vector`.
+-   spawn/async: `std::async(std::launch::async, ...)` per task.
+-   pool/submit: `ThreadPool::submit()` per task, results through futures.
+-   pool/submit_batch: all tasks queued with one `submit_batch()` call (building the
+    task list is excluded from the timing).
+-   pool/create_and_shutdown: creating and joining a pool of --threads threads.
+
+Thread creation costs tens of microseconds, so the spawn variants are dominated by
+it; the pool pays a queue operation and a future per task instead. Increase --work
+to see where the task itself starts to dominate and the difference disappears.
+
+Options: --tasks=N (default 10000), --work=N (default 100), --threads=N (default:
+hardware threads), plus the common harness options (--samples, --warmup, --pin,
+--json, --filter).
+
+How to compile (CMake target `bench_thread_pool`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_thread_pool.cpp -o bench_thread_pool -pthread
+./bench_thread_pool --tasks=50000 --work=1000 --json=thread_pool.json
+*/
@@ -0,0 +1,165 @@
+// bench_vector_reallocation.cpp
+// What std::vector growth costs when the element's move constructor is noexcept,
+// when it may throw, and when the type can only be copied: the ResourceHolder of
+// cpp11/core_language/rvalue_references_move_semantics.cpp in three variants and
+// several payload sizes. Allocations are counted with
+// cpp11/standard_library/allocation_tracker.hpp.
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/standard_library/allocation_tracker.hpp"
+
+namespace {
+
+// ResourceHolder without name and printing: a heap array of `size` ints with deep
+// copies. The three holder types below differ only in their move constructor.
+class Payload {
+public:
+    int back() const { return data_[size_ - 1]; }
+
+protected:
+    Payload() : data_(nullptr), size_(0) {}
+    explicit Payload(std::size_t size) : data_(new int[size]), size_(size) {
+        for (std::size_t i = 0; i < size_; ++i) data_[i] = static_cast<int>(i);
+    }
+    ~Payload() { delete[] data_; }
+    Payload(const Payload& other) : data_(new int[other.size_]), size_(other.size_) {
+        for (std::size_t i = 0; i < size_; ++i) data_[i] = other.data_[i];
+    }
+    Payload& operator=(const Payload&) = delete; // push_back never assigns
+
+    void steal(Payload& other) {
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+private:
+    int* data_;
+    std::size_t size_;
+};
+
+// Reallocation moves the elements (std::move_if_noexcept chooses the move).
+struct NoexceptMoveHolder : Payload {
+    explicit NoexceptMoveHolder(std::size_t size) : Payload(size) {}
+    NoexceptMoveHolder(const NoexceptMoveHolder&) = default;
+    NoexceptMoveHolder(NoexceptMoveHolder&& other) noexcept { steal(other); }
+};
+
+// The same move, but not declared noexcept: to keep push_back's strong exception
+// guarantee, reallocation copies every element. push_back(temporary) still moves.
+struct ThrowingMoveHolder : Payload {
+    explicit ThrowingMoveHolder(std::size_t size) : Payload(size) {}
+    ThrowingMoveHolder(const ThrowingMoveHolder&) = default;
+    ThrowingMoveHolder(ThrowingMoveHolder&& other) { steal(other); }
+};
+
+// No move constructor at all (a user-declared copy constructor suppresses the
+// implicit one): every rvalue is copied as well.
+struct CopyOnlyHolder : Payload {
+    explicit CopyOnlyHolder(std::size_t size) : Payload(size) {}
+    CopyOnlyHolder(const CopyOnlyHolder&) = default;
+};
+
+static_assert(std::is_nothrow_move_constructible<NoexceptMoveHolder>::value, "moves without throwing");
+static_assert(!std::is_nothrow_move_constructible<ThrowingMoveHolder>::value, "move may throw");
+
+// push_back of `count` fresh holders, without reserve() unless `reserved`.
+template<typename H>
+bool grow(std::size_t count, std::size_t ints, bool reserved) {
+    std::vector<H> v;
+    if (reserved) v.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) v.push_back(H(ints));
+    bench::do_not_optimize(v.data());
+    return v.size() == count && v.front().back() == static_cast<int>(ints - 1) &&
+           v.back().back() == static_cast<int>(ints - 1);
+}
+
+struct Counted {
+    std::string name;
+    AllocationStats stats;
+};
+
+template<typename H>
+void run_variant(bench::Runner& runner, const std::string& name, std::size_t count, std::size_t ints,
+                 bool reserved, std::vector<Counted>& counted, bool& ok) {
+    if (!runner.enabled(name)) return;
+    runner.run(name, [&] {
+        if (!grow<H>(count, ints, reserved)) ok = false;
+    }, double(count));
+    // One more, untimed run to count the allocations.
+    AllocationScope scope;
+    if (!grow<H>(count, ints, reserved)) ok = false;
+    counted.push_back(Counted{name, scope.stats()});
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("vector_reallocation", bench::parse_args(argc, argv));
+    const std::size_t count = static_cast<std::size_t>(bench::int_option(runner.options(), "count", 10000));
+    runner.add_context("count", std::to_string(count));
+
+    bool ok = true;
+    std::vector<Counted> counted;
+    const std::size_t payload_bytes[] = {16, 256, 4096};
+    for (std::size_t bytes : payload_bytes) {
+        const std::size_t ints = bytes / sizeof(int);
+        const std::string prefix = std::to_string(bytes) + "B/";
+        run_variant<NoexceptMoveHolder>(runner, prefix + "noexcept_move", count, ints, false, counted, ok);
+        run_variant<ThrowingMoveHolder>(runner, prefix + "throwing_move", count, ints, false, counted, ok);
+        run_variant<CopyOnlyHolder>(runner, prefix + "copy_only", count, ints, false, counted, ok);
+        run_variant<NoexceptMoveHolder>(runner, prefix + "reserved", count, ints, true, counted, ok);
+    }
+
+    std::printf("\nAllocations of one growth to %zu holders:\n", count);
+    std::printf("%-24s %12s %14s %14s\n", "benchmark", "allocations", "MiB allocated", "peak MiB");
+    for (const Counted& c : counted) {
+        std::printf("%-24s %12lld %14.1f %14.1f\n", c.name.c_str(), c.stats.allocations,
+                    double(c.stats.bytes_allocated) / (1 << 20), double(c.stats.peak_bytes) / (1 << 20));
+        runner.add_context("allocations_" + c.name, std::to_string(c.stats.allocations));
+        runner.add_context("bytes_allocated_" + c.name, std::to_string(c.stats.bytes_allocated));
+    }
+
+    if (!ok) std::cout << "ERROR: a vector ended up with wrong contents!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+`std::vector::push_back` promises the strong exception guarantee: if it throws, the
+vector is unchanged. When it reallocates, it therefore moves the old elements only
+if their move constructor cannot throw (`std::move_if_noexcept`); otherwise it copies
+them, so that a failure halfway leaves the originals intact. A move constructor that
+does not throw but is not *declared* `noexcept` silently turns every reallocation
+into a deep copy.
+
+Each benchmark pushes --count holders into an empty vector (holders per second):
+-   <bytes>B/noexcept_move: `ResourceHolder(ResourceHolder&&) noexcept`, as in the
+    example: reallocation steals the arrays.
+-   <bytes>B/throwing_move: the identical move constructor without `noexcept`:
+    reallocation copies every array (push_back of the temporary still moves).
+-   <bytes>B/copy_only: no move constructor: the temporary and every reallocation
+    are copied.
+-   <bytes>B/reserved: noexcept_move after reserve(count): no reallocation at all.
+
+Payload sizes are 16, 256 and 4096 bytes (4, 64 and 1024 ints). Afterwards one
+untimed growth of each benchmark runs inside an `AllocationScope`; the table shows
+the number of allocations, the bytes allocated and the peak of live bytes (also
+stored in the JSON context). With noexcept moves the count is one array per holder
+plus the vector's buffers; with copies every reallocation also copies all arrays.
+The counting `operator new` is active for all variants, so it does not bias the
+comparison.
+
+Options: --count=N (default 10000), plus the common harness options (--samples,
+--warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_vector_reallocation`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_vector_reallocation.cpp -o bench_vector_reallocation
+./bench_vector_reallocation --json=vector_reallocation.json
+*/
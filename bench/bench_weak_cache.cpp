@@ -0,0 +1,153 @@
+// bench_weak_cache.cpp
+// Lookup throughput and hit rate of WeakCache (cpp11/standard_library/weak_cache.hpp)
+// with 1..N threads, for a single shard (one global lock) and for several shards.
+// Keys follow a Zipf distribution, as real cache traffic usually does.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cpp11/standard_library/weak_cache.hpp"
+
+namespace {
+
+// Stand-in for smart_pointers.cpp's MyResource: something worth caching.
+struct Resource {
+    explicit Resource(int k) : key(k), payload(64, static_cast<char>('a' + k % 26)) {}
+    int key;
+    std::string payload;
+};
+
+struct Lcg {
+    std::uint64_t state;
+    double uniform() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return double(state >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// Key sequence with P(rank r) proportional to 1 / r^skew (rank 1 most popular).
+std::vector<int> zipf_keys(std::size_t count, int keys, double skew, std::uint64_t seed) {
+    std::vector<double> cdf(static_cast<std::size_t>(keys));
+    double total = 0;
+    for (int r = 0; r < keys; ++r) cdf[static_cast<std::size_t>(r)] = (total += 1.0 / std::pow(r + 1.0, skew));
+    Lcg rng{seed};
+    std::vector<int> out(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double u = rng.uniform() * total;
+        out[i] = static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner("weak_cache", bench::parse_args(argc, argv));
+    const std::size_t ops = static_cast<std::size_t>(bench::int_option(runner.options(), "ops", 200000));
+    const int keys = static_cast<int>(std::max<long long>(1, bench::int_option(runner.options(), "keys", 100000)));
+    const std::size_t capacity = static_cast<std::size_t>(bench::int_option(runner.options(), "capacity", 4096));
+    const int max_threads = static_cast<int>(std::max<long long>(1, bench::int_option(runner.options(), "threads", 8)));
+    const std::size_t held = static_cast<std::size_t>(bench::int_option(runner.options(), "held", 16));
+    const double skew = 0.99;
+    runner.add_context("ops_per_thread", std::to_string(ops));
+    runner.add_context("keys", std::to_string(keys));
+    runner.add_context("capacity", std::to_string(capacity));
+    runner.add_context("held_per_thread", std::to_string(held));
+    runner.add_context("zipf_skew", std::to_string(skew));
+
+    std::vector<std::vector<int> > sequences;
+    for (int t = 0; t < max_threads; ++t) sequences.push_back(zipf_keys(ops, keys, skew, 1234 + t));
+
+    struct Row {
+        std::string name;
+        WeakCacheStats stats;
+    };
+    std::vector<Row> rows;
+    bool ok = true;
+    const std::size_t shard_counts[] = {1, 16, 64};
+
+    for (std::size_t shards : shard_counts) {
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            const std::string name = "lookup/shards=" + std::to_string(shards) + "/threads=" + std::to_string(threads);
+            if (!runner.enabled(name)) continue;
+            WeakCacheOptions options;
+            options.shards = shards;
+            options.strong_capacity = capacity;
+            WeakCache<int, Resource> cache([](const int& key) { return std::make_shared<Resource>(key); }, options);
+
+            runner.run(name, [&] {
+                std::vector<std::thread> workers;
+                for (int t = 0; t < threads; ++t) {
+                    workers.emplace_back([&, t] {
+                        // Each thread keeps its last `held` results alive, like callers
+                        // still working with objects: those are found through weak_ptrs.
+                        std::vector<std::shared_ptr<Resource> > recent(std::max<std::size_t>(held, 1));
+                        std::size_t bytes = 0;
+                        const std::vector<int>& sequence = sequences[static_cast<std::size_t>(t)];
+                        for (std::size_t i = 0; i < sequence.size(); ++i) {
+                            std::shared_ptr<Resource> r = cache.get(sequence[i]);
+                            if (r->key != sequence[i]) ok = false;
+                            bytes += r->payload.size();
+                            if (held > 0) recent[i % held] = std::move(r);
+                        }
+                        bench::do_not_optimize(bytes);
+                    });
+                }
+                for (std::thread& w : workers) w.join();
+            }, double(ops) * threads);
+
+            rows.push_back(Row{name, cache.stats()});
+        }
+    }
+
+    std::printf("\nHit rates (over warmup and samples):\n");
+    std::printf("%-32s %9s %12s %10s %10s %10s\n", "benchmark", "hit rate", "strong hits", "weak hits", "misses", "evictions");
+    for (const Row& row : rows) {
+        std::printf("%-32s %8.1f%% %12llu %10llu %10llu %10llu\n", row.name.c_str(), 100.0 * row.stats.hit_rate(),
+                    static_cast<unsigned long long>(row.stats.strong_hits), static_cast<unsigned long long>(row.stats.weak_hits),
+                    static_cast<unsigned long long>(row.stats.misses), static_cast<unsigned long long>(row.stats.evictions));
+        runner.add_context("hit_rate_" + row.name, std::to_string(row.stats.hit_rate()));
+    }
+
+    if (!ok) std::cout << "ERROR: the cache returned an object for the wrong key!" << std::endl;
+    return runner.finish();
+}
+
+/*
+Explanation:
+Every thread performs --ops lookups (`cache.get(key)`, read the object, keep it in a
+small ring of the last --held results) with keys drawn from a Zipf distribution
+(skew 0.99) over --keys keys. A miss runs the loader (`std::make_shared<Resource>`).
+Lookups per second, over all threads, for:
+-   shards=1: one mutex for the whole cache, the baseline a single
+    `std::mutex` + `std::unordered_map` would give.
+-   shards=16 and shards=64: the key's hash picks a shard; threads only contend
+    when they touch the same shard at the same time.
+and 1, 2, 4, ... --threads threads. Each configuration starts with an empty cache.
+
+The table after the timings shows where hits come from: the strong tier (the
+--capacity most recently used objects, CLOCK-evicted) or the weak tier (objects
+evicted from the strong tier but still held by some thread's recent ring, found
+again through their `weak_ptr`). With more threads, more objects are held at once,
+so weak hits grow. Hit rates with different shard counts differ slightly because
+every shard runs its own CLOCK over capacity/shards slots.
+
+On a machine with fewer cores than threads the multi-threaded rows measure lock
+hand-over under preemption rather than parallel speedup; the shard comparison is
+still meaningful because a preempted lock holder blocks only its shard.
+
+Options: --ops=N per thread (default 200000), --keys=N (default 100000),
+--capacity=N strong-tier objects (default 4096), --threads=N maximum (default 8),
+--held=N results each thread keeps alive (default 16), plus the common harness
+options (--samples, --warmup, --pin, --json, --filter).
+
+How to compile (CMake target `bench_weak_cache`, or by hand):
+g++ -std=c++20 -O2 -I. -Ibench bench/bench_weak_cache.cpp -o bench_weak_cache -pthread
+./bench_weak_cache --json=weak_cache.json
+*/
@@ -0,0 +1,428 @@
+// benchmark.hpp
+// A tiny, header-only benchmark harness shared by the targets in bench/.
+// Each benchmark is warmed up, sampled repeatedly with an untimed setup step
+// before every sample, and summarized as min / median / p95 / mean / stddev.
+// Results can be written as JSON to track regressions across compilers and
+// standard library versions.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace bench {
+
+// Optimization barriers. do_not_optimize() forces `value` to be materialized
+// (the compiler must assume it is read), clobber_memory() forces all pending
+// writes to memory to happen (the compiler must assume all memory is read).
+#if defined(__GNUC__) || defined(__clang__)
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template<typename T>
+inline void do_not_optimize(T& value) {
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    asm volatile("" : "+m,r"(value) : : "memory");
+#endif
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+#else
+// Portable fallback: a volatile read through a pointer the compiler cannot see through.
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    static volatile const void* sink;
+    sink = &value;
+}
+
+inline void clobber_memory() {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+#endif
+
+struct Options {
+    int warmup = 2;            // Untimed runs before sampling (cold caches, page faults, lazy init)
+    int samples = 11;          // Timed runs; odd so the median is an actual sample
+    std::string pin_cpus;      // CPU list like "0-3,8"; empty means "do not pin"
+    std::string json_path;     // Write results as JSON when non-empty
+    std::string filter;        // Only run benchmarks whose name contains this substring
+    std::vector<std::string> extra; // Arguments the harness did not recognize
+};
+
+struct Result {
+    std::string name;
+    std::vector<double> samples_ms;
+    double min_ms = 0, median_ms = 0, p95_ms = 0, mean_ms = 0, stddev_ms = 0;
+    double items = 0;          // Work items per sample, used for throughput (0 = none)
+
+    double items_per_second() const {
+        return (items > 0 && median_ms > 0) ? items / (median_ms / 1000.0) : 0.0;
+    }
+};
+
+// Nearest-rank percentile of an already sorted sample vector.
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double rank = std::ceil(p / 100.0 * static_cast<double>(sorted.size()));
+    std::size_t index = rank < 1 ? 0 : static_cast<std::size_t>(rank) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+inline Result summarize(std::string name, std::vector<double> samples_ms, double items) {
+    Result r;
+    r.name = std::move(name);
+    r.items = items;
+    r.samples_ms = samples_ms;
+    if (samples_ms.empty()) return r;
+    std::sort(samples_ms.begin(), samples_ms.end());
+    r.min_ms = samples_ms.front();
+    r.median_ms = percentile(samples_ms, 50);
+    r.p95_ms = percentile(samples_ms, 95);
+    double sum = 0;
+    for (double s : samples_ms) sum += s;
+    r.mean_ms = sum / static_cast<double>(samples_ms.size());
+    double sq = 0;
+    for (double s : samples_ms) sq += (s - r.mean_ms) * (s - r.mean_ms);
+    r.stddev_ms = samples_ms.size() > 1 ? std::sqrt(sq / static_cast<double>(samples_ms.size() - 1)) : 0.0;
+    return r;
+}
+
+// Parses "0-3,8,10-11" into a list of CPU ids. Returns an empty list on error.
+inline std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        std::size_t dash = item.find('-');
+        char* end = nullptr;
+        long lo = std::strtol(item.c_str(), &end, 10);
+        long hi = lo;
+        if (dash != std::string::npos) hi = std::strtol(item.c_str() + dash + 1, &end, 10);
+        if (lo < 0 || hi < lo) return {};
+        for (long c = lo; c <= hi; ++c) cpus.push_back(static_cast<int>(c));
+    }
+    return cpus;
+}
+
+// Restricts the calling thread to the given CPUs. Threads created afterwards
+// inherit the mask, so pinning to several CPUs also confines worker pools.
+inline bool pin_current_thread(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c >= CPU_SETSIZE) return false;
+        CPU_SET(c, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+inline void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [--warmup=N] [--samples=N] [--pin=CPULIST]"
+              << " [--json=FILE] [--filter=SUBSTRING]\n";
+}
+
+inline Options parse_args(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value_of = [&arg](const char* prefix) -> const char* {
+            std::size_t len = std::char_traits<char>::length(prefix);
+            return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+        };
+        if (const char* v = value_of("--warmup=")) opts.warmup = std::max(0, std::atoi(v));
+        else if (const char* v = value_of("--samples=")) opts.samples = std::max(1, std::atoi(v));
+        else if (const char* v = value_of("--pin=")) opts.pin_cpus = v;
+        else if (const char* v = value_of("--json=")) opts.json_path = v;
+        else if (const char* v = value_of("--filter=")) opts.filter = v;
+        else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            opts.extra.push_back(arg);
+        }
+    }
+    return opts;
+}
+
+// Reads a benchmark-specific "--name=value" integer from the unrecognized arguments.
+inline long long int_option(const Options& opts, const std::string& name, long long fallback) {
+    const std::string prefix = "--" + name + "=";
+    for (const std::string& arg : opts.extra) {
+        if (arg.compare(0, prefix.size(), prefix) == 0) return std::atoll(arg.c_str() + prefix.size());
+    }
+    return fallback;
+}
+
+inline bool flag_option(const Options& opts, const std::string& name) {
+    const std::string flag = "--" + name;
+    return std::find(opts.extra.begin(), opts.extra.end(), flag) != opts.extra.end();
+}
+
+// Escapes a string for use inside a JSON string literal.
+inline std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+class Runner {
+public:
+    using clock = std::chrono::steady_clock;
+
+    Runner(std::string suite, Options opts) : suite_(std::move(suite)), opts_(std::move(opts)) {
+        add_context("compiler", compiler_string());
+        add_context("stdlib", stdlib_string());
+        add_context("cplusplus", std::to_string(__cplusplus));
+        add_context("hardware_concurrency", std::to_string(std::thread::hardware_concurrency()));
+        if (!opts_.pin_cpus.empty()) {
+            bool pinned = pin_current_thread(parse_cpu_list(opts_.pin_cpus));
+            add_context("pinned_cpus", pinned ? opts_.pin_cpus : "(pinning failed)");
+            if (!pinned) std::cerr << "warning: could not pin to CPUs '" << opts_.pin_cpus << "'" << std::endl;
+        }
+        std::cout << "=== " << suite_ << " (warmup " << opts_.warmup << ", samples " << opts_.samples << ") ===" << std::endl;
+    }
+
+    const Options& options() const { return opts_; }
+
+    // Free-form key/value pairs recorded in the JSON "context" object (sizes, thread counts, ...).
+    void add_context(const std::string& key, const std::string& value) {
+        for (auto& kv : context_) {
+            if (kv.first == key) { kv.second = value; return; }
+        }
+        context_.emplace_back(key, value);
+    }
+
+    bool enabled(const std::string& name) const {
+        return opts_.filter.empty() || name.find(opts_.filter) != std::string::npos;
+    }
+
+    // setup() runs untimed before every warmup and sample (e.g. to restore an unsorted input),
+    // body() is the timed region. `items` is the work per sample for throughput reporting.
+    template<typename Setup, typename Body>
+    const Result* run(const std::string& name, Setup&& setup, Body&& body, double items = 0) {
+        if (!enabled(name)) return nullptr;
+        for (int i = 0; i < opts_.warmup; ++i) {
+            setup();
+            clobber_memory();
+            body();
+            clobber_memory();
+        }
+        std::vector<double> samples;
+        samples.reserve(static_cast<std::size_t>(opts_.samples));
+        for (int i = 0; i < opts_.samples; ++i) {
+            setup();
+            clobber_memory();
+            auto start = clock::now();
+            body();
+            clobber_memory();
+            auto stop = clock::now();
+            samples.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+        }
+        results_.push_back(summarize(name, std::move(samples), items));
+        print_result(results_.back());
+        return &results_.back();
+    }
+
+    template<typename Body>
+    const Result* run(const std::string& name, Body&& body, double items = 0) {
+        return run(name, [] {}, std::forward<Body>(body), items);
+    }
+
+    // Records a measurement that was taken elsewhere (e.g. per-thread latencies).
+    const Result* record(const std::string& name, std::vector<double> samples_ms, double items = 0) {
+        if (!enabled(name)) return nullptr;
+        results_.push_back(summarize(name, std::move(samples_ms), items));
+        print_result(results_.back());
+        return &results_.back();
+    }
+
+    const std::deque<Result>& results() const { return results_; }
+
+    const Result* find(const std::string& name) const {
+        for (const Result& r : results_) {
+            if (r.name == name) return &r;
+        }
+        return nullptr;
+    }
+
+    // Writes the JSON report if requested. Returns the process exit code.
+    int finish() const {
+        if (opts_.json_path.empty()) return 0;
+        std::ofstream out(opts_.json_path);
+        if (!out) {
+            std::cerr << "error: cannot write " << opts_.json_path << std::endl;
+            return 1;
+        }
+        write_json(out);
+        std::cout << "Results written to " << opts_.json_path << std::endl;
+        return 0;
+    }
+
+    void write_json(std::ostream& out) const {
+        out << std::setprecision(6) << std::fixed;
+        out << "{\n  \"suite\": \"" << json_escape(suite_) << "\",\n";
+        out << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+        out << "  \"context\": {";
+        for (std::size_t i = 0; i < context_.size(); ++i) {
+            out << (i ? ", " : "") << "\"" << json_escape(context_[i].first) << "\": \""
+                << json_escape(context_[i].second) << "\"";
+        }
+        out << "},\n  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            out << "    {\"name\": \"" << json_escape(r.name) << "\", \"unit\": \"ms\""
+                << ", \"min\": " << r.min_ms << ", \"median\": " << r.median_ms
+                << ", \"p95\": " << r.p95_ms << ", \"mean\": " << r.mean_ms
+                << ", \"stddev\": " << r.stddev_ms;
+            if (r.items > 0) {
+                out << ", \"items\": " << r.items << ", \"items_per_second\": " << r.items_per_second();
+            }
+            out << ", \"samples\": [";
+            for (std::size_t s = 0; s < r.samples_ms.size(); ++s) {
+                out << (s ? ", " : "") << r.samples_ms[s];
+            }
+            out << "]}" << (i + 1 < results_.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    static void print_result(const Result& r) {
+        // Sub-0.1 ms results (e.g. per-operation latencies) are printed in microseconds.
+        const bool micro = r.median_ms < 0.1;
+        const double scale = micro ? 1000.0 : 1.0;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(3);
+        line << std::left << std::setw(44) << r.name << std::right
+             << " median " << std::setw(10) << r.median_ms * scale << (micro ? " us" : " ms")
+             << "  min " << std::setw(10) << r.min_ms * scale
+             << "  p95 " << std::setw(10) << r.p95_ms * scale
+             << "  sd " << std::setw(8) << r.stddev_ms * scale;
+        if (r.items > 0) {
+            line << "  " << std::setprecision(2) << std::scientific << r.items_per_second() << " items/s";
+        }
+        std::cout << line.str() << std::endl;
+    }
+
+    static std::string compiler_string() {
+#if defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    static std::string stdlib_string() {
+#if defined(_LIBCPP_VERSION)
+        return "libc++ " + std::to_string(_LIBCPP_VERSION);
+#elif defined(__GLIBCXX__)
+        return "libstdc++ " + std::to_string(__GLIBCXX__);
+#elif defined(_MSVC_STL_VERSION)
+        return "msvc-stl " + std::to_string(_MSVC_STL_VERSION);
+#else
+        return "unknown";
+#endif
+    }
+
+    std::string suite_;
+    Options opts_;
+    std::vector<std::pair<std::string, std::string>> context_;
+    std::deque<Result> results_; // deque: pointers returned by run() stay valid
+};
+
+} // namespace bench
+
+/*
+Explanation:
+Timing a block once with two `high_resolution_clock::now()` calls measures more
+than the code under test: the first run pays for cold caches, first-touch page
+faults and lazy initialization, and a single sample cannot tell a real change
+from scheduler noise. This harness follows the usual recipe instead:
+
+1.  Warmup: the benchmark body runs `warmup` times untimed.
+2.  Sampling: the body runs `samples` times, each timed with `std::chrono::steady_clock`
+    (monotonic, unlike `high_resolution_clock` which may be the wall clock).
+3.  Setup per sample: an optional untimed `setup()` restores the input before every
+    run, e.g. copies an unsorted vector back so a sort never sees sorted data.
+4.  Statistics: min (best case, least noise), median (robust typical value),
+    p95 (tail), mean and standard deviation (spread).
+
+Optimization Barriers:
+-   `bench::do_not_optimize(x)` makes the compiler believe `x` is read, so a result
+    that is otherwise unused is not optimized away.
+-   `bench::clobber_memory()` makes the compiler believe all memory is read and
+    written, so stores are not sunk out of (or hoisted into) the timed region.
+
+CPU Pinning:
+-   `--pin=0-3` restricts the benchmark thread to the given CPUs before anything runs.
+    Threads created later inherit the mask, so parallel benchmarks stay on those CPUs
+    too. Pinning to one CPU therefore serializes multi-threaded benchmarks.
+
+Command Line (shared by every bench_* target):
+    --warmup=N --samples=N --pin=CPULIST --json=FILE --filter=SUBSTRING
+Benchmark-specific options (`--size=N`, `--threads=N`, ...) end up in `Options::extra`
+and are read with `bench::int_option()` / `bench::flag_option()`.
+
+JSON Output:
+-   `--json=results.json` writes all samples and statistics plus the compiler,
+    standard library and hardware concurrency, so runs on different toolchains can be
+    compared with a short script.
+
+Usage Example:
+```cpp
+bench::Runner runner("my_suite", bench::parse_args(argc, argv));
+std::vector<int> input = make_input(), work;
+runner.run("sort", [&] { work = input; }, [&] { std::sort(work.begin(), work.end()); });
+return runner.finish();
+```
+*/
@@ -0,0 +1,322 @@
+// resource_holder.hpp
+// A production variant of the ResourceHolder of rvalue_references_move_semantics.cpp:
+// the same rule-of-five buffer of elements, without the per-operation printing.
+// - FastResourceHolder<T, N, Alloc, Stats>: up to N elements live inside the object
+//   (small-buffer optimization); larger buffers come from the allocator Alloc
+// - BumpArena + ArenaAllocator<T>: a pluggable allocator that carves memory from
+//   large chunks and frees it all at once
+// - NoHolderStats (default) / CountingHolderStats: counters instead of std::cout
+#pragma once
+
+#include <algorithm>   // For std::copy, std::max
+#include <atomic>
+#include <cstddef>
+#include <cstdint>     // For std::uintptr_t
+#include <cstring>     // For std::memcpy
+#include <memory>      // For std::allocator, std::allocator_traits, std::unique_ptr
+#include <type_traits> // For std::aligned_storage, std::is_trivially_copyable
+#include <utility>     // For std::move
+#include <vector>
+
+// Process-wide event counts, updated with relaxed atomics (cheap, and exact once
+// the threads that touched the holders have been joined).
+struct HolderCounts {
+    std::atomic<std::size_t> constructed{0};      // Constructions from a size
+    std::atomic<std::size_t> copied{0};           // Copy constructions and assignments
+    std::atomic<std::size_t> moved{0};            // Move constructions and assignments
+    std::atomic<std::size_t> heap_allocations{0}; // Buffers too large for the inline storage
+
+    void reset() {
+        constructed = 0;
+        copied = 0;
+        moved = 0;
+        heap_allocations = 0;
+    }
+};
+
+// Stats policy that records every event in one HolderCounts.
+struct CountingHolderStats {
+    static HolderCounts& counts() {
+        static HolderCounts c;
+        return c;
+    }
+    static void on_construct() { counts().constructed.fetch_add(1, std::memory_order_relaxed); }
+    static void on_copy() { counts().copied.fetch_add(1, std::memory_order_relaxed); }
+    static void on_move() { counts().moved.fetch_add(1, std::memory_order_relaxed); }
+    static void on_heap_allocation() { counts().heap_allocations.fetch_add(1, std::memory_order_relaxed); }
+};
+
+// Stats policy that compiles to nothing.
+struct NoHolderStats {
+    static void on_construct() {}
+    static void on_copy() {}
+    static void on_move() {}
+    static void on_heap_allocation() {}
+};
+
+// Monotonic arena: allocations bump a pointer inside large chunks and deallocation
+// is a no-op. reset() makes all memory reusable at once (keeping the chunks, so a
+// reused arena does not touch the system allocator again); release() frees it.
+// Not thread-safe: use one arena per thread or per phase of work.
+class BumpArena {
+public:
+    explicit BumpArena(std::size_t chunk_bytes = 64 * 1024) : chunk_bytes_(chunk_bytes), current_(0), cur_(0), end_(0) {}
+
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+        std::uintptr_t p = align_up(cur_, alignment);
+        while (cur_ == 0 || p + bytes > end_) {
+            // Next kept chunk, or a new one (oversized requests get a chunk of their own).
+            if (cur_ != 0) ++current_;
+            if (current_ == chunks_.size()) {
+                Chunk chunk;
+                chunk.size = std::max(chunk_bytes_, bytes + alignment);
+                chunk.memory.reset(new char[chunk.size]);
+                chunks_.push_back(std::move(chunk));
+            }
+            cur_ = reinterpret_cast<std::uintptr_t>(chunks_[current_].memory.get());
+            end_ = cur_ + chunks_[current_].size;
+            p = align_up(cur_, alignment);
+        }
+        cur_ = p + bytes;
+        return reinterpret_cast<void*>(p);
+    }
+
+    // All memory handed out so far becomes invalid and is reused by later allocations.
+    void reset() {
+        current_ = 0;
+        cur_ = end_ = 0;
+    }
+
+    // Like reset(), and gives the chunks back to the system.
+    void release() {
+        chunks_.clear();
+        reset();
+    }
+
+    std::size_t chunk_count() const { return chunks_.size(); }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> memory;
+        std::size_t size;
+    };
+
+    static std::uintptr_t align_up(std::uintptr_t p, std::size_t alignment) {
+        return (p + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+
+    const std::size_t chunk_bytes_;
+    std::vector<Chunk> chunks_;
+    std::size_t current_; // Chunk that cur_ points into
+    std::uintptr_t cur_, end_;
+};
+
+// Minimal C++11 allocator on top of a BumpArena. Copies (and rebinds) share the arena.
+template<typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(BumpArena& arena) : arena_(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, std::size_t) {} // Released with the arena
+
+    BumpArena* arena() const { return arena_; }
+
+private:
+    BumpArena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+// A buffer of `size` elements with value semantics (deep copy, cheap move).
+// Buffers of up to InlineCapacity elements are stored inside the object: no
+// allocation, and the data sits in the same cache lines as size and pointer.
+// T must be trivially copyable (the buffer is copied with std::copy and never
+// constructs or destroys elements individually).
+template<typename T, std::size_t InlineCapacity = 16, typename Alloc = std::allocator<T>,
+         typename Stats = NoHolderStats>
+class FastResourceHolder {
+    static_assert(std::is_trivially_copyable<T>::value, "FastResourceHolder stores trivially copyable elements");
+    typedef std::allocator_traits<Alloc> traits;
+
+public:
+    typedef T value_type;
+    typedef Alloc allocator_type;
+
+    explicit FastResourceHolder(const Alloc& alloc = Alloc()) : impl_(alloc) { impl_.data = inline_data(); }
+
+    // Like ResourceHolder(name, size): elements 0, 1, ..., size - 1.
+    explicit FastResourceHolder(std::size_t size, const Alloc& alloc = Alloc()) : impl_(alloc) {
+        Stats::on_construct();
+        allocate(size);
+        for (std::size_t i = 0; i < size; ++i) impl_.data[i] = static_cast<T>(i);
+    }
+
+    ~FastResourceHolder() { release(); }
+
+    FastResourceHolder(const FastResourceHolder& other)
+        : impl_(traits::select_on_container_copy_construction(other.impl_)) {
+        Stats::on_copy();
+        allocate(other.impl_.size);
+        std::copy(other.begin(), other.end(), impl_.data);
+    }
+
+    FastResourceHolder& operator=(const FastResourceHolder& other) {
+        if (this == &other) return *this;
+        Stats::on_copy();
+        const bool new_allocator = traits::propagate_on_container_copy_assignment::value &&
+                                   alloc() != other.alloc();
+        if (new_allocator || capacity() < other.impl_.size) {
+            release();
+            if (new_allocator) alloc() = other.alloc();
+            allocate(other.impl_.size);
+        }
+        impl_.size = other.impl_.size; // Reuses the current buffer when it is large enough
+        std::copy(other.begin(), other.end(), impl_.data);
+        return *this;
+    }
+
+    FastResourceHolder(FastResourceHolder&& other) noexcept : impl_(std::move(other.alloc())) {
+        Stats::on_move();
+        steal(other);
+    }
+
+    FastResourceHolder& operator=(FastResourceHolder&& other) noexcept {
+        if (this == &other) return *this;
+        Stats::on_move();
+        release();
+        if (traits::propagate_on_container_move_assignment::value) alloc() = std::move(other.alloc());
+        if (traits::propagate_on_container_move_assignment::value || alloc() == other.alloc()) {
+            steal(other);
+        } else {
+            // Memory of another allocator cannot be adopted: copy, which may throw
+            // bad_alloc inside a noexcept function (like std::vector with such allocators).
+            allocate(other.impl_.size);
+            std::copy(other.begin(), other.end(), impl_.data);
+        }
+        return *this;
+    }
+
+    T* data() { return impl_.data; }
+    const T* data() const { return impl_.data; }
+    std::size_t size() const { return impl_.size; }
+    bool empty() const { return impl_.size == 0; }
+    bool is_inline() const { return impl_.data == inline_data(); }
+    T* begin() { return impl_.data; }
+    T* end() { return impl_.data + impl_.size; }
+    const T* begin() const { return impl_.data; }
+    const T* end() const { return impl_.data + impl_.size; }
+    T& operator[](std::size_t i) { return impl_.data[i]; }
+    const T& operator[](std::size_t i) const { return impl_.data[i]; }
+
+    allocator_type get_allocator() const { return impl_; }
+
+private:
+    // The allocator is a base class, so a stateless one (std::allocator) takes no
+    // space (empty base optimization).
+    struct Impl : Alloc {
+        explicit Impl(const Alloc& a) : Alloc(a), data(nullptr), size(0), heap_capacity(0) {}
+        T* data;
+        std::size_t size;
+        std::size_t heap_capacity; // 0 while the inline storage is used
+    };
+
+    Alloc& alloc() { return impl_; }
+    const Alloc& alloc() const { return impl_; }
+    T* inline_data() { return reinterpret_cast<T*>(&inline_); }
+    const T* inline_data() const { return reinterpret_cast<const T*>(&inline_); }
+    std::size_t capacity() const { return impl_.heap_capacity != 0 ? impl_.heap_capacity : InlineCapacity; }
+
+    void allocate(std::size_t size) {
+        if (size <= InlineCapacity) {
+            impl_.data = inline_data();
+        } else {
+            impl_.data = traits::allocate(alloc(), size);
+            impl_.heap_capacity = size;
+            Stats::on_heap_allocation();
+        }
+        impl_.size = size;
+    }
+
+    void release() {
+        if (impl_.heap_capacity != 0) traits::deallocate(alloc(), impl_.data, impl_.heap_capacity);
+        impl_.data = inline_data();
+        impl_.size = 0;
+        impl_.heap_capacity = 0;
+    }
+
+    // Takes other's buffer (heap) or its elements (inline); leaves other empty.
+    void steal(FastResourceHolder& other) {
+        if (other.impl_.heap_capacity != 0) {
+            impl_.data = other.impl_.data;
+            impl_.heap_capacity = other.impl_.heap_capacity;
+        } else {
+            // A fixed-size copy of the whole inline buffer compiles to a few vector
+            // moves, cheaper than a copy of `size` elements.
+            std::memcpy(&inline_, &other.inline_, sizeof(inline_));
+            impl_.data = inline_data();
+        }
+        impl_.size = other.impl_.size;
+        other.impl_.data = other.inline_data();
+        other.impl_.size = 0;
+        other.impl_.heap_capacity = 0;
+    }
+
+    Impl impl_;
+    typename std::aligned_storage<sizeof(T) * InlineCapacity, alignof(T)>::type inline_;
+};
+
+/*
+Explanation:
+The `ResourceHolder` of rvalue_references_move_semantics.cpp teaches the rule of five,
+but as a real type it is slow: every construction and deep copy calls `new int[size]`
+(even for three elements), every special member builds a new `std::string` name and
+writes to `std::cout`, which costs far more than the copy or move itself.
+
+`FastResourceHolder` keeps the semantics (deep copy, pointer-stealing move, moved-from
+objects are empty) and removes those costs:
+-   Small-buffer optimization: buffers of up to `InlineCapacity` elements (16 by
+    default) live inside the object. Creating, copying and destroying them never
+    allocates, and reading them touches no second cache line far away on the heap.
+    Moving such a holder copies the few elements, which is as cheap as stealing.
+-   Pluggable allocator: larger buffers come from `Alloc` through
+    `std::allocator_traits` (select_on_container_copy_construction and the
+    propagate_on_* traits are honoured). `ArenaAllocator<T>` over a `BumpArena` makes
+    each allocation a pointer bump inside 64 KiB chunks and freeing a no-op; many
+    holders created together then also sit next to each other in memory.
+    `BumpArena::reset()` recycles all of it at once while keeping the chunks.
+-   Quiet instrumentation: a `Stats` policy replaces the printing. With
+    `NoHolderStats` (default) the hooks are empty inline functions and vanish; with
+    `CountingHolderStats` each event increments a relaxed atomic counter, readable
+    through `CountingHolderStats::counts()`.
+-   The allocator is stored as a base class of the internal `Impl` struct (empty base
+    optimization), so `std::allocator` adds no bytes to the object.
+
+The price is size: with 16 inline ints the object has 88 bytes instead of 16, so
+code that only moves holders around (vector reallocation, sorting) moves more bytes.
+Choose `InlineCapacity` after the typical buffer size; a move of an inline holder is
+one fixed-size `memcpy`, which the compiler turns into a few vector instructions.
+
+`bench/bench_resource_holder.cpp` compares it with a quiet copy of the original class
+for vector growth, sorting, copying and moving.
+
+Usage Example:
+```cpp
+FastResourceHolder<int> small(8);              // Inline: no allocation
+FastResourceHolder<int> large(1000);           // One allocation from std::allocator
+BumpArena arena;
+typedef FastResourceHolder<int, 16, ArenaAllocator<int> > ArenaHolder;
+std::vector<ArenaHolder> holders;
+holders.push_back(ArenaHolder(100, ArenaAllocator<int>(arena)));
+```
+*/
@@ -0,0 +1,188 @@
+// allocation_tracker.hpp
+// Counts heap allocations by replacing the global operator new and operator delete.
+// - AllocationScope: RAII; allocations, frees, bytes and peak bytes of the calling
+//   thread between its construction and now, optionally reported on destruction
+// - AllocationStats: the numbers, printable with operator<<
+// Include this header in exactly one translation unit of a program: it defines the
+// replaceable global allocation functions, which may only be defined once.
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>   // For std::malloc, std::free
+#include <iostream>
+#include <new>       // For std::bad_alloc, std::nothrow_t, std::get_new_handler
+#include <string>
+
+namespace allocation_detail {
+
+// Per-thread counters: updating them is a plain increment (no atomics), and a scope
+// only sees its own thread's allocations, not those of unrelated threads.
+// Blocks freed by another thread than the one that allocated them make `current`
+// drift, so it is signed.
+struct ThreadCounters {
+    long long allocations;
+    long long deallocations;
+    long long bytes_allocated;
+    long long bytes_freed;
+    long long current;  // Bytes allocated minus bytes freed
+    long long peak;     // Highest `current` since the innermost scope began
+};
+
+inline ThreadCounters& counters() {
+    static thread_local ThreadCounters c = {0, 0, 0, 0, 0, 0}; // Constant-initialized: no guard
+    return c;
+}
+
+// Every block starts with a header holding its size, so operator delete (which is
+// not always told the size) can count the bytes it frees. 16 bytes keep the
+// returned pointer aligned for any fundamental type.
+const std::size_t kHeader = 16;
+
+inline void* allocate(std::size_t size) {
+    for (;;) {
+        if (void* raw = std::malloc(size + kHeader)) {
+            *static_cast<std::size_t*>(raw) = size;
+            ThreadCounters& c = counters();
+            ++c.allocations;
+            c.bytes_allocated += static_cast<long long>(size);
+            c.current += static_cast<long long>(size);
+            if (c.current > c.peak) c.peak = c.current;
+            return static_cast<char*>(raw) + kHeader;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+inline void* allocate_nothrow(std::size_t size) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+inline void deallocate(void* p) noexcept {
+    if (p == nullptr) return;
+    void* raw = static_cast<char*>(p) - kHeader;
+    const std::size_t size = *static_cast<std::size_t*>(raw);
+    ThreadCounters& c = counters();
+    ++c.deallocations;
+    c.bytes_freed += static_cast<long long>(size);
+    c.current -= static_cast<long long>(size);
+    std::free(raw);
+}
+
+} // namespace allocation_detail
+
+// Replaceable global allocation functions (defined once per program, see above).
+// C++17 over-aligned allocations (operator new with std::align_val_t) are not
+// replaced and therefore not counted.
+void* operator new(std::size_t size) { return allocation_detail::allocate(size); }
+void* operator new[](std::size_t size) { return allocation_detail::allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocation_detail::allocate_nothrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocation_detail::allocate_nothrow(size); }
+void operator delete(void* p) noexcept { allocation_detail::deallocate(p); }
+void operator delete[](void* p) noexcept { allocation_detail::deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { allocation_detail::deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { allocation_detail::deallocate(p); }
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* p, std::size_t) noexcept { allocation_detail::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { allocation_detail::deallocate(p); }
+#endif
+
+struct AllocationStats {
+    long long allocations;      // Calls to operator new / new[]
+    long long deallocations;    // Calls to operator delete / delete[] (non-null)
+    long long bytes_allocated;  // Sum of the requested sizes
+    long long bytes_freed;
+    long long peak_bytes;       // Highest live byte count above the level at the start
+};
+
+inline std::ostream& operator<<(std::ostream& out, const AllocationStats& s) {
+    return out << s.allocations << " allocation(s), " << s.deallocations << " free(s), "
+               << s.bytes_allocated << " bytes allocated, peak " << s.peak_bytes << " bytes";
+}
+
+// Measures the calling thread's heap activity from construction on. Scopes nest:
+// each one has its own peak, and an inner scope's peak counts for the outer one.
+class AllocationScope {
+public:
+    // With a label, the destructor prints "[label] <stats>" to std::cout.
+    explicit AllocationScope(const std::string& label = std::string())
+        : label_(label), start_(allocation_detail::counters()), outer_peak_(start_.peak) {
+        allocation_detail::counters().peak = start_.current; // This scope's peak starts here
+    }
+
+    ~AllocationScope() {
+        const AllocationStats s = stats(); // Taken before printing allocates anything
+        allocation_detail::ThreadCounters& c = allocation_detail::counters();
+        if (outer_peak_ > c.peak) c.peak = outer_peak_;
+        if (!label_.empty()) std::cout << "[" << label_ << "] " << s << std::endl;
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    // Counts since construction.
+    AllocationStats stats() const {
+        const allocation_detail::ThreadCounters& c = allocation_detail::counters();
+        AllocationStats s;
+        s.allocations = c.allocations - start_.allocations;
+        s.deallocations = c.deallocations - start_.deallocations;
+        s.bytes_allocated = c.bytes_allocated - start_.bytes_allocated;
+        s.bytes_freed = c.bytes_freed - start_.bytes_freed;
+        s.peak_bytes = c.peak - start_.current;
+        return s;
+    }
+
+    long long allocations() const { return stats().allocations; }
+
+private:
+    const std::string label_;
+    const allocation_detail::ThreadCounters start_;
+    const long long outer_peak_;
+};
+
+/*
+Explanation:
+"This move does not allocate" is a claim that printing from constructors cannot
+prove: the printing shows which special member ran, not what it cost. Counting the
+calls to the global allocation functions can.
+
+C++ lets a program replace the global `operator new`/`operator delete` (and their
+array and nothrow forms) by defining them once. The replacements here forward to
+`malloc`/`free` and count, per thread, the number of allocations and frees, the
+bytes, and the highest number of live bytes (peak). Every block carries its size in
+a 16-byte header, because unsized `operator delete(void*)` is not told how large
+the block was.
+
+`AllocationScope` snapshots the counters of the calling thread when it is created;
+`stats()` returns what happened since. It saves and restores the peak so that nested
+scopes each report their own. Per-thread counters need no atomics and are not
+disturbed by other threads (a block allocated in one thread and freed in another is
+counted as an allocation in the first and a free in the second).
+
+Typical checks in the examples:
+-   Moving a `std::vector`, `std::string` (longer than the small-string buffer) or
+    `std::unique_ptr` performs 0 allocations; copying them performs at least 1.
+-   `std::make_shared<T>()` performs 1 allocation, `std::shared_ptr<T>(new T)` 2.
+
+Because the header defines the global operators, include it in one .cpp file only.
+Allocations made before `main` (static initialization) are counted as well.
+
+Usage Example:
+```cpp
+std::vector<int> v(1000);
+{
+    AllocationScope copy_scope;
+    std::vector<int> copy = v;
+    if (copy_scope.allocations() != 1) std::cout << "unexpected allocation count" << std::endl;
+}
+{
+    AllocationScope scope("move");   // Prints "[move] 0 allocation(s), ..." at the end
+    std::vector<int> w = std::move(v);
+}
+```
+*/
@@ -0,0 +1,71 @@
+// contention.hpp
+// Small helpers shared by the lock-free and low-level synchronization headers.
+// - kFalseSharingPad: distance that keeps data written by different threads apart
+// - cpu_pause(): the CPU's spin-wait hint
+// - SpinBackoff: spin with cpu_pause() for a while, then yield the time slice
+#pragma once
+
+#include <cstddef>
+#include <thread> // For std::this_thread::yield
+
+// Two 64-byte cache lines, not one: the adjacent-line prefetcher of x86 CPUs fetches
+// lines in 128-byte pairs, so two fields written by different threads still
+// interfere when they are only 64 bytes apart. Used as a byte count for padding
+// arrays rather than through alignas, because operator new ignores over-alignment
+// before C++17.
+const std::size_t kFalseSharingPad = 128;
+
+// Tells the CPU that this is a spin-wait loop: it stops speculating ahead, saves
+// power and leaves the core to the SMT sibling for a few cycles.
+inline void cpu_pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Spins briefly (cheap when the wait is a few nanoseconds), then yields, so a waiting
+// thread does not starve the thread it waits for on an oversubscribed machine.
+class SpinBackoff {
+public:
+    void pause() {
+        if (spins_ < kSpins) {
+            ++spins_;
+            cpu_pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    static const unsigned kSpins = 64;
+    unsigned spins_ = 0;
+};
+
+/*
+Explanation:
+Every structure that threads write concurrently (queue indices, reader counters,
+per-thread slots) needs the same two things: its hot fields must not share a cache
+line with another thread's fields (false sharing turns independent writes into
+cache-line ping-pong between cores), and a thread that has to wait for another one
+should spin only briefly.
+
+-   `kFalseSharingPad` is 128 bytes. Padding a field or a struct to that size keeps
+    it apart from its neighbours even with the adjacent-line prefetcher.
+-   `cpu_pause()` is `pause` on x86 and `yield` on AArch64 (no-op elsewhere).
+-   `SpinBackoff` pauses 64 times and then calls `std::this_thread::yield()` on every
+    further call: without the yield, a waiter with more threads than cores can spin
+    through the whole time slice of the thread that would release it.
+
+Usage Example:
+```cpp
+struct PaddedCounter {
+    std::atomic<long> value{0};
+    char padding[kFalseSharingPad - sizeof(std::atomic<long>)];
+};
+
+SpinBackoff backoff;
+while (!flag.load(std::memory_order_acquire)) backoff.pause();
+```
+*/
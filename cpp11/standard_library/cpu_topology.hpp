@@ -0,0 +1,311 @@
+// cpu_topology.hpp
+// Which logical CPUs exist, which of them are SMT siblings on one physical core,
+// and which NUMA node they belong to (read from /sys/devices/system/cpu on Linux),
+// plus pinning of threads to CPUs by policy.
+// - CpuTopology::detect(): the CPUs this process may run on
+// - topology.placement(policy, n): CPU ids for n threads (compact, scatter, physical_cores)
+// - pin_current_thread(cpu), pin_thread(t, cpu), current_cpu()
+// - pinning_hook(topology, policy, n): pins ThreadPool workers (thread_pool.hpp)
+#pragma once
+
+#include <algorithm> // For std::sort, std::unique, std::max
+#include <fstream>
+#include <functional> // For std::function
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+enum class PinPolicy {
+    none,           // Let the scheduler decide
+    compact,        // Fill SMT siblings of a core, then the next core, then the next node
+    scatter,        // Spread over nodes and physical cores first, SMT siblings last
+    physical_cores  // One thread per physical core, never two on SMT siblings
+};
+
+inline const char* to_string(PinPolicy policy) {
+    switch (policy) {
+        case PinPolicy::none: return "none";
+        case PinPolicy::compact: return "compact";
+        case PinPolicy::scatter: return "scatter";
+        case PinPolicy::physical_cores: return "physical_cores";
+    }
+    return "?";
+}
+
+struct LogicalCpu {
+    int id;       // The number the kernel uses (cpuN)
+    int core;     // Physical core, numbered 0 .. physical_core_count() - 1 over the whole machine
+    int package;  // Socket
+    int node;     // NUMA node (0 if unknown)
+    int smt_rank; // 0 for the first hardware thread of its core, 1 for its sibling, ...
+};
+
+namespace topology_detail {
+
+// Parses a kernel CPU list such as "0-3,8,10-11".
+inline std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> ids;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        int lo = 0, hi = 0;
+        const std::size_t dash = item.find('-');
+        std::stringstream(item.substr(0, dash)) >> lo;
+        hi = lo;
+        if (dash != std::string::npos) std::stringstream(item.substr(dash + 1)) >> hi;
+        for (int c = lo; c <= hi; ++c) ids.push_back(c);
+    }
+    return ids;
+}
+
+inline bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path.c_str());
+    if (!in) return false;
+    std::getline(in, out);
+    return true;
+}
+
+inline bool read_int(const std::string& path, int& out) {
+    std::string text;
+    if (!read_file(path, text)) return false;
+    std::stringstream(text) >> out;
+    return true;
+}
+
+} // namespace topology_detail
+
+class CpuTopology {
+public:
+    // Reads the topology of the CPUs in this process's affinity mask (so cgroup and
+    // taskset restrictions are respected). Without sysfs every CPU is treated as its
+    // own core on node 0.
+    static CpuTopology detect() {
+        CpuTopology t;
+        std::vector<int> ids = allowed_cpus();
+        struct Raw { int id, core_id, package, node; };
+        std::vector<Raw> raw;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(ids[i]) + "/topology/";
+            Raw r = {ids[i], ids[i], 0, 0};
+            if (topology_detail::read_int(base + "core_id", r.core_id) &&
+                topology_detail::read_int(base + "physical_package_id", r.package)) {
+                t.from_sysfs_ = true;
+            }
+            raw.push_back(r);
+        }
+        // NUMA nodes: /sys/devices/system/node/nodeN/cpulist
+        for (int node = 0; node < 1024; ++node) {
+            std::string list;
+            if (!topology_detail::read_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", list)) {
+                if (node > 0) break; // Node numbers are usually dense; node0 may be missing without NUMA
+                continue;
+            }
+            const std::vector<int> node_cpus = topology_detail::parse_list(list);
+            for (std::size_t i = 0; i < raw.size(); ++i) {
+                if (std::find(node_cpus.begin(), node_cpus.end(), raw[i].id) != node_cpus.end()) raw[i].node = node;
+            }
+        }
+        // Number the physical cores (core_id is only unique within a package) and rank siblings.
+        std::sort(raw.begin(), raw.end(), [](const Raw& a, const Raw& b) {
+            if (a.package != b.package) return a.package < b.package;
+            if (a.core_id != b.core_id) return a.core_id < b.core_id;
+            return a.id < b.id;
+        });
+        int core = -1, rank = 0;
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            if (i == 0 || raw[i].package != raw[i - 1].package || raw[i].core_id != raw[i - 1].core_id) {
+                ++core;
+                rank = 0;
+            }
+            LogicalCpu cpu = {raw[i].id, core, raw[i].package, raw[i].node, rank++};
+            t.cpus_.push_back(cpu);
+        }
+        return t;
+    }
+
+    // Sorted by (package, core, SMT rank), i.e. siblings are adjacent.
+    const std::vector<LogicalCpu>& cpus() const { return cpus_; }
+    bool from_sysfs() const { return from_sysfs_; }
+
+    std::size_t logical_count() const { return cpus_.size(); }
+    std::size_t physical_core_count() const { return cpus_.empty() ? 0 : static_cast<std::size_t>(cpus_.back().core + 1); }
+    std::size_t node_count() const { return count_distinct(&LogicalCpu::node); }
+    std::size_t package_count() const { return count_distinct(&LogicalCpu::package); }
+
+    // Logical CPUs sharing a physical core with `cpu_id` (including itself).
+    std::vector<int> siblings(int cpu_id) const {
+        std::vector<int> result;
+        int core = -1;
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            if (cpus_[i].id == cpu_id) core = cpus_[i].core;
+        }
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            if (cpus_[i].core == core) result.push_back(cpus_[i].id);
+        }
+        return result;
+    }
+
+    // CPU ids for `threads` threads under `policy` (wrapping around if there are more
+    // threads than CPUs). Empty for PinPolicy::none.
+    std::vector<int> placement(PinPolicy policy, std::size_t threads) const {
+        std::vector<int> result;
+        if (policy == PinPolicy::none || cpus_.empty()) return result;
+        std::vector<LogicalCpu> order = cpus_;
+        if (policy == PinPolicy::physical_cores) {
+            order.erase(std::remove_if(order.begin(), order.end(),
+                                       [](const LogicalCpu& c) { return c.smt_rank != 0; }), order.end());
+        }
+        if (policy == PinPolicy::compact || policy == PinPolicy::physical_cores) {
+            std::stable_sort(order.begin(), order.end(), [](const LogicalCpu& a, const LogicalCpu& b) {
+                if (a.node != b.node) return a.node < b.node;
+                return a.core < b.core; // Siblings keep their order
+            });
+        } else {
+            // Rank of each core within its node, so that consecutive threads alternate
+            // between nodes, then between cores, and use SMT siblings last.
+            int max_node = 0;
+            for (std::size_t i = 0; i < cpus_.size(); ++i) max_node = std::max(max_node, cpus_[i].node);
+            std::vector<int> core_rank(physical_core_count(), 0);
+            std::vector<int> next_rank(static_cast<std::size_t>(max_node) + 1, 0);
+            for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                if (cpus_[i].smt_rank == 0) core_rank[cpus_[i].core] = next_rank[cpus_[i].node]++;
+            }
+            std::stable_sort(order.begin(), order.end(), [&core_rank](const LogicalCpu& a, const LogicalCpu& b) {
+                if (a.smt_rank != b.smt_rank) return a.smt_rank < b.smt_rank;
+                if (core_rank[a.core] != core_rank[b.core]) return core_rank[a.core] < core_rank[b.core];
+                return a.node < b.node;
+            });
+        }
+        for (std::size_t i = 0; i < threads; ++i) result.push_back(order[i % order.size()].id);
+        return result;
+    }
+
+    // e.g. "8 logical CPUs, 4 physical cores, 1 package(s), 1 NUMA node(s)"
+    std::string summary() const {
+        std::ostringstream out;
+        out << logical_count() << " logical CPUs, " << physical_core_count() << " physical cores, "
+            << package_count() << " package(s), " << node_count() << " NUMA node(s)";
+        if (!from_sysfs_) out << " (no sysfs topology, assuming no SMT)";
+        return out.str();
+    }
+
+private:
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> ids;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int c = 0; c < CPU_SETSIZE; ++c) {
+                if (CPU_ISSET(c, &set)) ids.push_back(c);
+            }
+        }
+#endif
+        if (ids.empty()) {
+            const unsigned n = std::thread::hardware_concurrency();
+            for (unsigned c = 0; c < (n == 0 ? 1 : n); ++c) ids.push_back(static_cast<int>(c));
+        }
+        return ids;
+    }
+
+    std::size_t count_distinct(int LogicalCpu::*field) const {
+        std::vector<int> values;
+        for (std::size_t i = 0; i < cpus_.size(); ++i) values.push_back(cpus_[i].*field);
+        std::sort(values.begin(), values.end());
+        return static_cast<std::size_t>(std::unique(values.begin(), values.end()) - values.begin());
+    }
+
+    std::vector<LogicalCpu> cpus_;
+    bool from_sysfs_ = false;
+};
+
+// Restricts the calling thread to one CPU. Returns false if that is not possible
+// (not Linux, CPU not allowed, ...); the thread then keeps running unpinned.
+inline bool pin_current_thread(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Pins an already running std::thread. Prefer pinning inside the thread at its start:
+// until this call the thread may already have run (and allocated memory) elsewhere.
+inline bool pin_thread(std::thread& t, int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(t.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)t;
+    (void)cpu;
+    return false;
+#endif
+}
+
+// The CPU the calling thread is running on right now, or -1 if unknown.
+inline int current_cpu() {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// A ThreadPool::WorkerStartHook that pins worker i to placement(policy, threads)[i].
+inline std::function<void(unsigned)> pinning_hook(const CpuTopology& topology, PinPolicy policy, unsigned threads) {
+    const std::vector<int> cpus = topology.placement(policy, threads);
+    if (cpus.empty()) return std::function<void(unsigned)>();
+    return [cpus](unsigned worker) { pin_current_thread(cpus[worker % cpus.size()]); };
+}
+
+/*
+Explanation:
+By default the scheduler may move a thread to another CPU at any time. That costs
+cache warmth, lets two busy threads land on SMT siblings of the same core (sharing
+its execution units and L1/L2 caches) while other cores idle, and makes run-to-run
+timings vary. Pinning fixes every thread to a CPU chosen with the topology in mind.
+
+The topology comes from sysfs:
+-   /sys/devices/system/cpu/cpuN/topology/core_id and physical_package_id tell which
+    logical CPUs are hardware threads (SMT siblings) of the same physical core.
+-   /sys/devices/system/node/nodeM/cpulist tells which CPUs belong to NUMA node M.
+Only CPUs in the process's affinity mask (`sched_getaffinity`) are considered.
+
+Policies for n threads:
+-   compact: as close together as possible (siblings first, then neighbouring cores
+    on the same node). Best when the threads share data, worst for bandwidth.
+-   scatter: as far apart as possible (alternating NUMA nodes and cores, siblings
+    only when every core has a thread). Best for memory-bandwidth-bound work.
+-   physical_cores: like compact, but never two threads on one core. Usually best
+    for compute-bound work, because SMT siblings compete for the same core.
+
+Pinning a thread from the inside (`pin_current_thread()` at the start of the thread
+function, or `pinning_hook()` for a `ThreadPool`) ensures that everything it
+allocates and first touches afterwards is placed near its CPU.
+`bench/bench_affinity.cpp` measures the effect on `sum_vector`-style workloads.
+
+Usage Example:
+```cpp
+CpuTopology topology = CpuTopology::detect();
+std::cout << topology.summary() << '\n';
+std::vector<int> cpus = topology.placement(PinPolicy::physical_cores, 4);
+std::thread t([&] { pin_current_thread(cpus[0]); std::cout << current_cpu() << '\n'; });
+t.join();
+ThreadPool pool(4, pinning_hook(topology, PinPolicy::scatter, 4));
+```
+*/
@@ -0,0 +1,1061 @@
+// dfa_regex.hpp
+// Regular expressions compiled to a Thompson NFA and matched by a lazily built DFA,
+// in linear time and constant stack depth, for hot paths where std::regex is too slow.
+// - DfaRegex: compiles an ECMAScript-style pattern; match() (whole text, like
+//   std::regex_match) and search() (first match, like std::regex_search)
+// - DfaMatch: positions of the whole match and of the capture groups
+// - DfaRegexIterator: all non-overlapping matches, like std::sregex_iterator
+// - DfaRegexOptions: case-insensitive matching, DFA cache size
+// Supported syntax: literals, `.`, classes (`[a-z_]`, `[^...]`, `\d \w \s \D \W \S`),
+// groups `(...)` and `(?:...)`, alternation `|`, `* + ? {n} {n,} {n,m}` (greedy or
+// lazy with a trailing `?`), anchors `^ $`. Backreferences, lookaround and `\b` need
+// backtracking and are rejected with std::regex_error.
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <map>
+#include <memory>     // For std::shared_ptr
+#include <regex>      // For std::regex_error (the same errors as std::regex)
+#include <string>
+#include <utility>    // For std::swap
+#include <vector>
+
+struct DfaRegexOptions {
+    DfaRegexOptions() : icase(false), max_dfa_states(4096) {}
+
+    bool icase;                 // Like std::regex_constants::icase (ASCII letters)
+    std::size_t max_dfa_states; // Per DFA; when full, the cache is flushed and rebuilt on demand
+};
+
+namespace dfa_regex_detail {
+
+typedef std::bitset<256> ByteSet;
+
+// Pattern syntax tree. Nodes live in one vector and refer to each other by index.
+struct Node {
+    enum Kind { kEmpty, kSet, kBegin, kEnd, kConcat, kAlt, kRepeat, kGroup };
+
+    explicit Node(Kind k) : kind(k), set(-1), min(0), max(0), greedy(true), group(-1) {}
+
+    Kind kind;
+    std::vector<int> children;
+    int set;     // kSet: index into Parser::sets
+    int min;     // kRepeat
+    int max;     // kRepeat: -1 for unbounded
+    bool greedy; // kRepeat
+    int group;   // kGroup: capture number, or -1 for (?:...)
+};
+
+class Parser {
+public:
+    Parser(const std::string& pattern, bool icase) : pattern_(pattern), pos_(0), icase_(icase), groups_(0) {}
+
+    // Returns the root node; throws std::regex_error on invalid or unsupported syntax.
+    int parse() {
+        const int root = parse_alternation(0);
+        if (pos_ != pattern_.size()) throw std::regex_error(std::regex_constants::error_paren); // Unmatched ')'
+        return root;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<ByteSet> sets;
+
+    int groups() const { return groups_; }
+
+private:
+    // Deeper nesting would only come from hostile patterns; the parser recurses per level.
+    static const int kMaxDepth = 1000;
+
+    bool at_end() const { return pos_ >= pattern_.size(); }
+    char peek() const { return pattern_[pos_]; }
+
+    int add(const Node& n) {
+        nodes.push_back(n);
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    int add_set(ByteSet s) {
+        Node n(Node::kSet);
+        n.set = static_cast<int>(sets.size());
+        sets.push_back(fold_case(s));
+        return add(n);
+    }
+
+    ByteSet fold_case(ByteSet s) const {
+        if (icase_) {
+            for (int c = 'a'; c <= 'z'; ++c) {
+                const int upper = c - 'a' + 'A';
+                if (s[c] || s[upper]) s.set(c).set(upper);
+            }
+        }
+        return s;
+    }
+
+    int parse_alternation(int depth) {
+        if (depth > kMaxDepth) throw std::regex_error(std::regex_constants::error_stack);
+        const int first = parse_concatenation(depth);
+        if (at_end() || peek() != '|') return first;
+        Node alt(Node::kAlt);
+        alt.children.push_back(first);
+        while (!at_end() && peek() == '|') {
+            ++pos_;
+            alt.children.push_back(parse_concatenation(depth));
+        }
+        return add(alt);
+    }
+
+    int parse_concatenation(int depth) {
+        Node concat(Node::kConcat);
+        while (!at_end() && peek() != '|' && peek() != ')') concat.children.push_back(parse_repeat(depth));
+        if (concat.children.empty()) return add(Node(Node::kEmpty));
+        if (concat.children.size() == 1) return concat.children[0];
+        return add(concat);
+    }
+
+    int parse_repeat(int depth) {
+        bool assertion = false;
+        int atom = parse_atom(depth, assertion);
+        while (!at_end()) {
+            int min, max;
+            const char c = peek();
+            if (c == '*') { min = 0; max = -1; ++pos_; }
+            else if (c == '+') { min = 1; max = -1; ++pos_; }
+            else if (c == '?') { min = 0; max = 1; ++pos_; }
+            else if (c == '{') { parse_braces(min, max); }
+            else break;
+            if (assertion) throw std::regex_error(std::regex_constants::error_badrepeat);
+            Node repeat(Node::kRepeat);
+            repeat.children.push_back(atom);
+            repeat.min = min;
+            repeat.max = max;
+            if (!at_end() && peek() == '?') {
+                repeat.greedy = false;
+                ++pos_;
+            }
+            atom = add(repeat);
+        }
+        return atom;
+    }
+
+    // {n}, {n,} or {n,m}; the '{' is at pos_.
+    void parse_braces(int& min, int& max) {
+        ++pos_;
+        min = parse_number();
+        max = min;
+        if (!at_end() && peek() == ',') {
+            ++pos_;
+            max = (!at_end() && peek() == '}') ? -1 : parse_number();
+        }
+        if (at_end() || peek() != '}') throw std::regex_error(std::regex_constants::error_brace);
+        ++pos_;
+        if (max != -1 && max < min) throw std::regex_error(std::regex_constants::error_badbrace);
+    }
+
+    int parse_number() {
+        if (at_end() || peek() < '0' || peek() > '9') throw std::regex_error(std::regex_constants::error_badbrace);
+        int n = 0;
+        while (!at_end() && peek() >= '0' && peek() <= '9') {
+            n = n * 10 + (peek() - '0');
+            if (n > 1000) throw std::regex_error(std::regex_constants::error_badbrace); // Would be copied n times
+            ++pos_;
+        }
+        return n;
+    }
+
+    int parse_atom(int depth, bool& assertion) {
+        const char c = peek();
+        ++pos_;
+        switch (c) {
+        case '(': {
+            Node group(Node::kGroup);
+            if (!at_end() && peek() == '?') {
+                if (pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] == ':') {
+                    pos_ += 2;
+                } else {
+                    throw std::regex_error(std::regex_constants::error_complexity); // Lookahead
+                }
+            } else {
+                group.group = ++groups_;
+            }
+            group.children.push_back(parse_alternation(depth + 1));
+            if (at_end() || peek() != ')') throw std::regex_error(std::regex_constants::error_paren);
+            ++pos_;
+            return add(group);
+        }
+        case ')':
+            throw std::regex_error(std::regex_constants::error_paren);
+        case '[':
+            return parse_class();
+        case '.': {
+            ByteSet s;
+            s.set();
+            s.reset('\n').reset('\r'); // ECMAScript: any character but a line terminator
+            return add_set(s);
+        }
+        case '^':
+            assertion = true;
+            return add(Node(Node::kBegin));
+        case '$':
+            assertion = true;
+            return add(Node(Node::kEnd));
+        case '*': case '+': case '?':
+            throw std::regex_error(std::regex_constants::error_badrepeat);
+        case '{':
+            throw std::regex_error(std::regex_constants::error_badbrace);
+        case '\\': {
+            ByteSet s;
+            parse_escape(s, false);
+            return add_set(s);
+        }
+        default: {
+            ByteSet s;
+            s.set(static_cast<unsigned char>(c));
+            return add_set(s);
+        }
+        }
+    }
+
+    // [...] with ranges, negation and escapes; the '[' was consumed.
+    int parse_class() {
+        ByteSet s;
+        bool negate = false;
+        if (!at_end() && peek() == '^') {
+            negate = true;
+            ++pos_;
+        }
+        while (!at_end() && peek() != ']') {
+            ByteSet item;
+            int low = parse_class_atom(item);
+            if (low >= 0 && pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+                ++pos_;
+                ByteSet ignored;
+                const int high = parse_class_atom(ignored);
+                if (high < 0 || high < low) throw std::regex_error(std::regex_constants::error_range);
+                for (int b = low; b <= high; ++b) s.set(static_cast<std::size_t>(b));
+            } else {
+                s |= item;
+            }
+        }
+        if (at_end()) throw std::regex_error(std::regex_constants::error_brack);
+        ++pos_;
+        s = fold_case(s); // Before negating: [^a] must exclude 'A' too
+        if (negate) s.flip();
+        return add_set(s);
+    }
+
+    // One class member into `item`. Returns its byte, or -1 for a shorthand like \d.
+    int parse_class_atom(ByteSet& item) {
+        const char c = peek();
+        ++pos_;
+        if (c != '\\') {
+            item.set(static_cast<unsigned char>(c));
+            return static_cast<unsigned char>(c);
+        }
+        return parse_escape(item, true);
+    }
+
+    // The character after a backslash. Returns the byte for a single character, -1
+    // for a shorthand class.
+    int parse_escape(ByteSet& s, bool in_class) {
+        if (at_end()) throw std::regex_error(std::regex_constants::error_escape);
+        const char c = peek();
+        ++pos_;
+        int byte = -1;
+        switch (c) {
+        case 'd': case 'D': case 'w': case 'W': case 's': case 'S': {
+            ByteSet shorthand;
+            const char lower = static_cast<char>(c | 0x20);
+            for (int b = 0; b < 256; ++b) {
+                const bool digit = b >= '0' && b <= '9';
+                const bool word = digit || (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || b == '_';
+                const bool space = b == ' ' || (b >= '\t' && b <= '\r');
+                if (lower == 'd' ? digit : lower == 'w' ? word : space) shorthand.set(static_cast<std::size_t>(b));
+            }
+            if (c != lower) shorthand.flip();
+            s |= shorthand;
+            return -1;
+        }
+        case 'n': byte = '\n'; break;
+        case 'r': byte = '\r'; break;
+        case 't': byte = '\t'; break;
+        case 'f': byte = '\f'; break;
+        case 'v': byte = '\v'; break;
+        case '0': byte = 0; break;
+        case 'x': byte = parse_hex(); break;
+        case 'b':
+            if (!in_class) throw std::regex_error(std::regex_constants::error_complexity); // Word boundary
+            byte = '\b';
+            break;
+        case 'B':
+            throw std::regex_error(std::regex_constants::error_complexity);
+        default:
+            if (c >= '1' && c <= '9') throw std::regex_error(std::regex_constants::error_backref);
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) throw std::regex_error(std::regex_constants::error_escape);
+            byte = static_cast<unsigned char>(c); // Escaped punctuation stands for itself
+        }
+        s.set(static_cast<std::size_t>(byte));
+        return byte;
+    }
+
+    int parse_hex() {
+        int value = 0;
+        for (int i = 0; i < 2; ++i) {
+            if (at_end()) throw std::regex_error(std::regex_constants::error_escape);
+            const char h = peek();
+            ++pos_;
+            if (h >= '0' && h <= '9') value = value * 16 + (h - '0');
+            else if (h >= 'a' && h <= 'f') value = value * 16 + (h - 'a' + 10);
+            else if (h >= 'A' && h <= 'F') value = value * 16 + (h - 'A' + 10);
+            else throw std::regex_error(std::regex_constants::error_escape);
+        }
+        return value;
+    }
+
+    const std::string& pattern_;
+    std::size_t pos_;
+    bool icase_;
+    int groups_;
+};
+
+// NFA instructions (Thompson construction, in the style of a Pike VM program).
+enum Op { kByteSet, kSplit, kJump, kSave, kAssertBegin, kAssertEnd, kMatch };
+
+struct Inst {
+    Op op;
+    int x;   // Next instruction (kSplit: the preferred one)
+    int y;   // kSplit: the other one
+    int arg; // kByteSet: set index; kSave: capture slot
+};
+
+typedef std::vector<Inst> Program;
+
+// Emits the program for a syntax tree. The reverse program matches the reversed
+// language (concatenations backwards) and has no captures; it finds where a match
+// starts, given where it ends.
+class Compiler {
+public:
+    Compiler(const std::vector<Node>& nodes, bool reverse) : nodes_(nodes), reverse_(reverse) {}
+
+    Program compile(int root) {
+        if (!reverse_) emit(kSave, 0);
+        node(root);
+        if (!reverse_) emit(kSave, 1);
+        emit(kMatch, 0);
+        return program_;
+    }
+
+private:
+    // {n,m} copies its operand, so nested counted repeats could explode.
+    static const std::size_t kMaxProgram = 100000;
+
+    int emit(Op op, int arg) {
+        if (program_.size() >= kMaxProgram) throw std::regex_error(std::regex_constants::error_space);
+        Inst inst = {op, static_cast<int>(program_.size()) + 1, -1, arg};
+        program_.push_back(inst);
+        return static_cast<int>(program_.size()) - 1;
+    }
+
+    int here() const { return static_cast<int>(program_.size()); }
+
+    void node(int index) {
+        const Node& n = nodes_[static_cast<std::size_t>(index)];
+        switch (n.kind) {
+        case Node::kEmpty:
+            break;
+        case Node::kSet:
+            emit(kByteSet, n.set);
+            break;
+        case Node::kBegin:
+            emit(kAssertBegin, 0);
+            break;
+        case Node::kEnd:
+            emit(kAssertEnd, 0);
+            break;
+        case Node::kConcat:
+            if (reverse_) {
+                for (std::size_t i = n.children.size(); i-- > 0;) node(n.children[i]);
+            } else {
+                for (std::size_t i = 0; i < n.children.size(); ++i) node(n.children[i]);
+            }
+            break;
+        case Node::kAlt: {
+            // split L1, next; L1: a; jump end; next: split L2, ... ; last alternative
+            std::vector<int> jumps;
+            for (std::size_t i = 0; i + 1 < n.children.size(); ++i) {
+                const int split = emit(kSplit, 0);
+                node(n.children[i]);
+                jumps.push_back(emit(kJump, 0));
+                program_[static_cast<std::size_t>(split)].y = here();
+            }
+            node(n.children.back());
+            for (std::size_t i = 0; i < jumps.size(); ++i) program_[static_cast<std::size_t>(jumps[i])].x = here();
+            break;
+        }
+        case Node::kGroup:
+            if (!reverse_ && n.group >= 0) emit(kSave, 2 * n.group);
+            node(n.children[0]);
+            if (!reverse_ && n.group >= 0) emit(kSave, 2 * n.group + 1);
+            break;
+        case Node::kRepeat:
+            repeat(n);
+            break;
+        }
+    }
+
+    // x{min,max}: min copies, then either a loop or (max - min) nested optional copies,
+    // x(x(x)?)? rather than x?x?x?, so a thread never has several ways to skip.
+    void repeat(const Node& n) {
+        for (int i = 0; i < n.min; ++i) node(n.children[0]);
+        if (n.max == -1) {
+            const int split = emit(kSplit, 0);
+            node(n.children[0]);
+            const int jump = emit(kJump, 0);
+            program_[static_cast<std::size_t>(jump)].x = split;
+            prefer(split, split + 1, here(), n.greedy);
+            return;
+        }
+        std::vector<int> splits;
+        for (int i = n.min; i < n.max; ++i) {
+            splits.push_back(emit(kSplit, 0));
+            node(n.children[0]);
+        }
+        for (std::size_t i = 0; i < splits.size(); ++i) prefer(splits[i], splits[i] + 1, here(), n.greedy);
+    }
+
+    // Greedy repeats prefer another iteration, lazy ones prefer to stop.
+    void prefer(int split, int body, int out, bool greedy) {
+        Inst& inst = program_[static_cast<std::size_t>(split)];
+        inst.x = greedy ? body : out;
+        inst.y = greedy ? out : body;
+    }
+
+    const std::vector<Node>& nodes_;
+    bool reverse_;
+    Program program_;
+};
+
+// Everything a compiled pattern shares between copies of a DfaRegex.
+struct Compiled {
+    std::vector<ByteSet> sets;
+    Program forward;
+    Program reverse;
+    int groups;
+    // Bytes no byte set distinguishes share a class, so DFA states need one
+    // transition per class instead of 256 (a typical pattern has fewer than 20).
+    unsigned char class_of[256];
+    int classes;
+    std::vector<unsigned char> set_has_class; // [set * classes + class]
+};
+
+inline void compute_byte_classes(Compiled& c) {
+    std::vector<int> cls(256, 0);
+    int count = 1;
+    for (std::size_t s = 0; s < c.sets.size(); ++s) {
+        // Split every class into its bytes inside and outside the set.
+        std::map<std::pair<int, bool>, int> renumber;
+        for (int b = 0; b < 256; ++b) {
+            const std::pair<int, bool> key(cls[static_cast<std::size_t>(b)], c.sets[s][static_cast<std::size_t>(b)]);
+            std::map<std::pair<int, bool>, int>::iterator it = renumber.find(key);
+            if (it == renumber.end()) it = renumber.insert(std::make_pair(key, static_cast<int>(renumber.size()))).first;
+            cls[static_cast<std::size_t>(b)] = it->second;
+        }
+        count = static_cast<int>(renumber.size());
+    }
+    c.classes = count;
+    for (int b = 0; b < 256; ++b) c.class_of[b] = static_cast<unsigned char>(cls[static_cast<std::size_t>(b)]);
+    c.set_has_class.assign(c.sets.size() * static_cast<std::size_t>(count), 0);
+    for (std::size_t s = 0; s < c.sets.size(); ++s) {
+        for (int b = 0; b < 256; ++b) {
+            if (c.sets[s][static_cast<std::size_t>(b)]) c.set_has_class[s * static_cast<std::size_t>(count) + cls[static_cast<std::size_t>(b)]] = 1;
+        }
+    }
+}
+
+// A DFA over one program, built state by state while matching. A state is the
+// ordered list of NFA threads (instructions waiting for a byte, pending anchors,
+// Match) reachable at a position; its transition per byte class is computed on
+// first use and then cached, so each input byte costs one table lookup.
+//
+// Anchors: the "start" anchor (^ forwards, $ in the reverse program, which runs from
+// the end of the match) can only hold where the scan begins, so it is resolved when
+// the start state is built. The "final" anchor can only hold at the end of the
+// scanned range; its threads stay in the state and are resolved by final_match().
+class LazyDfa {
+public:
+    enum Kind {
+        kLeftmostFirst, // Unanchored search; Match cuts lower-priority threads (std::regex_search semantics)
+        kAllMatches     // Anchored; every thread runs (does any match end here?)
+    };
+
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    LazyDfa(std::shared_ptr<const Compiled> compiled, bool reverse, Kind kind, std::size_t max_states)
+        : compiled_(compiled), program_(reverse ? &compiled->reverse : &compiled->forward), kind_(kind),
+          start_op_(reverse ? kAssertEnd : kAssertBegin), final_op_(reverse ? kAssertBegin : kAssertEnd),
+          max_states_(max_states < 2 ? 2 : max_states), resets_(0), generation_(0) {
+        flush();
+    }
+
+    // kLeftmostFirst: end of the leftmost-first match starting at or after `from`,
+    // or npos. With `any_end`, returns as soon as some match is known to exist.
+    std::size_t search_end(const unsigned char* text, std::size_t size, std::size_t from, bool any_end) {
+        int s = start_state(from == 0, from == size);
+        std::size_t last = npos;
+        if (flags_[static_cast<std::size_t>(s)] & kMatchFlag) {
+            last = from;
+            if (any_end) return last;
+        }
+        for (std::size_t p = from; p < size; ++p) {
+            s = step(s, text[p]);
+            if (s == kDead) return last;
+            if (flags_[static_cast<std::size_t>(s)] & kMatchFlag) {
+                last = p + 1;
+                if (any_end) return last;
+            }
+        }
+        if (final_match(s)) last = size;
+        return last;
+    }
+
+    // kAllMatches, forward: does the whole text match?
+    bool full_match(const unsigned char* text, std::size_t size) {
+        int s = start_state(true, size == 0);
+        for (std::size_t p = 0; p < size; ++p) {
+            s = step(s, text[p]);
+            if (s == kDead) return false;
+        }
+        return (flags_[static_cast<std::size_t>(s)] & kMatchFlag) || final_match(s);
+    }
+
+    // kAllMatches, reverse program: the smallest start in [from, end] of a match
+    // that ends at `end`, or npos.
+    std::size_t leftmost_start(const unsigned char* text, std::size_t size, std::size_t from, std::size_t end) {
+        int s = start_state(end == size, end == 0);
+        std::size_t best = (flags_[static_cast<std::size_t>(s)] & kMatchFlag) ? end : npos;
+        for (std::size_t p = end; p > from; --p) {
+            s = step(s, text[p - 1]);
+            if (s == kDead) return best;
+            if (flags_[static_cast<std::size_t>(s)] & kMatchFlag) best = p - 1;
+        }
+        if (from == 0 && final_match(s)) best = 0;
+        return best;
+    }
+
+    std::size_t states() const { return pcs_.size(); }
+    std::size_t resets() const { return resets_; }
+
+private:
+    static const int kUnknown = -1;
+    static const int kDead = -2;
+    static const std::size_t kNoSlot = static_cast<std::size_t>(-1);
+    static const unsigned char kMatchFlag = 1;
+    static const unsigned char kRestartFlag = 2; // Unanchored: a new thread starts at every position
+
+    int step(int s, unsigned char byte) {
+        const int c = compiled_->class_of[byte];
+        const int next = next_[static_cast<std::size_t>(s) * static_cast<std::size_t>(compiled_->classes) + static_cast<std::size_t>(c)];
+        return next != kUnknown ? next : compute(s, c);
+    }
+
+    void flush() {
+        pcs_.clear();
+        flags_.clear();
+        next_.clear();
+        final_.clear();
+        index_.clear();
+        for (int i = 0; i < 4; ++i) start_[i] = kUnknown;
+    }
+
+    int start_state(bool start_ok, bool final_ok) {
+        int& cached = start_[(start_ok ? 2 : 0) + (final_ok ? 1 : 0)];
+        if (cached != kUnknown && cached < static_cast<int>(pcs_.size())) return cached;
+        std::vector<int> pcs;
+        begin_closures();
+        const bool matched = closure(0, start_ok, final_ok, pcs);
+        const unsigned char flags = static_cast<unsigned char>((matched ? kMatchFlag : 0) |
+                                                               (kind_ == kLeftmostFirst && !matched ? kRestartFlag : 0));
+        // The start state exists even if no thread survives (a scan must start somewhere).
+        return cached = intern(pcs, flags, kNoSlot, false);
+    }
+
+    // Successor of state s for byte class c.
+    int compute(int s, int c) {
+        std::vector<int> pcs;
+        bool matched = false;
+        begin_closures();
+        const std::vector<int>& from = pcs_[static_cast<std::size_t>(s)];
+        for (std::size_t i = 0; i < from.size(); ++i) {
+            const Inst& inst = (*program_)[static_cast<std::size_t>(from[i])];
+            if (inst.op != kByteSet) continue;
+            if (!compiled_->set_has_class[static_cast<std::size_t>(inst.arg) * static_cast<std::size_t>(compiled_->classes) + static_cast<std::size_t>(c)]) continue;
+            if (closure(inst.x, false, false, pcs)) {
+                matched = true;
+                if (kind_ == kLeftmostFirst) break;
+            }
+        }
+        // Threads starting here have the lowest priority and stop once a match is found.
+        bool restart = (flags_[static_cast<std::size_t>(s)] & kRestartFlag) && !matched;
+        if (restart && closure(0, false, false, pcs)) {
+            matched = true;
+            restart = false;
+        }
+        const unsigned char flags = static_cast<unsigned char>((matched ? kMatchFlag : 0) | (restart ? kRestartFlag : 0));
+        return intern(pcs, flags, static_cast<std::size_t>(s) * static_cast<std::size_t>(compiled_->classes) + static_cast<std::size_t>(c), true);
+    }
+
+    // The state for (pcs, flags), created if needed; the transition at `slot` (or
+    // kNoSlot) is set to it. A state without threads is kDead if `allow_dead`.
+    int intern(const std::vector<int>& pcs, unsigned char flags, std::size_t slot, bool allow_dead) {
+        const bool has_slot = slot != kNoSlot;
+        if (allow_dead && pcs.empty() && !(flags & kRestartFlag)) {
+            if (has_slot) next_[slot] = kDead;
+            return kDead;
+        }
+        std::vector<int> key(pcs);
+        key.push_back(flags);
+        std::map<std::vector<int>, int>::iterator it = index_.find(key);
+        if (it != index_.end()) {
+            if (has_slot) next_[slot] = it->second;
+            return it->second;
+        }
+        if (pcs_.size() >= max_states_) {
+            // Out of room: start over. The transition being computed belongs to a
+            // state that no longer exists, so it is not recorded.
+            ++resets_;
+            flush();
+            return add_state(key, pcs, flags);
+        }
+        const int s = add_state(key, pcs, flags);
+        if (has_slot) next_[slot] = s;
+        return s;
+    }
+
+    int add_state(const std::vector<int>& key, const std::vector<int>& pcs, unsigned char flags) {
+        const int s = static_cast<int>(pcs_.size());
+        pcs_.push_back(pcs);
+        flags_.push_back(flags);
+        next_.resize(next_.size() + static_cast<std::size_t>(compiled_->classes), int(kUnknown));
+        final_.push_back(-1);
+        index_.insert(std::make_pair(key, s));
+        return s;
+    }
+
+    // Does a match end at the end of the scanned range, through a pending final anchor?
+    bool final_match(int s) {
+        signed char& cached = final_[static_cast<std::size_t>(s)];
+        if (cached >= 0) return cached != 0;
+        bool matched = false;
+        std::vector<int> pcs;
+        begin_closures();
+        const std::vector<int>& from = pcs_[static_cast<std::size_t>(s)];
+        for (std::size_t i = 0; i < from.size() && !matched; ++i) {
+            const Inst& inst = (*program_)[static_cast<std::size_t>(from[i])];
+            if (inst.op == kMatch) matched = true;
+            else if (inst.op == final_op_) matched = closure(inst.x, false, true, pcs);
+        }
+        cached = matched ? 1 : 0;
+        return matched;
+    }
+
+    void begin_closures() {
+        if (mark_.size() != program_->size()) mark_.assign(program_->size(), 0);
+        if (++generation_ == 0) { // Wrapped: old marks could look current
+            mark_.assign(program_->size(), 0);
+            generation_ = 1;
+        }
+    }
+
+    // Appends the threads reachable from `pc` without consuming a byte to `out`, in
+    // priority order, skipping instructions already added since begin_closures().
+    // Returns true if Match was reached; for kLeftmostFirst nothing after it is added.
+    bool closure(int pc, bool start_ok, bool final_ok, std::vector<int>& out) {
+        bool matched = false;
+        stack_.clear();
+        stack_.push_back(pc);
+        while (!stack_.empty()) {
+            const int i = stack_.back();
+            stack_.pop_back();
+            if (mark_[static_cast<std::size_t>(i)] == generation_) continue;
+            mark_[static_cast<std::size_t>(i)] = generation_;
+            const Inst& inst = (*program_)[static_cast<std::size_t>(i)];
+            switch (inst.op) {
+            case kByteSet:
+                out.push_back(i);
+                break;
+            case kSplit:
+                stack_.push_back(inst.y);
+                stack_.push_back(inst.x);
+                break;
+            case kJump:
+            case kSave:
+                stack_.push_back(inst.x);
+                break;
+            case kAssertBegin:
+            case kAssertEnd:
+                if (inst.op == start_op_ ? start_ok : final_ok) stack_.push_back(inst.x);
+                else if (inst.op == final_op_) out.push_back(i); // May hold at the end of the range
+                break;
+            case kMatch:
+                out.push_back(i);
+                matched = true;
+                if (kind_ == kLeftmostFirst) {
+                    stack_.clear();
+                    return true;
+                }
+                break;
+            }
+        }
+        return matched;
+    }
+
+    std::shared_ptr<const Compiled> compiled_;
+    const Program* program_;
+    Kind kind_;
+    Op start_op_;
+    Op final_op_;
+    std::size_t max_states_;
+    std::size_t resets_;
+
+    std::vector<std::vector<int> > pcs_;  // Per state: its threads
+    std::vector<unsigned char> flags_;    // Per state: kMatchFlag, kRestartFlag
+    std::vector<int> next_;               // [state * classes + class]: successor, kUnknown or kDead
+    std::vector<signed char> final_;      // Per state: final_match() result, -1 unknown
+    std::map<std::vector<int>, int> index_;
+    int start_[4];
+
+    std::vector<unsigned> mark_;
+    unsigned generation_;
+    std::vector<int> stack_;
+};
+
+// Pike VM: simulates the NFA with one thread per instruction, each carrying its
+// capture positions. Slower than the DFA per byte, so it only runs over the span
+// the DFAs already found, to fill in the groups.
+class PikeVm {
+public:
+    explicit PikeVm(std::shared_ptr<const Compiled> compiled) : compiled_(compiled) {}
+
+    // Captures of the highest-priority thread that starts at `start` and matches
+    // exactly text[start, end). `caps` gets 2 * (groups + 1) positions, -1 if unset.
+    bool run(const unsigned char* text, std::size_t size, std::size_t start, std::size_t end,
+             std::vector<std::ptrdiff_t>& caps) {
+        const Program& program = compiled_->forward;
+        const std::size_t slots = 2 * (static_cast<std::size_t>(compiled_->groups) + 1);
+        current_.reset(program.size(), slots);
+        next_.reset(program.size(), slots);
+        std::vector<std::ptrdiff_t> initial(slots, -1);
+        add_thread(current_, 0, initial.data(), start, size);
+        for (std::size_t p = start;; ++p) {
+            if (p == end) {
+                for (std::size_t i = 0; i < current_.pcs.size(); ++i) {
+                    const int pc = current_.pcs[i];
+                    if (program[static_cast<std::size_t>(pc)].op != kMatch) continue;
+                    const std::ptrdiff_t* found = current_.caps_of(pc);
+                    caps.assign(found, found + slots);
+                    return true;
+                }
+                return false;
+            }
+            next_.clear();
+            for (std::size_t i = 0; i < current_.pcs.size(); ++i) {
+                const int pc = current_.pcs[i];
+                const Inst& inst = program[static_cast<std::size_t>(pc)];
+                if (inst.op != kByteSet) continue; // A Match before `end` is not the one sought
+                if (!compiled_->sets[static_cast<std::size_t>(inst.arg)][text[p]]) continue;
+                add_thread(next_, inst.x, current_.caps_of(pc), p + 1, size);
+            }
+            std::swap(current_, next_);
+            if (current_.pcs.empty()) return false;
+        }
+    }
+
+private:
+    // Threads in priority order, at most one per instruction (sparse set).
+    struct Threads {
+        std::vector<int> pcs;
+        std::vector<int> index;             // pc -> position in pcs, valid if pcs[index[pc]] == pc
+        std::vector<std::ptrdiff_t> caps;   // [pc * slots + slot]
+        std::size_t slots;
+
+        // Stale entries need no clearing: contains() checks pcs, and caps are
+        // written whenever a thread is inserted.
+        void reset(std::size_t program_size, std::size_t s) {
+            slots = s;
+            pcs.clear();
+            if (index.size() != program_size) index.assign(program_size, 0);
+            if (caps.size() != program_size * s) caps.assign(program_size * s, -1);
+        }
+        void clear() { pcs.clear(); }
+        bool contains(int pc) const {
+            const std::size_t i = static_cast<std::size_t>(index[static_cast<std::size_t>(pc)]);
+            return i < pcs.size() && pcs[i] == pc;
+        }
+        void insert(int pc) {
+            index[static_cast<std::size_t>(pc)] = static_cast<int>(pcs.size());
+            pcs.push_back(pc);
+        }
+        std::ptrdiff_t* caps_of(int pc) { return &caps[static_cast<std::size_t>(pc) * slots]; }
+    };
+
+    struct Frame {
+        int pc;
+        int restore_slot; // >= 0: undo a Save on the way back instead of visiting pc
+        std::ptrdiff_t value;
+    };
+
+    // Follows jumps, splits, saves and anchors from `pc` at position `pos` and adds
+    // the threads waiting for a byte (or matching) to `list`. `caps` is modified
+    // while exploring and restored before returning.
+    void add_thread(Threads& list, int pc0, std::ptrdiff_t* caps, std::size_t pos, std::size_t size) {
+        const Program& program = compiled_->forward;
+        Frame first = {pc0, -1, 0};
+        stack_.clear();
+        stack_.push_back(first);
+        while (!stack_.empty()) {
+            const Frame f = stack_.back();
+            stack_.pop_back();
+            if (f.restore_slot >= 0) {
+                caps[f.restore_slot] = f.value;
+                continue;
+            }
+            if (list.contains(f.pc)) continue;
+            list.insert(f.pc);
+            const Inst& inst = program[static_cast<std::size_t>(f.pc)];
+            switch (inst.op) {
+            case kJump:
+                push(inst.x);
+                break;
+            case kSplit:
+                push(inst.y);
+                push(inst.x);
+                break;
+            case kSave: {
+                Frame restore = {0, inst.arg, caps[inst.arg]};
+                stack_.push_back(restore);
+                caps[inst.arg] = static_cast<std::ptrdiff_t>(pos);
+                push(inst.x);
+                break;
+            }
+            case kAssertBegin:
+                if (pos == 0) push(inst.x);
+                break;
+            case kAssertEnd:
+                if (pos == size) push(inst.x);
+                break;
+            case kByteSet:
+            case kMatch: {
+                std::ptrdiff_t* dst = list.caps_of(f.pc);
+                for (std::size_t i = 0; i < list.slots; ++i) dst[i] = caps[i];
+                break;
+            }
+            }
+        }
+    }
+
+    void push(int pc) {
+        Frame f = {pc, -1, 0};
+        stack_.push_back(f);
+    }
+
+    std::shared_ptr<const Compiled> compiled_;
+    Threads current_, next_;
+    std::vector<Frame> stack_;
+};
+
+} // namespace dfa_regex_detail
+
+// Result of DfaRegex::match()/search(): offsets into the searched string, which must
+// outlive it (as with std::smatch).
+class DfaMatch {
+public:
+    DfaMatch() : text_(nullptr) {}
+
+    bool empty() const { return groups_.empty(); } // No match
+    std::size_t size() const { return groups_.size() / 2; } // Groups + 1 (the whole match)
+
+    bool matched(std::size_t i = 0) const { return i < size() && groups_[2 * i] >= 0; }
+    std::size_t position(std::size_t i = 0) const { return matched(i) ? static_cast<std::size_t>(groups_[2 * i]) : std::string::npos; }
+    std::size_t length(std::size_t i = 0) const { return matched(i) ? static_cast<std::size_t>(groups_[2 * i + 1] - groups_[2 * i]) : 0; }
+    std::string str(std::size_t i = 0) const { return matched(i) ? text_->substr(position(i), length(i)) : std::string(); }
+    std::string prefix() const { return empty() ? std::string() : text_->substr(0, position()); }
+    std::string suffix() const { return empty() ? std::string() : text_->substr(position() + length()); }
+
+private:
+    friend class DfaRegex;
+
+    const std::string* text_;
+    std::vector<std::ptrdiff_t> groups_; // Begin and end per group, -1 if the group did not participate
+};
+
+class DfaRegex {
+public:
+    // Throws std::regex_error, with the codes std::regex uses, for invalid patterns
+    // and for features this engine does not support.
+    explicit DfaRegex(const std::string& pattern, const DfaRegexOptions& options = DfaRegexOptions())
+        : pattern_(pattern), compiled_(compile(pattern, options.icase)),
+          search_(compiled_, false, dfa_regex_detail::LazyDfa::kLeftmostFirst, options.max_dfa_states),
+          anchored_(compiled_, false, dfa_regex_detail::LazyDfa::kAllMatches, options.max_dfa_states),
+          reverse_(compiled_, true, dfa_regex_detail::LazyDfa::kAllMatches, options.max_dfa_states),
+          pike_(compiled_) {}
+
+    const std::string& pattern() const { return pattern_; }
+    std::size_t mark_count() const { return static_cast<std::size_t>(compiled_->groups); } // Capture groups
+
+    // Like std::regex_match: does the whole text match?
+    bool match(const std::string& text) { return anchored_.full_match(bytes(text), text.size()); }
+
+    bool match(const std::string& text, DfaMatch& m) {
+        m.text_ = &text;
+        m.groups_.clear();
+        if (!match(text)) return false;
+        fill_groups(text, 0, text.size(), m);
+        return true;
+    }
+
+    // `m` refers into the text, so a temporary would leave it dangling (as with
+    // std::regex_match and std::smatch).
+    bool match(const std::string&&, DfaMatch&) = delete;
+
+    // Like std::regex_search: is there a match starting at or after `from`?
+    bool search(const std::string& text, std::size_t from = 0) {
+        return from <= text.size() && search_.search_end(bytes(text), text.size(), from, true) != npos;
+    }
+
+    // The leftmost match starting at or after `from` (among matches starting at the
+    // same position, the one std::regex_search would pick). `^` only matches at 0.
+    bool search(const std::string& text, DfaMatch& m, std::size_t from = 0) {
+        m.text_ = &text;
+        m.groups_.clear();
+        if (from > text.size()) return false;
+        const std::size_t end = search_.search_end(bytes(text), text.size(), from, false);
+        if (end == npos) return false;
+        const std::size_t start = reverse_.leftmost_start(bytes(text), text.size(), from, end);
+        fill_groups(text, start, end, m);
+        return true;
+    }
+
+    bool search(const std::string&&, DfaMatch&, std::size_t = 0) = delete;
+
+    // DFA states built so far and cache flushes (memory use, and whether the cache
+    // is big enough for the pattern and input).
+    std::size_t dfa_states() const { return search_.states() + anchored_.states() + reverse_.states(); }
+    std::size_t dfa_cache_resets() const { return search_.resets() + anchored_.resets() + reverse_.resets(); }
+
+private:
+    static const std::size_t npos = dfa_regex_detail::LazyDfa::npos;
+
+    static std::shared_ptr<const dfa_regex_detail::Compiled> compile(const std::string& pattern, bool icase) {
+        using namespace dfa_regex_detail;
+        Parser parser(pattern, icase);
+        const int root = parser.parse();
+        std::shared_ptr<Compiled> c(new Compiled);
+        c->forward = Compiler(parser.nodes, false).compile(root);
+        c->reverse = Compiler(parser.nodes, true).compile(root);
+        c->sets.swap(parser.sets);
+        c->groups = parser.groups();
+        compute_byte_classes(*c);
+        return c;
+    }
+
+    static const unsigned char* bytes(const std::string& text) { return reinterpret_cast<const unsigned char*>(text.data()); }
+
+    void fill_groups(const std::string& text, std::size_t start, std::size_t end, DfaMatch& m) {
+        if (compiled_->groups > 0 && pike_.run(bytes(text), text.size(), start, end, m.groups_)) return;
+        m.groups_.assign(2, -1);
+        m.groups_[0] = static_cast<std::ptrdiff_t>(start);
+        m.groups_[1] = static_cast<std::ptrdiff_t>(end);
+    }
+
+    std::string pattern_;
+    std::shared_ptr<const dfa_regex_detail::Compiled> compiled_;
+    dfa_regex_detail::LazyDfa search_;   // Forward, unanchored: where the leftmost match ends
+    dfa_regex_detail::LazyDfa anchored_; // Forward, anchored: whole-text matches
+    dfa_regex_detail::LazyDfa reverse_;  // Backwards from a match end: where it starts
+    dfa_regex_detail::PikeVm pike_;      // Capture groups within a known match
+};
+
+// All non-overlapping matches in a string, like std::sregex_iterator. After an empty
+// match the next search starts one byte further (std::regex would first look for a
+// non-empty match at the same position).
+class DfaRegexIterator {
+public:
+    DfaRegexIterator() : regex_(nullptr), text_(nullptr) {} // End of sequence
+
+    DfaRegexIterator(const std::string& text, DfaRegex& regex) : regex_(&regex), text_(&text) { next(0); }
+    DfaRegexIterator(const std::string&&, DfaRegex&) = delete; // Would point into a temporary
+
+    const DfaMatch& operator*() const { return match_; }
+    const DfaMatch* operator->() const { return &match_; }
+
+    DfaRegexIterator& operator++() {
+        const std::size_t end = match_.position() + match_.length();
+        next(match_.length() == 0 ? end + 1 : end);
+        return *this;
+    }
+
+    bool operator==(const DfaRegexIterator& other) const {
+        if (regex_ == nullptr || other.regex_ == nullptr) return regex_ == other.regex_;
+        return text_ == other.text_ && match_.position() == other.match_.position();
+    }
+    bool operator!=(const DfaRegexIterator& other) const { return !(*this == other); }
+
+private:
+    void next(std::size_t from) {
+        if (!regex_->search(*text_, match_, from)) regex_ = nullptr;
+    }
+
+    DfaRegex* regex_; // Non-const: matching fills the regex's DFA caches
+    const std::string* text_;
+    DfaMatch match_;
+};
+
+/*
+Explanation:
+libstdc++'s `std::regex` is a backtracking matcher: it tries alternatives one after
+the other and undoes them on failure, recursing once per input character for
+patterns like `(a|b)*`. That costs exponential time on unlucky patterns, a stack
+overflow on long inputs, and is slow even in good cases because every character goes
+through the generic interpreter. `DfaRegex` uses the automata-based approach of RE2
+and Rust's regex crate instead:
+
+1.  The pattern is parsed into a syntax tree and compiled into a Thompson NFA: a small
+    program of byte-set, split, jump, save (capture position), anchor and match
+    instructions. A second program matches the reversed pattern.
+2.  A lazy DFA runs that program. Each DFA state is the set of NFA threads alive at a
+    position, kept in priority order so alternations and greedy/lazy repeats pick
+    the same match as the backtracking order of ECMAScript. States and transitions
+    are built the first time the input needs them, so the usually tiny set of states
+    a text actually visits is all that gets built, and afterwards every byte costs a
+    single table lookup. Bytes that no part of the pattern tells apart share one
+    column of the table. The number of states is bounded; when the limit is hit the
+    cache is flushed and rebuilt as needed.
+3.  A search takes up to three passes, each linear in the text it reads:
+    -   forward DFA (unanchored, leftmost-first): where the leftmost match ends;
+    -   reverse DFA from that end: where it starts;
+    -   Pike VM (NFA simulation with capture positions per thread) over just the
+        matched span, only if the pattern has capture groups.
+    `match()` needs the anchored forward DFA only, plus the Pike VM for groups.
+
+Trade-offs: no backreferences, lookaround or `\b` (they are not regular, or need
+more context than a DFA state), `DfaRegex` is byte-oriented (like `std::regex` on
+`char`), a group repeated with a final empty iteration (`(a*)+`) may report the
+last non-empty one where std::regex reports the empty one, and because matching
+fills the DFA cache a `DfaRegex` must not be used by several threads at once: give
+each thread its own copy (copies share the compiled program). `bench/bench_dfa_regex.cpp` compares it with `std::regex` on log text.
+
+Usage Example:
+```cpp
+DfaRegex date("(\\d{4})-(\\d{2})-(\\d{2})");
+std::string release = "Released 2023-10-26.";
+DfaMatch m;                                          // Refers into `release`
+if (date.search(release, m)) {
+    std::cout << m.str(1) << '\n';                   // "2023"
+}
+std::string text = "apple, pear, orange";
+DfaRegex word("\\w+");
+for (DfaRegexIterator it(text, word), end; it != end; ++it) {
+    std::cout << it->str() << '\n';
+}
+```
+*/
@@ -0,0 +1,174 @@
+// intrusive_ptr.hpp
+// Reference-counted smart pointer whose counter lives inside the object itself.
+// - RefCounted<Derived, Count>: base class that embeds the counter
+//   Count = AtomicRefCount (default, any thread may copy/release) or
+//   PlainRefCount (single-threaded, no atomic instructions)
+// - IntrusivePtr<T>: the pointer; copy = increment, destroy = decrement
+// - make_intrusive<T>(args...): one allocation, like std::make_shared
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility> // For std::forward, std::swap
+
+// Thread-safe count: increments need no ordering (the caller already holds a
+// reference); the decrement that reaches zero must see every write made through
+// the other references before the object is deleted.
+class AtomicRefCount {
+public:
+    AtomicRefCount() : value_(0) {}
+    void increment() { value_.fetch_add(1, std::memory_order_relaxed); }
+    // Returns true when the last reference is gone.
+    bool decrement() {
+        if (value_.fetch_sub(1, std::memory_order_release) == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+        return false;
+    }
+    long get() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<long> value_;
+};
+
+// Single-thread count: a plain integer. Objects using it must never be shared
+// between threads (not even read-only through copies of the pointer).
+class PlainRefCount {
+public:
+    PlainRefCount() : value_(0) {}
+    void increment() { ++value_; }
+    bool decrement() { return --value_ == 0; }
+    long get() const { return value_; }
+
+private:
+    long value_;
+};
+
+// Derive from RefCounted<YourType> (CRTP) to make YourType usable with IntrusivePtr.
+// The counter is not copied: a copy of an object is a new object with no references.
+template<typename Derived, typename Count = AtomicRefCount>
+class RefCounted {
+public:
+    long use_count() const { return count_.get(); }
+
+protected:
+    RefCounted() {}
+    RefCounted(const RefCounted&) {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+    ~RefCounted() {}
+
+private:
+    // Found by argument-dependent lookup from IntrusivePtr.
+    friend void intrusive_ptr_add_ref(const RefCounted* p) { p->count_.increment(); }
+    friend void intrusive_ptr_release(const RefCounted* p) {
+        if (p->count_.decrement()) delete static_cast<const Derived*>(p);
+    }
+
+    mutable Count count_;
+};
+
+template<typename T>
+class IntrusivePtr {
+public:
+    typedef T element_type;
+
+    IntrusivePtr() : p_(nullptr) {}
+    IntrusivePtr(std::nullptr_t) : p_(nullptr) {}
+
+    // Takes a new reference to `p` (which may already be owned by other IntrusivePtrs).
+    explicit IntrusivePtr(T* p) : p_(p) {
+        if (p_) intrusive_ptr_add_ref(p_);
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) : p_(other.p_) {
+        if (p_) intrusive_ptr_add_ref(p_);
+    }
+
+    // Moves transfer the reference: no counter update at all.
+    IntrusivePtr(IntrusivePtr&& other) noexcept : p_(other.p_) { other.p_ = nullptr; }
+
+    template<typename U>
+    IntrusivePtr(const IntrusivePtr<U>& other) : p_(other.get()) {
+        if (p_) intrusive_ptr_add_ref(p_);
+    }
+
+    ~IntrusivePtr() {
+        if (p_) intrusive_ptr_release(p_);
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) {
+        IntrusivePtr(other).swap(*this); // Increment before decrement: safe for self-assignment
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void reset() { IntrusivePtr().swap(*this); }
+    void reset(T* p) { IntrusivePtr(p).swap(*this); }
+
+    void swap(IntrusivePtr& other) noexcept { std::swap(p_, other.p_); }
+
+    T* get() const { return p_; }
+    T& operator*() const { return *p_; }
+    T* operator->() const { return p_; }
+    explicit operator bool() const { return p_ != nullptr; }
+    long use_count() const { return p_ ? p_->use_count() : 0; }
+
+private:
+    T* p_;
+};
+
+template<typename T, typename U>
+bool operator==(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) { return a.get() == b.get(); }
+template<typename T, typename U>
+bool operator!=(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) { return a.get() != b.get(); }
+
+template<typename T, typename... Args>
+IntrusivePtr<T> make_intrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+/*
+Explanation:
+`std::shared_ptr<T>` keeps its reference count in a separate control block:
+-   `std::shared_ptr<T>(new T)` makes two allocations (object, control block) and
+    every access to the count touches a second cache line away from the object.
+    `std::make_shared` puts both into one allocation, but the pointer itself is still
+    two words (object pointer and control block pointer).
+-   The count is updated atomically (libstdc++ skips the atomics only in programs
+    it can tell are single-threaded), so each copy or destruction, e.g. passing a
+    `shared_ptr` by value, is a locked read-modify-write instruction.
+
+An intrusive pointer moves the count into the object:
+-   `RefCounted<T>` (a CRTP base) embeds the counter; `IntrusivePtr<T>` is a single
+    raw pointer. Copy = increment, destruction = decrement; at zero the object is
+    deleted through the derived type (no virtual destructor needed).
+-   The counting policy is a template parameter: `AtomicRefCount` for objects shared
+    between threads, `PlainRefCount` for objects that stay in one thread, where a
+    copy costs an ordinary increment.
+-   A raw `T*` can be turned back into an owning pointer at any time
+    (`IntrusivePtr<T>(raw)`), because the count travels with the object.
+-   What is given up: no `weak_ptr`, no custom deleters, no aliasing constructor, and
+    the type must be written for it (derive from `RefCounted`).
+
+Passing smart pointers: copy only when the callee keeps a reference; otherwise pass
+`const IntrusivePtr<T>&` (or `T&`), which costs nothing with any pointer type.
+`bench/bench_intrusive_ptr.cpp` compares creation, copies and passes by value with
+`std::shared_ptr` (via `make_shared` and via `new`).
+
+Usage Example:
+```cpp
+struct Node : RefCounted<Node> {                  // Atomic count
+    int value;
+    explicit Node(int v) : value(v) {}
+};
+struct Token : RefCounted<Token, PlainRefCount> {}; // Single-threaded count
+
+IntrusivePtr<Node> a = make_intrusive<Node>(1);
+IntrusivePtr<Node> b = a;                         // a.use_count() == 2
+```
+*/
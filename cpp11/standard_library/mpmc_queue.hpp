@@ -0,0 +1,277 @@
+// mpmc_queue.hpp
+// Bounded lock-free ring queues for moving data between threads.
+// - MpmcQueue<T>: any number of producers and consumers (Vyukov's sequence-number design)
+// - SpscQueue<T>: exactly one producer and one consumer, cheaper per operation
+// Both have try_push/try_pop (never block) and push/pop (spin, then yield, until done).
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>      // For std::unique_ptr
+#include <new>         // For placement new
+#include <type_traits> // For std::aligned_storage
+#include <utility>     // For std::move, std::forward
+
+#include "contention.hpp" // SpinBackoff, kFalseSharingPad
+
+namespace queue_detail {
+
+inline std::size_t round_up_pow2(std::size_t n) {
+    std::size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+template<typename T>
+struct Storage {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type bytes;
+    T* get() { return reinterpret_cast<T*>(&bytes); }
+};
+
+} // namespace queue_detail
+
+// Every cell carries a sequence number that says whose turn it is. For the cell at
+// position pos (index pos & mask):
+//   seq == pos      : empty, the producer that claims pos may write it
+//   seq == pos + 1  : full, the consumer that claims pos may read it
+// After reading, the consumer sets seq = pos + capacity, which is the "empty" value
+// for the producer one lap later. Producers claim positions with a CAS on tail_,
+// consumers with a CAS on head_; apart from that, threads only touch their own cell.
+template<typename T>
+class MpmcQueue {
+public:
+    // Capacity is rounded up to a power of two (at least 2).
+    explicit MpmcQueue(std::size_t capacity)
+        : capacity_(queue_detail::round_up_pow2(capacity)), mask_(capacity_ - 1), cells_(new Cell[capacity_]) {
+        for (std::size_t i = 0; i < capacity_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+        tail_.pos.store(0, std::memory_order_relaxed);
+        head_.pos.store(0, std::memory_order_relaxed);
+    }
+
+    // No other thread may use the queue any more, so the positions in [head, tail)
+    // are exactly the full cells (seq == pos + 1); their values are destroyed in place.
+    ~MpmcQueue() {
+        const std::size_t tail = tail_.pos.load(std::memory_order_relaxed);
+        for (std::size_t pos = head_.pos.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            Cell& cell = cells_[pos & mask_];
+            if (cell.seq.load(std::memory_order_relaxed) == pos + 1) cell.value.get()->~T();
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    std::size_t capacity() const { return capacity_; }
+
+    // Returns false if the queue is full.
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        Cell* cell;
+        std::size_t pos = tail_.pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // The cell still holds the value from one lap ago: full
+            } else {
+                pos = tail_.pos.load(std::memory_order_relaxed); // Another producer got it
+            }
+        }
+        ::new (static_cast<void*>(cell->value.get())) T(std::forward<Args>(args)...);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    // Returns false if the queue is empty.
+    bool try_pop(T& out) {
+        Cell* cell;
+        std::size_t pos = head_.pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Not written yet: empty
+            } else {
+                pos = head_.pos.load(std::memory_order_relaxed);
+            }
+        }
+        T* value = cell->value.get();
+        out = std::move(*value);
+        value->~T();
+        cell->seq.store(pos + capacity_, std::memory_order_release);
+        return true;
+    }
+
+    // Blocking versions: wait (spin, then yield) while the queue is full/empty.
+    void push(const T& value) {
+        SpinBackoff backoff;
+        while (!try_push(value)) backoff.pause();
+    }
+    void push(T&& value) {
+        SpinBackoff backoff;
+        while (!try_emplace(std::move(value))) backoff.pause(); // Not moved from unless it succeeded
+    }
+    void pop(T& out) {
+        SpinBackoff backoff;
+        while (!try_pop(out)) backoff.pause();
+    }
+
+    // Approximate while other threads are active.
+    std::size_t size_approx() const {
+        const std::size_t tail = tail_.pos.load(std::memory_order_relaxed);
+        const std::size_t head = head_.pos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        queue_detail::Storage<T> value;
+    };
+
+    // Head and tail each get their own kFalseSharingPad, so producers and consumers
+    // never write the same cache line.
+    struct PaddedPos {
+        std::atomic<std::size_t> pos;
+        char padding[kFalseSharingPad - sizeof(std::atomic<std::size_t>)];
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    char padding0_[kFalseSharingPad];
+    PaddedPos tail_; // Written by producers
+    PaddedPos head_; // Written by consumers
+};
+
+// Single producer, single consumer. Each side owns its index and keeps a cached copy
+// of the other side's index, so it reads the shared one only when the cache says
+// full/empty: most operations touch no cache line written by the other thread.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : capacity_(queue_detail::round_up_pow2(capacity)), mask_(capacity_ - 1), slots_(new Slot[capacity_]) {
+        producer_.pos.store(0, std::memory_order_relaxed);
+        producer_.cached_other = 0;
+        consumer_.pos.store(0, std::memory_order_relaxed);
+        consumer_.cached_other = 0;
+    }
+
+    // Destroys the values still in [head, tail) in place.
+    ~SpscQueue() {
+        const std::size_t tail = producer_.pos.load(std::memory_order_relaxed);
+        for (std::size_t pos = consumer_.pos.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            slots_[pos & mask_].get()->~T();
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    std::size_t capacity() const { return capacity_; }
+
+    // Producer thread only.
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        const std::size_t tail = producer_.pos.load(std::memory_order_relaxed);
+        if (tail - producer_.cached_other == capacity_) {
+            producer_.cached_other = consumer_.pos.load(std::memory_order_acquire);
+            if (tail - producer_.cached_other == capacity_) return false;
+        }
+        ::new (static_cast<void*>(slots_[tail & mask_].get())) T(std::forward<Args>(args)...);
+        producer_.pos.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    // Consumer thread only.
+    bool try_pop(T& out) {
+        const std::size_t head = consumer_.pos.load(std::memory_order_relaxed);
+        if (head == consumer_.cached_other) {
+            consumer_.cached_other = producer_.pos.load(std::memory_order_acquire);
+            if (head == consumer_.cached_other) return false;
+        }
+        T* value = slots_[head & mask_].get();
+        out = std::move(*value);
+        value->~T();
+        consumer_.pos.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T& value) {
+        SpinBackoff backoff;
+        while (!try_push(value)) backoff.pause();
+    }
+    void push(T&& value) {
+        SpinBackoff backoff;
+        while (!try_emplace(std::move(value))) backoff.pause();
+    }
+    void pop(T& out) {
+        SpinBackoff backoff;
+        while (!try_pop(out)) backoff.pause();
+    }
+
+private:
+    typedef queue_detail::Storage<T> Slot;
+
+    struct Side {
+        std::atomic<std::size_t> pos;
+        std::size_t cached_other; // Only touched by the owning side
+        char padding[kFalseSharingPad - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    char padding0_[kFalseSharingPad];
+    Side producer_;
+    Side consumer_;
+};
+
+/*
+Explanation:
+A queue protected by a `std::mutex` and a `std::condition_variable` is the classic
+way to hand work from producer threads to consumer threads. Every push and pop
+takes the same lock, so with several producers and consumers they mostly wait for
+each other, and a waiting consumer is put to sleep and woken by the kernel.
+
+`MpmcQueue<T>` (Dmitry Vyukov's bounded MPMC queue):
+-   A ring of cells with a power-of-two capacity, so `pos & mask` replaces `%`.
+-   Each cell has a sequence number telling producers and consumers whether the
+    cell is theirs in the current lap. A producer claims a position with one CAS
+    on the tail, writes the value, and publishes it by storing the sequence
+    number (release). Consumers do the same with the head.
+-   Producers and consumers contend only on their own index, and head and tail live
+    on different cache lines.
+-   Bounded: `try_push` fails when the queue is full, which gives back-pressure.
+    It never allocates after construction.
+
+`SpscQueue<T>`: with a single producer and a single consumer no CAS is needed; each
+side just stores its own index. Caching the other side's index means the indices
+are only exchanged when the queue looks full or empty.
+
+The blocking `push`/`pop` spin briefly, then yield. They never sleep in the kernel,
+so they are best when both sides are busy; an idle consumer keeps a core busy.
+`bench/bench_mpmc_queue.cpp` compares both with a mutex and condition variable queue.
+
+Usage Example:
+```cpp
+MpmcQueue<int> queue(1024);
+std::thread producer([&] { for (int i = 1; i <= 100; ++i) queue.push(i); queue.push(0); });
+int value, sum = 0;
+for (queue.pop(value); value != 0; queue.pop(value)) sum += value;  // 5050
+producer.join();
+```
+*/
@@ -0,0 +1,109 @@
+// parallel_sum.hpp
+// Partitioned multi-threaded sum of a vector, the parallel counterpart of
+// sum_vector in std_thread.cpp.
+// - plan_sum(n): how many threads and how large chunks are worth it for n elements
+// - parallel_sum(v): sums contiguous chunks on several std::threads; every thread
+//   publishes its partial result into its own cache-line-padded slot
+#pragma once
+
+#include <algorithm> // For std::min, std::max
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "contention.hpp" // kFalseSharingPad
+
+namespace parallel_sum_detail {
+
+// One partial result per thread. Slots sit kFalseSharingPad apart in a std::vector,
+// so no two of them ever share a cache line whatever the vector's alignment.
+template<typename Acc>
+struct PaddedSlot {
+    Acc value;
+    char padding[kFalseSharingPad - sizeof(Acc) % kFalseSharingPad];
+};
+
+template<typename T, typename Acc>
+void sum_chunk(const T* first, const T* last, PaddedSlot<Acc>* slot) {
+    Acc local = Acc(); // Accumulate in a register, touch the shared slot once
+    for (; first != last; ++first) local += *first;
+    slot->value = local;
+}
+
+} // namespace parallel_sum_detail
+
+struct SumPlan {
+    unsigned threads;     // Threads to use (including the calling thread)
+    std::size_t chunk;    // Elements per thread (the last one may get fewer)
+};
+
+// Below min_per_thread elements per thread, starting a thread (tens of
+// microseconds) costs more than summing the elements, so fewer threads are used.
+// max_threads == 0 means std::thread::hardware_concurrency().
+inline SumPlan plan_sum(std::size_t n, unsigned max_threads = 0, std::size_t min_per_thread = 32768) {
+    if (max_threads == 0) max_threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t useful = std::max<std::size_t>(1, n / std::max<std::size_t>(1, min_per_thread));
+    SumPlan plan;
+    plan.threads = static_cast<unsigned>(std::min<std::size_t>(max_threads, useful));
+    plan.chunk = (n + plan.threads - 1) / plan.threads;
+    return plan;
+}
+
+// Sums [first, last) with plan.threads threads in contiguous chunks (the calling
+// thread takes the last chunk). Acc is the accumulator type, e.g. long long for ints.
+template<typename Acc, typename T>
+Acc parallel_sum(const T* first, const T* last, const SumPlan& plan) {
+    using parallel_sum_detail::PaddedSlot;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const unsigned threads = std::max(1u, plan.threads);
+    const std::size_t chunk = std::max<std::size_t>(1, plan.chunk);
+    std::vector<PaddedSlot<Acc> > slots(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t + 1 < threads; ++t) {
+        const std::size_t b = std::min(n, t * chunk), e = std::min(n, b + chunk);
+        workers.emplace_back(parallel_sum_detail::sum_chunk<T, Acc>, first + b, first + e, &slots[t]);
+    }
+    const std::size_t b = std::min(n, (threads - 1) * chunk);
+    parallel_sum_detail::sum_chunk<T, Acc>(first + b, last, &slots[threads - 1]);
+    for (std::size_t t = 0; t < workers.size(); ++t) workers[t].join();
+
+    Acc total = Acc();
+    for (unsigned t = 0; t < threads; ++t) total += slots[t].value;
+    return total;
+}
+
+// Convenience overload for the sum_vector case: automatic plan, long long result.
+inline long long parallel_sum(const std::vector<int>& v, unsigned max_threads = 0) {
+    const int* data = v.data();
+    return parallel_sum<long long>(data, data + v.size(), plan_sum(v.size(), max_threads));
+}
+
+/*
+Explanation:
+A sum reads every element once and does one addition per element, so it is limited
+by memory bandwidth long before the cores run out of arithmetic. More threads help
+until they together saturate the memory controller (often 4-8 cores on a desktop,
+more on servers); beyond that the sum gets no faster.
+
+-   Partitioning: the vector is split into one contiguous chunk per thread, so each
+    thread streams through its own memory and the hardware prefetchers work well.
+-   Chunk sizing: `plan_sum()` uses at most one thread per hardware thread and only
+    as many threads as have at least `min_per_thread` elements each; tiny vectors
+    are summed on the calling thread alone.
+-   False sharing: if the partial sums were adjacent `long long`s in an array and
+    threads updated them in their loops, every update would invalidate the cache
+    line in all other cores. Each thread accumulates in a local variable and writes
+    its result once, into a slot padded to 128 bytes.
+
+`bench/bench_parallel_sum.cpp` prints a scaling report (1..N threads, GB/s) that
+shows where bandwidth saturates, and measures the cost of unpadded slots.
+
+Usage Example:
+```cpp
+std::vector<int> v(10000000, 1);
+long long total = parallel_sum(v);                                      // Automatic plan
+SumPlan plan = plan_sum(v.size(), 4);                                   // At most 4 threads
+long long again = parallel_sum<long long>(v.data(), v.data() + v.size(), plan);
+```
+*/
@@ -4,6 +4,10 @@
 #include <vector>
 #include <string>
 
+#include "allocation_tracker.hpp" // AllocationScope: counts operator new/delete calls (include once)
+#include "intrusive_ptr.hpp"      // IntrusivePtr: reference count inside the object
+#include "weak_cache.hpp"         // WeakCache: weak_ptr entries plus a bounded strong tier
+
 // A sample class to use with smart pointers
 class MyResource {
 public:
@@ -47,20 +51,36 @@ void process_shared(std::shared_ptr<MyResource> s_ptr) {
     }
 }
 
-// Function that returns a unique_ptr (transfers ownership out)
-std::unique_ptr<MyResource> create_unique(int id, const std::string& name) {
-    // return std::unique_ptr<MyResource>(new MyResource(id, name)); // Pre-C++14
-    return std::make_unique<MyResource>(id, name); // C++14 style, but often implemented in C++11 compilers
-                                                   // For strict C++11, use the line above or implement make_unique.
-                                                   // Let's stick to new for pure C++11 core.
-    // return std::unique_ptr<MyResource>(new MyResource(id, name));
+// The same resource with its reference count embedded (see intrusive_ptr.hpp)
+class CountedResource : public RefCounted<CountedResource> {
+public:
+    int id;
+    explicit CountedResource(int i) : id(i) {
+        std::cout << "CountedResource " << id << " created." << std::endl;
+    }
+    ~CountedResource() {
+        std::cout << "CountedResource " << id << " destroyed." << std::endl;
+    }
+};
+
+// Like process_shared: the by-value parameter is one more owner while the call runs
+void process_intrusive(IntrusivePtr<CountedResource> ptr) {
+    std::cout << "process_intrusive shares CountedResource " << ptr->id
+              << " (use count: " << ptr.use_count() << ")" << std::endl;
 }
-// Custom make_unique for C++11 (simplified version)
+
+// Custom make_unique for C++11 (simplified version; std::make_unique is C++14)
 template<typename T, typename... Args>
 std::unique_ptr<T> make_unique_cpp11(Args&&... args) {
     return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
 }
 
+// Function that returns a unique_ptr (transfers ownership out)
+std::unique_ptr<MyResource> create_unique(int id, const std::string& name) {
+    // return std::make_unique<MyResource>(id, name); // C++14 style
+    return make_unique_cpp11<MyResource>(id, name);
+}
+
 
 int main() {
     std::cout << "--- std::unique_ptr ---" << std::endl;
@@ -101,9 +121,7 @@ int main() {
     }
 
     // 4. Returning from function
-    // The create_unique function is defined but not used as is.
-    // Instead, make_unique_cpp11 is used directly.
-    std::unique_ptr<MyResource> u3 = make_unique_cpp11<MyResource>(3, "Unique Three from func");
+    std::unique_ptr<MyResource> u3 = create_unique(3, "Unique Three from func");
     if (u3) {
         u3->show();
     }
@@ -112,9 +130,9 @@ int main() {
     // std::unique_ptr<MyResource[]> u_arr(new MyResource[2]{ {4, "Arr1"}, {5, "Arr2"} }); // Won't work directly like this
     // Need to construct elements separately or use default constructor if available.
     // For array, use std::unique_ptr<T[]>
-    std::unique_ptr<MyResource[]> u_arr = make_unique_cpp11<MyResource[]>(2); 
-    // The above make_unique_cpp11 is not for arrays.
+    // make_unique_cpp11<MyResource[]>(2) does not compile: it is not written for arrays.
     // For arrays with make_unique (C++14) it would be: std::make_unique<MyResource[]>(2);
+    // (which needs a default constructor, which MyResource does not have).
     // For C++11:
     std::unique_ptr<MyResource[]> u_arr_cpp11(new MyResource[2]{{4, "ArrElem1"}, {0, ""}}); // Second element default constructed then assigned
     u_arr_cpp11[0] = MyResource(4, "Arr C++11 One"); // Re-construct or assign if needed
@@ -210,8 +228,83 @@ int main() {
     }
 
 
+    std::cout << "\n--- Caching with weak_ptr (weak_cache.hpp) ---" << std::endl;
+    // weak_ptr as an observer: the cache finds an object as long as someone uses it,
+    // and keeps only a bounded number of unused objects alive itself.
+    {
+        WeakCacheOptions options;
+        options.shards = 1;
+        options.strong_capacity = 1; // Keeps at most one otherwise unused object alive
+        WeakCache<int, MyResource> cache([](const int& id) {
+            return std::make_shared<MyResource>(id, "Cached " + std::to_string(id));
+        }, options);
+
+        std::shared_ptr<MyResource> held = cache.get(60); // Miss: loaded
+        cache.get(61)->show();                            // Miss: loaded, takes 60's strong slot
+        std::shared_ptr<MyResource> again = cache.get(60); // Weak hit: `held` kept it alive
+        std::cout << "Same object as before: " << std::boolalpha << (again == held) << std::endl;
+        // Taking the strong slot back evicted 61, which nobody else held: destroyed above.
+        WeakCacheStats stats = cache.stats();
+        std::cout << "misses " << stats.misses << ", weak hits " << stats.weak_hits
+                  << ", evictions " << stats.evictions << std::endl;
+    }
+
+    std::cout << "\n--- Intrusive Reference Counting (intrusive_ptr.hpp) ---" << std::endl;
+    // Shared ownership like shared_ptr, but the count is a member of the object:
+    // one allocation, a one-word pointer, and copies touch only the object itself.
+    {
+        IntrusivePtr<CountedResource> i1 = make_intrusive<CountedResource>(50);
+        IntrusivePtr<CountedResource> i2 = i1; // Copy: increments the embedded count
+        std::cout << "i1 use count: " << i1.use_count() << std::endl; // 2
+        process_intrusive(i1);                                        // 3 during the call
+        CountedResource* raw = i2.get();
+        IntrusivePtr<CountedResource> i3(raw); // A raw pointer can become an owner again
+        std::cout << "use count after adopting the raw pointer: " << i3.use_count() << std::endl; // 3
+        std::cout << "sizeof(IntrusivePtr) = " << sizeof(i1) << ", sizeof(shared_ptr) = "
+                  << sizeof(std::shared_ptr<MyResource>) << std::endl;
+    } // Last owner gone: CountedResource 50 destroyed
+
+    std::cout << "\n--- Counting Allocations (allocation_tracker.hpp) ---" << std::endl;
+    // The printing above shows which smart pointer operations ran; counting calls to
+    // operator new shows what they cost. (Names are short, so std::string stays in
+    // its small-string buffer and does not allocate either.) A wrong count makes
+    // main return 1, so the example also works as a check.
+    bool counts_ok = true;
+    {
+        AllocationScope make_unique_scope;
+        std::unique_ptr<MyResource> owner = make_unique_cpp11<MyResource>(40, "Counted");
+        const long long created = make_unique_scope.allocations();
+
+        AllocationScope move_scope;
+        std::unique_ptr<MyResource> new_owner = std::move(owner);
+        const long long moved = move_scope.allocations();
+        const bool expected = created == 1 && moved == 0;
+        counts_ok = counts_ok && expected;
+        std::cout << "unique_ptr: creation " << created << " allocation(s), move " << moved
+                  << (expected ? " (as expected)" : " (UNEXPECTED)") << std::endl;
+    }
+    {
+        AllocationScope make_shared_scope;
+        std::shared_ptr<MyResource> combined = std::make_shared<MyResource>(41, "One block");
+        const long long with_make_shared = make_shared_scope.allocations();
+
+        AllocationScope new_scope;
+        std::shared_ptr<MyResource> separate(new MyResource(42, "Two blocks"));
+        const long long with_new = new_scope.allocations();
+
+        AllocationScope copy_scope;
+        std::shared_ptr<MyResource> copy = combined; // Only increments the reference count
+        const long long copied = copy_scope.allocations();
+        const bool expected = with_make_shared == 1 && with_new == 2 && copied == 0;
+        counts_ok = counts_ok && expected;
+        std::cout << "shared_ptr: make_shared " << with_make_shared << " allocation(s), shared_ptr(new T) "
+                  << with_new << ", copy " << copied << (expected ? " (as expected)" : " (UNEXPECTED)") << std::endl;
+    }
+
+    if (!counts_ok) std::cout << "ERROR: an allocation count differs from the expected one!" << std::endl;
+
     std::cout << "\nEnd of main. Resources will be automatically cleaned up by smart pointers." << std::endl;
-    return 0;
+    return counts_ok ? 0 : 1;
 }
 
 /*
@@ -260,6 +353,22 @@ memory automatically and prevent common issues like memory leaks and dangling po
         `shared_ptr` by calling its `lock()` method.
     -   `expired()` method checks if the managed object has already been deleted.
 
+    -   Besides breaking cycles, `weak_ptr` lets a cache observe objects without
+        owning them: `WeakCache<Key, T>` (`weak_cache.hpp`) maps keys to
+        `weak_ptr`s, so an object is found again while anyone still holds it and is
+        destroyed as usual when nobody does. A bounded CLOCK-evicted tier of
+        `shared_ptr`s keeps recently used objects alive in between; the cache is
+        split into independently locked shards. See `bench/bench_weak_cache.cpp`.
+
+4.  Intrusive reference counting (`IntrusivePtr<T>`, `intrusive_ptr.hpp`):
+    -   The object carries its own count by deriving from `RefCounted<T>`;
+        `IntrusivePtr<T>` is a single pointer, and copying it increments the count
+        inside the object (no separate control block, no second allocation).
+    -   The count is atomic by default; `RefCounted<T, PlainRefCount>` uses a plain
+        integer for objects that never leave one thread.
+    -   No `weak_ptr` equivalent. `bench/bench_intrusive_ptr.cpp` compares it with
+        `std::shared_ptr`.
+
 General Benefits of Smart Pointers:
 -   Automatic Memory Management: Reduces the risk of memory leaks (forgetting to
     `delete`) and dangling pointers (using a pointer after `delete`).
@@ -270,6 +379,15 @@ General Benefits of Smart Pointers:
 
 Prefer smart pointers over raw pointers for owning dynamically allocated memory.
 
+Counting Allocations (`allocation_tracker.hpp`):
+-   The header replaces the global `operator new`/`operator delete` with versions
+    that count calls and bytes per thread; `AllocationScope` reports the counts
+    since it was created.
+-   The last section checks the costs claimed above: creating a `unique_ptr` takes
+    1 allocation and moving it none; `std::make_shared` takes 1 allocation (object
+    and control block together), `std::shared_ptr<T>(new T)` takes 2, and copying a
+    `shared_ptr` none.
+
 How to compile:
 g++ -std=c++11 smart_pointers.cpp -o smart_pointers_example
 ./smart_pointers_example
@@ -4,6 +4,16 @@
 #include <vector>
 #include <chrono>   // For std::chrono::milliseconds
 #include <numeric>  // For std::iota (in C++20, also in <numbers>)
+#include <future>   // For std::future
+#include <stdexcept> // For std::runtime_error
+#include <atomic>   // For std::atomic
+#include <mutex>    // For std::mutex, std::lock_guard
+#include <memory>   // For std::unique_ptr
+
+#include "thread_pool.hpp" // ThreadPool: reuses threads, returns results via std::future
+#include "parallel_sum.hpp" // parallel_sum: chunked multi-threaded sum_vector
+#include "mpmc_queue.hpp"   // MpmcQueue, SpscQueue: lock-free producer/consumer queues
+#include "cpu_topology.hpp" // CpuTopology, pin_current_thread: thread placement by policy
 
 // A simple function to be executed by a thread
 void task_function(int id, int duration_ms) {
@@ -35,6 +45,15 @@ void sum_vector(const std::vector<int>& v, long long& result) { // Using referen
     std::cout << "Thread (sum_vector): Calculated sum = " << result << std::endl;
 }
 
+// The same computation with a real return value, for use with ThreadPool::submit
+long long sum_vector_value(const std::vector<int>& v) {
+    long long current_sum = 0;
+    for (int val : v) {
+        current_sum += val;
+    }
+    return current_sum;
+}
+
 
 int main() {
     std::cout << "--- Basic Thread Creation and Joining ---" << std::endl;
@@ -100,6 +119,150 @@ int main() {
     // Note: For more complex return values and synchronization, std::promise and std::future are preferred.
 
 
+    std::cout << "\n--- Splitting sum_vector across threads (parallel_sum.hpp) ---" << std::endl;
+    {
+        std::vector<int> big_data(4000000);
+        std::iota(big_data.begin(), big_data.end(), 1);
+        // plan_sum picks the thread count from the vector length and the core count;
+        // 1000 elements are not worth a second thread, 4 million are.
+        SumPlan small_plan = plan_sum(data_to_sum.size());
+        SumPlan big_plan = plan_sum(big_data.size());
+        std::cout << "Plan for " << data_to_sum.size() << " elements: " << small_plan.threads << " thread(s)" << std::endl;
+        std::cout << "Plan for " << big_data.size() << " elements: " << big_plan.threads
+                  << " thread(s), " << big_plan.chunk << " elements each" << std::endl;
+        // Each thread sums its own contiguous chunk and writes one padded slot
+        std::cout << "Main thread: parallel sum = " << parallel_sum(big_data)
+                  << " (expected " << 4000000LL * 4000001LL / 2 << ")" << std::endl;
+        SumPlan forced = plan_sum(big_data.size(), 4, 1); // Force up to 4 threads
+        std::cout << "Main thread: sum with " << forced.threads << " threads = "
+                  << parallel_sum<long long>(big_data.data(), big_data.data() + big_data.size(), forced) << std::endl;
+    }
+
+
+    std::cout << "\n--- Reusing Threads: ThreadPool (thread_pool.hpp) ---" << std::endl;
+    {
+        // Every std::thread above was created for one task and destroyed afterwards.
+        // A pool creates its threads once and hands them one task after another.
+        ThreadPool pool(3);
+        std::cout << "Main thread: pool with " << pool.size() << " threads created." << std::endl;
+
+        std::future<void> f1 = pool.submit(task_function, 1, 50);
+        std::future<void> f2 = pool.submit([](int id) {
+            std::cout << "Pool task " << id << " (lambda): running." << std::endl;
+        }, 2);
+        MyWorker pooled_worker(3);
+        std::future<void> f3 = pool.submit(&MyWorker::process, &pooled_worker, 1);
+        // The result comes back through the future instead of an out-reference
+        std::future<long long> f_sum = pool.submit(sum_vector_value, std::cref(data_to_sum));
+
+        f1.get();
+        f2.get();
+        f3.get();
+        std::cout << "Main thread: Sum calculated by the pool = " << f_sum.get() << std::endl;
+
+        // Arguments are moved into the task, as with std::thread, so move-only ones work
+        std::unique_ptr<int> owned(new int(3));
+        std::future<int> f_owned = pool.submit([](std::unique_ptr<int> p) { return *p * 14; }, std::move(owned));
+        std::cout << "Main thread: task that took ownership of a unique_ptr returned " << f_owned.get() << std::endl;
+
+        // Exceptions thrown by a task are rethrown by future::get()
+        std::future<int> f_fail = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+        try {
+            f_fail.get();
+        } catch (const std::runtime_error& e) {
+            std::cout << "Main thread: caught exception from pool task: " << e.what() << std::endl;
+        }
+
+        // Many short tasks: queue them in one batch (one lock, one wake-up)
+        std::vector<std::function<long long()> > chunks;
+        for (int c = 0; c < 10; ++c) {
+            chunks.push_back([c, &data_to_sum]() {
+                long long partial = 0;
+                for (std::size_t i = c * 100; i < static_cast<std::size_t>(c + 1) * 100; ++i) partial += data_to_sum[i];
+                return partial;
+            });
+        }
+        std::vector<std::future<long long> > partials = pool.submit_batch(chunks.begin(), chunks.end());
+        long long batch_sum = 0;
+        for (std::size_t i = 0; i < partials.size(); ++i) batch_sum += partials[i].get();
+        std::cout << "Main thread: Sum of " << partials.size() << " batched tasks = " << batch_sum << std::endl;
+
+        pool.shutdown(); // Graceful: queued tasks finish first (the destructor would do the same)
+        std::cout << "Main thread: pool shut down." << std::endl;
+    }
+
+
+    std::cout << "\n--- Producer/Consumer with a lock-free queue (mpmc_queue.hpp) ---" << std::endl;
+    {
+        // Two producers -> MpmcQueue -> two consumers -> SpscQueue -> main thread.
+        // The queues are bounded: a producer that gets ahead waits for the consumers.
+        const int per_producer = 10000;
+        MpmcQueue<int> work(256);
+        SpscQueue<long long> results(16);
+        std::atomic<int> consumers_done(0);
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 2; ++p) {
+            producers.emplace_back([&work, per_producer] {
+                for (int i = 1; i <= per_producer; ++i) work.push(i);
+                work.push(0); // One stop marker per producer
+            });
+        }
+        std::mutex results_mutex; // Two consumers share the single-producer side of `results`
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < 2; ++c) {
+            consumers.emplace_back([&] {
+                long long partial = 0;
+                int value;
+                for (work.pop(value); value != 0; work.pop(value)) partial += value;
+                {
+                    std::lock_guard<std::mutex> lock(results_mutex);
+                    results.push(partial);
+                }
+                ++consumers_done;
+            });
+        }
+        long long total = 0;
+        for (int received = 0; received < 2; ++received) {
+            long long partial;
+            results.pop(partial);
+            total += partial;
+        }
+        for (std::size_t i = 0; i < producers.size(); ++i) producers[i].join();
+        for (std::size_t i = 0; i < consumers.size(); ++i) consumers[i].join();
+        std::cout << "Main thread: consumers summed " << total << " (expected "
+                  << 2LL * per_producer * (per_producer + 1) / 2 << "), "
+                  << consumers_done.load() << " consumers finished." << std::endl;
+    }
+
+
+    std::cout << "\n--- CPU Topology and Thread Pinning (cpu_topology.hpp) ---" << std::endl;
+    {
+        CpuTopology topology = CpuTopology::detect();
+        std::cout << "Topology: " << topology.summary() << std::endl;
+        const std::size_t num_pinned = 4;
+        const PinPolicy policies[] = {PinPolicy::compact, PinPolicy::scatter, PinPolicy::physical_cores};
+        for (PinPolicy policy : policies) {
+            std::vector<int> cpus = topology.placement(policy, num_pinned);
+            std::vector<int> ran_on(num_pinned, -1);
+            std::vector<std::thread> pinned;
+            for (std::size_t i = 0; i < num_pinned; ++i) {
+                // Pin from inside the thread, before it does any work
+                pinned.emplace_back([&cpus, &ran_on, i] {
+                    if (pin_current_thread(cpus[i])) ran_on[i] = current_cpu();
+                });
+            }
+            for (std::size_t i = 0; i < pinned.size(); ++i) pinned[i].join();
+            std::cout << to_string(policy) << ": threads ran on CPUs";
+            for (std::size_t i = 0; i < ran_on.size(); ++i) std::cout << " " << ran_on[i];
+            std::cout << std::endl;
+        }
+        // Pool workers are pinned through the pool's worker start hook
+        ThreadPool pinned_pool(2, pinning_hook(topology, PinPolicy::physical_cores, 2));
+        std::cout << "Pinned pool task ran on CPU " << pinned_pool.submit(current_cpu).get() << std::endl;
+    }
+
+
     std::cout << "\n--- Hardware Concurrency ---" << std::endl;
     unsigned int n_cores = std::thread::hardware_concurrency();
     std::cout << "Number of concurrent threads supported (hint): " << n_cores << std::endl;
@@ -173,7 +336,30 @@ Key Concepts:
             concurrency support, provides a cleaner way to get results and handle
             exceptions from threads). This is generally the preferred method.
 
-8.  `std::thread::hardware_concurrency()`:
+8.  Thread Pools (`thread_pool.hpp`):
+    -   Creating a thread per task costs tens of microseconds, which dominates
+        short tasks. `ThreadPool` creates a fixed number of threads once and feeds
+        them tasks from a queue.
+    -   `pool.submit(f, args...)` accepts the same callables as the `std::thread`
+        constructor, with the same argument handling (copied or moved into the
+        task, so a `std::unique_ptr` can be passed), and returns a `std::future`
+        for the result; `get()` also rethrows the task's exception.
+    -   `pool.submit_batch(first, last)` queues many tasks at once, and
+        `pool.shutdown()` (or the destructor) finishes queued tasks before joining.
+    -   `bench/bench_thread_pool.cpp` measures tasks per second against
+        thread-per-task and `std::async`.
+    -   `parallel_sum()` (`parallel_sum.hpp`) splits `sum_vector` into one
+        contiguous chunk per thread; each thread writes its partial sum into its
+        own cache-line-padded slot, avoiding false sharing.
+    -   `MpmcQueue`/`SpscQueue` (`mpmc_queue.hpp`) move data between threads
+        without a lock: bounded lock-free ring buffers for producer/consumer
+        pipelines (benchmarked in `bench/bench_mpmc_queue.cpp`).
+    -   `CpuTopology` (`cpu_topology.hpp`) reads cores, SMT siblings and NUMA
+        nodes from `/sys/devices/system/cpu`; `placement()` and
+        `pin_current_thread()` pin threads by policy (compact, scatter, one per
+        physical core) for reproducible measurements.
+
+9.  `std::thread::hardware_concurrency()`:
     -   Returns an estimate of the number of hardware thread contexts (e.g.,
         number of cores or hyper-threads). It's a hint and can be 0 if unknown.
 
@@ -0,0 +1,263 @@
+// thread_pool.hpp
+// A fixed-size thread pool: threads are created once and reused for every task,
+// results (and exceptions) come back through std::future.
+// - submit(f, args...): one task, returns std::future<result>
+// - submit_batch(first, last): a range of callables, queued under one lock
+// - shutdown(): finishes all queued tasks, then joins the workers
+// - an optional hook runs in every worker at start (e.g. CPU pinning)
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>  // For std::function, std::reference_wrapper
+#include <future>      // For std::packaged_task, std::future
+#include <memory>      // For std::shared_ptr
+#include <mutex>
+#include <stdexcept>   // For std::runtime_error
+#include <thread>
+#include <tuple>       // For std::tuple, std::get, std::apply
+#include <type_traits> // For std::invoke_result / std::result_of, std::decay
+#include <utility>     // For std::forward, std::move, std::index_sequence
+#include <vector>
+
+namespace thread_pool_detail {
+
+// The result type of f(args...). std::result_of is deprecated in C++17 and removed in
+// C++20, but this header is also included from C++20 code (the benchmarks).
+#if __cplusplus >= 201703L
+template<typename F, typename... Args>
+struct invoke_result {
+    typedef typename std::invoke_result<F, Args...>::type type;
+};
+#else
+template<typename F, typename... Args>
+struct invoke_result {
+    typedef typename std::result_of<F(Args...)>::type type;
+};
+
+// std::invoke for C++11/14: plain callables, and pointers to members called on an
+// object, a (smart) pointer or a std::reference_wrapper (as std::bind accepts).
+template<typename F, typename... Args>
+auto invoke(F&& f, Args&&... args) -> decltype(std::forward<F>(f)(std::forward<Args>(args)...)) {
+    return std::forward<F>(f)(std::forward<Args>(args)...);
+}
+template<typename M, typename C, typename Obj, typename... Args>
+auto invoke(M C::*pm, Obj&& obj, Args&&... args)
+    -> decltype((std::forward<Obj>(obj).*pm)(std::forward<Args>(args)...)) {
+    return (std::forward<Obj>(obj).*pm)(std::forward<Args>(args)...);
+}
+template<typename M, typename C, typename Obj, typename... Args>
+auto invoke(M C::*pm, Obj&& obj, Args&&... args)
+    -> decltype(((*std::forward<Obj>(obj)).*pm)(std::forward<Args>(args)...)) {
+    return ((*std::forward<Obj>(obj)).*pm)(std::forward<Args>(args)...);
+}
+template<typename M, typename C, typename T, typename... Args>
+auto invoke(M C::*pm, std::reference_wrapper<T> obj, Args&&... args)
+    -> decltype((obj.get().*pm)(std::forward<Args>(args)...)) {
+    return (obj.get().*pm)(std::forward<Args>(args)...);
+}
+template<typename M, typename C, typename Obj>
+auto invoke(M C::*pm, Obj&& obj) -> decltype(std::forward<Obj>(obj).*pm) {
+    return std::forward<Obj>(obj).*pm;
+}
+template<typename M, typename C, typename Obj>
+auto invoke(M C::*pm, Obj&& obj) -> decltype((*std::forward<Obj>(obj)).*pm) {
+    return (*std::forward<Obj>(obj)).*pm;
+}
+
+#if __cplusplus >= 201402L
+using std::index_sequence;
+using std::make_index_sequence;
+#else
+template<std::size_t...> struct index_sequence {};
+template<std::size_t N, std::size_t... I>
+struct index_sequence_builder : index_sequence_builder<N - 1, N - 1, I...> {};
+template<std::size_t... I>
+struct index_sequence_builder<0, I...> {
+    typedef index_sequence<I...> type;
+};
+template<std::size_t N>
+using make_index_sequence = typename index_sequence_builder<N>::type;
+#endif
+#endif
+
+// A decayed copy of the callable and of every argument, invoked once with all of them
+// as rvalues: the argument handling of std::thread. (std::bind would pass the stored
+// arguments as lvalues, so a function taking a std::unique_ptr could not be called.)
+template<typename F, typename... Args>
+class DeferredCall {
+public:
+    typedef typename invoke_result<F, Args...>::type result_type;
+
+    DeferredCall(F f, std::tuple<Args...> args) : f_(std::move(f)), args_(std::move(args)) {}
+
+    result_type operator()() {
+#if __cplusplus >= 201703L
+        return std::apply(std::move(f_), std::move(args_));
+#else
+        return call(make_index_sequence<sizeof...(Args)>());
+#endif
+    }
+
+private:
+#if __cplusplus < 201703L
+    template<std::size_t... I>
+    result_type call(index_sequence<I...>) {
+        return thread_pool_detail::invoke(std::move(f_), std::get<I>(std::move(args_))...);
+    }
+#endif
+
+    F f_;
+    std::tuple<Args...> args_;
+};
+
+} // namespace thread_pool_detail
+
+class ThreadPool {
+public:
+    // Called once in every worker thread, with the worker's index, before it runs any
+    // task; e.g. to pin the worker to a CPU (see pinning_hook() in cpu_topology.hpp).
+    typedef std::function<void(unsigned)> WorkerStartHook;
+
+    // num_threads == 0 means "one thread per hardware thread".
+    explicit ThreadPool(unsigned num_threads = 0, WorkerStartHook on_worker_start = WorkerStartHook()) {
+        if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 1; // hardware_concurrency() may be unknown
+        workers_.reserve(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i, on_worker_start);
+        }
+    }
+
+    // Graceful: tasks already queued still run.
+    ~ThreadPool() { shutdown(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Queues f(args...) and returns a future for its result. Arguments are copied or
+    // moved into the task and passed to f as rvalues (use std::ref/std::cref for
+    // references), just like with std::thread, so move-only arguments work.
+    // Throws std::runtime_error after shutdown().
+    template<typename F, typename... Args>
+    std::future<typename thread_pool_detail::DeferredCall<typename std::decay<F>::type, typename std::decay<Args>::type...>::result_type>
+    submit(F&& f, Args&&... args) {
+        typedef thread_pool_detail::DeferredCall<typename std::decay<F>::type, typename std::decay<Args>::type...> Call;
+        typedef typename Call::result_type Result;
+        std::shared_ptr<std::packaged_task<Result()> > task = std::make_shared<std::packaged_task<Result()> >(
+            Call(std::forward<F>(f), std::tuple<typename std::decay<Args>::type...>(std::forward<Args>(args)...)));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) throw std::runtime_error("ThreadPool: submit() after shutdown()");
+            queue_.emplace_back([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    // Queues every callable in [first, last) (each called without arguments) with a
+    // single lock acquisition and a single wake-up, which is much cheaper than
+    // calling submit() in a loop when the tasks are short.
+    template<typename Iterator>
+    std::vector<std::future<typename thread_pool_detail::invoke_result<typename std::decay<decltype(*std::declval<Iterator>())>::type>::type> >
+    submit_batch(Iterator first, Iterator last) {
+        typedef typename std::decay<decltype(*first)>::type Callable;
+        typedef typename thread_pool_detail::invoke_result<Callable>::type Result;
+        std::vector<std::function<void()> > jobs;
+        std::vector<std::future<Result> > results;
+        for (; first != last; ++first) {
+            std::shared_ptr<std::packaged_task<Result()> > task =
+                std::make_shared<std::packaged_task<Result()> >(*first);
+            results.push_back(task->get_future());
+            jobs.emplace_back([task] { (*task)(); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) throw std::runtime_error("ThreadPool: submit_batch() after shutdown()");
+            for (std::size_t i = 0; i < jobs.size(); ++i) queue_.push_back(std::move(jobs[i]));
+        }
+        if (results.size() == 1) {
+            cv_.notify_one();
+        } else if (!results.empty()) {
+            cv_.notify_all();
+        }
+        return results;
+    }
+
+    // Number of tasks that are queued but not yet started.
+    std::size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    // Stops accepting tasks, lets the workers finish everything already queued and
+    // joins them. Idempotent; must not be called from a task.
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (std::size_t i = 0; i < workers_.size(); ++i) {
+            if (workers_[i].joinable()) workers_[i].join();
+        }
+    }
+
+private:
+    void worker_loop(unsigned index, WorkerStartHook on_start) {
+        if (on_start) on_start(index);
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return; // Stopping and drained
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            job(); // packaged_task stores exceptions in the future, so this never throws
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()> > queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+/*
+Explanation:
+Creating a `std::thread` costs a system call, a stack allocation and scheduler work
+(typically tens of microseconds). For short tasks that cost dominates. A thread
+pool creates its threads once; tasks are put into a queue and picked up by
+whichever worker is idle.
+
+-   `submit()` wraps the call in a `std::packaged_task`, so the caller gets a
+    `std::future`: `get()` waits for the result and rethrows an exception thrown
+    by the task. No more out-parameters passed with `std::ref`.
+-   `submit_batch()` queues many tasks at once: one lock, one `notify_all()`.
+-   `shutdown()` (also called by the destructor) is graceful: queued tasks still
+    run, then the workers exit and are joined. Later submissions throw.
+-   An optional hook runs in every worker before its first task, e.g. to pin the
+    workers to CPUs with `pinning_hook()` from `cpu_topology.hpp`.
+
+The pool uses one shared queue protected by a mutex, which is simple and fair.
+With many cores and very small tasks that queue becomes the bottleneck; a
+work-stealing pool (see cpp17/standard_library/work_stealing_pool.hpp) avoids it.
+A task must not wait for the future of another task in the same pool: with all
+workers waiting, nobody is left to run the task they wait for.
+
+Usage Example:
+```cpp
+ThreadPool pool(4);
+std::future<int> answer = pool.submit([](int x) { return x * 2; }, 21);
+std::vector<std::function<long()> > jobs(100, [] { return 1L; });
+auto results = pool.submit_batch(jobs.begin(), jobs.end());
+std::cout << answer.get() << '\n';  // 42
+```
+*/
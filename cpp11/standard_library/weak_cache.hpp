@@ -0,0 +1,287 @@
+// weak_cache.hpp
+// Concurrent key -> std::shared_ptr<Value> cache that never keeps more than a
+// bounded number of objects alive on its own.
+// - WeakCache<Key, Value>: get(key) returns the cached object or loads it
+//   - weak tier: every entry is a std::weak_ptr, so an object stays findable for as
+//     long as anyone still uses it, and is reclaimed when nobody does
+//   - strong tier: a bounded set of std::shared_ptr per shard with CLOCK
+//     (second-chance) eviction keeps recently used objects alive between uses
+//   - sharded: a key's hash picks one of N independently locked shards
+// - WeakCacheStats: hits per tier, misses, evictions
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>    // For std::function, std::hash
+#include <memory>        // For std::shared_ptr, std::weak_ptr
+#include <mutex>
+#include <unordered_map>
+#include <utility>       // For std::move
+#include <vector>
+
+#include "contention.hpp" // kFalseSharingPad
+
+struct WeakCacheOptions {
+    WeakCacheOptions() : shards(16), strong_capacity(1024) {}
+
+    std::size_t shards;          // Rounded up to a power of two
+    std::size_t strong_capacity; // Objects kept alive by the cache itself, over all shards
+};
+
+struct WeakCacheStats {
+    std::uint64_t strong_hits; // Found in the strong tier
+    std::uint64_t weak_hits;   // Found only through a weak entry (someone else kept it alive)
+    std::uint64_t misses;      // Loaded
+    std::uint64_t evictions;   // Dropped from the strong tier by CLOCK
+
+    double hit_rate() const {
+        const double total = double(strong_hits + weak_hits + misses);
+        return total > 0 ? double(strong_hits + weak_hits) / total : 0.0;
+    }
+};
+
+template<typename Key, typename Value, typename Hash = std::hash<Key> >
+class WeakCache {
+public:
+    // Creates the object for a key on a miss. Called without any lock held; may
+    // return nullptr (nothing is cached then).
+    typedef std::function<std::shared_ptr<Value>(const Key&)> Loader;
+
+    explicit WeakCache(Loader loader, const WeakCacheOptions& options = WeakCacheOptions())
+        : loader_(std::move(loader)), shard_mask_(round_up_pow2(options.shards) - 1),
+          shards_(shard_mask_ + 1) {
+        // Split exactly: the first strong_capacity % shards shards get one slot more,
+        // and with fewer slots than shards some shards keep nothing alive.
+        const std::size_t per_shard = options.strong_capacity / shards_.size();
+        const std::size_t remainder = options.strong_capacity % shards_.size();
+        for (std::size_t i = 0; i < shards_.size(); ++i) shards_[i].ring.resize(per_shard + (i < remainder ? 1 : 0));
+    }
+
+    WeakCache(const WeakCache&) = delete;
+    WeakCache& operator=(const WeakCache&) = delete;
+
+    // The cached object for `key`, loading it on a miss. Two threads missing the same
+    // key at once may both load; the first to insert wins and both get its object.
+    std::shared_ptr<Value> get(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::shared_ptr<Value> evicted; // Released after unlocking: ~Value may be slow
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            std::shared_ptr<Value> found = lookup(shard, key, evicted);
+            if (found) return found;
+        }
+        std::shared_ptr<Value> loaded = loader_(key);
+        if (!loaded) return loaded;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        ++shard.misses;
+        Entry& entry = shard.map[key];
+        if (std::shared_ptr<Value> raced = entry.weak.lock()) return raced; // Another thread was first
+        entry.weak = loaded;
+        keep_strong(shard, entry, loaded, evicted);
+        maybe_sweep(shard);
+        return loaded;
+    }
+
+    // Like get(), but never loads: nullptr if the object is not alive anymore.
+    std::shared_ptr<Value> find(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::shared_ptr<Value> evicted;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return lookup(shard, key, evicted);
+    }
+
+    // Forgets `key` (the object lives on while others hold it).
+    void erase(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::shared_ptr<Value> dropped;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        typename Map::iterator it = shard.map.find(key);
+        if (it == shard.map.end()) return;
+        if (it->second.slot != kNoSlot) {
+            dropped.swap(shard.ring[it->second.slot].value);
+            shard.ring[it->second.slot].entry = nullptr;
+        }
+        shard.map.erase(it);
+    }
+
+    // Empties the strong tier: every object not used elsewhere is destroyed.
+    void release_strong() {
+        for (Shard& shard : shards_) {
+            std::vector<Slot> dropped;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                dropped.resize(shard.ring.size());
+                dropped.swap(shard.ring);
+                for (typename Map::iterator it = shard.map.begin(); it != shard.map.end(); ++it) it->second.slot = kNoSlot;
+                shard.hand = 0;
+            }
+        }
+    }
+
+    WeakCacheStats stats() const {
+        WeakCacheStats s = {0, 0, 0, 0};
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            s.strong_hits += shard.strong_hits;
+            s.weak_hits += shard.weak_hits;
+            s.misses += shard.misses;
+            s.evictions += shard.evictions;
+        }
+        return s;
+    }
+
+    // Entries in the weak tier, including ones whose object died since the last sweep.
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            n += shard.map.size();
+        }
+        return n;
+    }
+
+private:
+    static const std::size_t kNoSlot = static_cast<std::size_t>(-1);
+
+    struct Entry {
+        Entry() : slot(kNoSlot) {}
+        std::weak_ptr<Value> weak;
+        std::size_t slot; // Index in the shard's CLOCK ring, or kNoSlot
+    };
+
+    typedef std::unordered_map<Key, Entry, Hash> Map;
+
+    // One position of the CLOCK ring. Entries are referenced by address: an
+    // unordered_map never moves its elements, and an entry with a strong slot is
+    // alive, so the sweep never erases it.
+    struct Slot {
+        Slot() : entry(nullptr), referenced(false) {}
+        std::shared_ptr<Value> value;
+        Entry* entry;
+        bool referenced; // Second chance: set on every hit, cleared by the passing hand
+    };
+
+    // Shards sit in a std::vector; the trailing kFalseSharingPad bytes keep the fields
+    // of neighbouring shards off each other's lines whatever the vector's alignment.
+    struct Shard {
+        Shard() : hand(0), sweep_at(64), strong_hits(0), weak_hits(0), misses(0), evictions(0) {}
+        mutable std::mutex mutex;
+        Map map;
+        std::vector<Slot> ring;
+        std::size_t hand;
+        std::size_t sweep_at; // Map size that triggers the next sweep of expired entries
+        std::uint64_t strong_hits, weak_hits, misses, evictions;
+        char padding[kFalseSharingPad];
+    };
+
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    Shard& shard_for(const Key& key) {
+        // Fibonacci hashing: std::hash of an integer is often the identity, so mix
+        // before taking bits, and take the high ones.
+        const std::uint64_t h = static_cast<std::uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ULL;
+        return shards_[static_cast<std::size_t>(h >> 32) & shard_mask_];
+    }
+
+    // Called with the shard locked.
+    std::shared_ptr<Value> lookup(Shard& shard, const Key& key, std::shared_ptr<Value>& evicted) {
+        typename Map::iterator it = shard.map.find(key);
+        if (it == shard.map.end()) return std::shared_ptr<Value>();
+        Entry& entry = it->second;
+        if (entry.slot != kNoSlot) {
+            Slot& slot = shard.ring[entry.slot];
+            slot.referenced = true;
+            ++shard.strong_hits;
+            return slot.value;
+        }
+        std::shared_ptr<Value> alive = entry.weak.lock();
+        if (alive) {
+            ++shard.weak_hits;
+            keep_strong(shard, entry, alive, evicted); // Used again: back into the strong tier
+        }
+        return alive;
+    }
+
+    // Puts `value` into the CLOCK ring: the hand skips (and clears) referenced slots
+    // and replaces the first unreferenced one. Called with the shard locked.
+    void keep_strong(Shard& shard, Entry& entry, const std::shared_ptr<Value>& value, std::shared_ptr<Value>& evicted) {
+        if (shard.ring.empty()) return;
+        for (;;) {
+            Slot& slot = shard.ring[shard.hand];
+            const std::size_t index = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.ring.size();
+            if (slot.entry != nullptr && slot.referenced) {
+                slot.referenced = false;
+                continue;
+            }
+            if (slot.entry != nullptr) {
+                slot.entry->slot = kNoSlot; // Still findable through its weak_ptr
+                evicted.swap(slot.value);
+                ++shard.evictions;
+            }
+            slot.value = value;
+            slot.entry = &entry;
+            slot.referenced = false;
+            entry.slot = index;
+            return;
+        }
+    }
+
+    // Removes entries whose objects are gone once the map has doubled since the last
+    // sweep, so a long-running cache does not accumulate dead keys. Amortized O(1).
+    void maybe_sweep(Shard& shard) {
+        if (shard.map.size() < shard.sweep_at) return;
+        for (typename Map::iterator it = shard.map.begin(); it != shard.map.end();) {
+            if (it->second.slot == kNoSlot && it->second.weak.expired()) it = shard.map.erase(it);
+            else ++it;
+        }
+        shard.sweep_at = shard.map.size() * 2 > 64 ? shard.map.size() * 2 : 64;
+    }
+
+    const Loader loader_;
+    const std::size_t shard_mask_;
+    std::vector<Shard> shards_;
+};
+
+/*
+Explanation:
+A cache of shared objects (parsed files, textures, compiled queries, connections)
+has two conflicting goals: hand out the same object to everyone who asks for the
+same key while it is in use, and not keep every object ever loaded alive forever.
+`WeakCache` separates the two:
+-   Weak tier: every key maps to a `std::weak_ptr`. As long as any caller still holds
+    the `shared_ptr` it got, `get()` finds the object (`weak_ptr::lock()`) and
+    returns the same instance; when the last holder lets go, the object is destroyed
+    by `shared_ptr` as usual, with no eviction logic at all. Dead entries are swept
+    when a shard's map has doubled since the last sweep.
+-   Strong tier: `strong_capacity` `shared_ptr`s in total, split over the shards, so
+    that objects used repeatedly but briefly (get, use, drop) are not reloaded every
+    time. Eviction is CLOCK: slots form a ring with a "referenced" bit set on every
+    hit; the hand clears set bits and replaces the first slot whose bit was already
+    clear. It approximates LRU without moving list nodes on every hit.
+-   Sharding: the key's hash (mixed, since std::hash of an integer is the identity)
+    selects one of N shards, each with its own mutex, map and ring, padded by 128
+    bytes. Threads contend only when they hit the same shard at the same moment;
+    critical sections are a hash lookup and a few stores. The loader runs without
+    any lock, so a slow load does not block the shard.
+-   Objects evicted or erased are released after the shard's mutex is unlocked, so
+    a destructor never runs inside a critical section.
+
+This is the `std::weak_ptr` of smart_pointers.cpp in its other main role besides
+breaking cycles: observing objects without owning them. `bench/bench_weak_cache.cpp`
+measures hit rate and lookup throughput with 1..N threads.
+
+Usage Example:
+```cpp
+WeakCache<int, MyResource> cache([](const int& id) {
+    return std::make_shared<MyResource>(id, "Loaded " + std::to_string(id));
+});
+std::shared_ptr<MyResource> a = cache.get(7); // Miss: loads
+std::shared_ptr<MyResource> b = cache.get(7); // Hit: the same object (a == b)
+WeakCacheStats s = cache.stats();             // s.misses == 1, s.strong_hits == 1
+```
+*/
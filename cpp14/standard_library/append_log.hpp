@@ -0,0 +1,160 @@
+// append_log.hpp
+// A lock-free, append-only log: any number of threads append concurrently, readers
+// get the number of entries in O(1) and read published entries without any lock.
+// Entries never move once written, so references to them stay valid.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>         // For placement new
+#include <type_traits> // For std::aligned_storage
+#include <utility>     // For std::move, std::forward
+
+// Storage grows in segments of base, 2*base, 4*base, ... slots. A new segment is
+// allocated by whichever appender first needs it (losers of the race free theirs),
+// so appends never copy or move existing entries and never take a lock.
+//
+// An append is a fetch_add to reserve a slot, a construction, and a flag store.
+// size() counts the *published* entries: the longest prefix in which every entry is
+// fully constructed. It is advanced cooperatively: each appender moves it forward
+// over its own slot and any completed slots after it, so it never waits for others.
+template<typename T, std::size_t BaseCapacity = 64>
+class AppendLog {
+    static_assert((BaseCapacity & (BaseCapacity - 1)) == 0, "BaseCapacity must be a power of two");
+
+public:
+    AppendLog() {
+        for (auto& segment : segments_) segment.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~AppendLog() {
+        const std::size_t reserved = reserved_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < reserved; ++i) {
+            Slot* slot = find_slot(i);
+            if (slot != nullptr && slot->ready.load(std::memory_order_relaxed)) slot->value()->~T();
+        }
+        for (auto& segment : segments_) delete[] segment.load(std::memory_order_relaxed);
+    }
+
+    AppendLog(const AppendLog&) = delete;
+    AppendLog& operator=(const AppendLog&) = delete;
+
+    // Appends an entry and returns its index. Safe to call from any number of threads.
+    template<typename... Args>
+    std::size_t emplace_back(Args&&... args) {
+        const std::size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slot_for_append(index);
+        ::new (static_cast<void*>(&slot.storage)) T(std::forward<Args>(args)...);
+        // seq_cst pairs with the loads in publish(): of two appenders finishing neighbouring
+        // slots at the same time, at least one sees the other's slot as ready.
+        slot.ready.store(true, std::memory_order_seq_cst);
+        publish();
+        return index;
+    }
+
+    std::size_t push_back(const T& value) { return emplace_back(value); }
+    std::size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    // Number of published entries; [0, size()) can be read. O(1), never blocks.
+    std::size_t size() const { return published_.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+    // Only valid for index < size().
+    const T& operator[](std::size_t index) const { return *find_slot(index)->value(); }
+
+    // Calls f(entry) for every entry published when the call started, in index order.
+    template<typename F>
+    void for_each(F f) const {
+        const std::size_t count = size();
+        for (std::size_t i = 0; i < count; ++i) f((*this)[i]);
+    }
+
+private:
+    static constexpr std::size_t kMaxSegments = 40; // BaseCapacity * 2^40 entries
+
+    struct Slot {
+        std::atomic<bool> ready{false};
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* value() { return reinterpret_cast<T*>(&storage); }
+        const T* value() const { return reinterpret_cast<const T*>(&storage); }
+    };
+
+    static std::size_t log2_floor(std::size_t x) {
+        std::size_t bits = 0;
+        while (x >>= 1) ++bits;
+        return bits;
+    }
+
+    // Segment k holds indices [BaseCapacity * (2^k - 1), BaseCapacity * (2^(k+1) - 1)).
+    static std::size_t segment_of(std::size_t index) { return log2_floor(index / BaseCapacity + 1); }
+    static std::size_t segment_start(std::size_t segment) { return BaseCapacity * ((std::size_t{1} << segment) - 1); }
+    static std::size_t segment_capacity(std::size_t segment) { return BaseCapacity << segment; }
+
+    // nullptr if the slot's segment has not been allocated yet.
+    Slot* find_slot(std::size_t index) const {
+        const std::size_t segment = segment_of(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        return slots == nullptr ? nullptr : &slots[index - segment_start(segment)];
+    }
+
+    Slot& slot_for_append(std::size_t index) {
+        const std::size_t segment = segment_of(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots == nullptr) {
+            Slot* fresh = new Slot[segment_capacity(segment)];
+            if (segments_[segment].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel)) {
+                slots = fresh;
+            } else {
+                delete[] fresh; // Another appender installed the segment first; `slots` now points to it
+            }
+        }
+        return slots[index - segment_start(segment)];
+    }
+
+    // Moves published_ forward over every consecutive ready slot.
+    void publish() {
+        std::size_t published = published_.load(std::memory_order_seq_cst);
+        while (published < reserved_.load(std::memory_order_acquire)) {
+            const Slot* slot = find_slot(published);
+            if (slot == nullptr || !slot->ready.load(std::memory_order_seq_cst)) return; // Its appender will continue
+            // On failure `published` is reloaded, so a concurrent advance is simply followed.
+            if (published_.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)) ++published;
+        }
+    }
+
+    std::atomic<Slot*> segments_[kMaxSegments];
+    std::atomic<std::size_t> reserved_{0};
+    std::atomic<std::size_t> published_{0};
+};
+
+/*
+Explanation:
+Appending to a `std::string` (or `std::vector`) from several threads needs a lock,
+because a growing container reallocates and moves its contents. Counting its lines
+with `std::count` is O(n) and also needs the lock, so a busy log makes every
+reader slower and every writer blocks all readers.
+
+`AppendLog<T>` avoids both:
+-   Storage is a list of segments of doubling size. Nothing is ever moved, so a
+    reader can safely look at an entry while writers keep appending.
+-   An append reserves an index with one `fetch_add`, constructs the entry in its
+    slot and marks the slot ready. Writers only contend on that one counter.
+-   The published size is the length of the longest fully written prefix. Each
+    appender tries to advance it past its own entry (and any finished entries after
+    it). If an earlier entry is still being written, the appender leaves; the earlier
+    appender will advance over both when it finishes. Nobody waits for anybody:
+    the structure is lock-free.
+-   Readers call `size()` (one atomic load) and then read entries [0, size()).
+
+Limitations: entries cannot be removed or modified (append-only), and memory is
+only released when the log is destroyed.
+
+Usage Example:
+```cpp
+AppendLog<std::string> log;
+log.push_back("Writer 1 wrote value: 1");            // From any thread
+std::size_t entries = log.size();                    // O(1), from any thread
+log.for_each([](const std::string& e) { std::cout << e << '\n'; });
+```
+*/
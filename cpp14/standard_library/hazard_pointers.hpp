@@ -0,0 +1,205 @@
+// hazard_pointers.hpp
+// Hazard pointers: safe memory reclamation for lock-free data structures. A thread
+// announces the nodes it is about to dereference; a removed node is freed only
+// once no thread announces it.
+// - HazardDomain: hazard slots per thread, retire(p), scan()
+// - HazardDomain::Guard: RAII owner of the calling thread's slots; protect(i, src)
+// The per-thread indices come from rcu.hpp (shared with EpochDomain).
+#pragma once
+
+#include <algorithm>  // For std::sort, std::binary_search
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>  // For std::logic_error
+#include <vector>
+
+#include "../../cpp11/standard_library/contention.hpp" // kFalseSharingPad
+#include "rcu.hpp"    // rcu_detail::thread_index, rcu_detail::kMaxThreads
+
+class HazardDomain {
+    struct Record;
+
+public:
+    // Hazard pointers per thread: enough for the structures in lock_free_structures.hpp
+    // (a queue dequeue protects the head and its successor).
+    static constexpr std::size_t kSlotsPerThread = 2;
+
+    HazardDomain() = default;
+    HazardDomain(const HazardDomain&) = delete;
+    HazardDomain& operator=(const HazardDomain&) = delete;
+
+    // No thread may hold a Guard anymore; everything still retired is freed.
+    ~HazardDomain() {
+        for (Record& record : records_) {
+            for (Retired& r : record.retired) r.deleter(r.object);
+        }
+    }
+
+    // A domain for structures that do not need their own.
+    static HazardDomain& global() {
+        static HazardDomain domain;
+        return domain;
+    }
+
+    // The calling thread's hazard slots for the duration of one operation. One Guard
+    // per thread and domain at a time; the slots are cleared on destruction.
+    class Guard {
+    public:
+        explicit Guard(HazardDomain& domain) : record_(&domain.record_for_this_thread()) {
+            if (record_->guarded) throw std::logic_error("HazardDomain::Guard: this thread already holds one");
+            record_->guarded = true;
+        }
+
+        ~Guard() {
+            for (auto& hazard : record_->hazards) hazard.store(nullptr, std::memory_order_release);
+            record_->guarded = false;
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        // Loads `src` and announces the result in slot `i` until the announcement is
+        // known to have happened before any retire() of that pointer: the pointer is
+        // re-read after publishing the hazard, and only a stable value is returned.
+        // The object then stays allocated until the slot is overwritten or cleared.
+        template<typename T>
+        T* protect(std::size_t i, const std::atomic<T*>& src) {
+            T* p = src.load(std::memory_order_relaxed);
+            for (;;) {
+                record_->hazards[i].store(p, std::memory_order_seq_cst);
+                T* q = src.load(std::memory_order_seq_cst);
+                if (q == p) return p;
+                p = q;
+            }
+        }
+
+        void clear(std::size_t i) { record_->hazards[i].store(nullptr, std::memory_order_release); }
+
+    private:
+        Record* record_;
+    };
+
+    // Hands over an object that is no longer reachable from the data structure. It is
+    // deleted by a later scan() once no hazard slot holds it.
+    template<typename T>
+    void retire(T* object) {
+        retire(object, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    void retire(void* object, void (*deleter)(void*)) {
+        Record& record = record_for_this_thread();
+        record.retired.push_back(Retired{object, deleter});
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        // Scanning reads every announced slot, so it runs once per batch that is large
+        // compared with the number of slots: amortized O(1) per retire.
+        if (record.retired.size() >= kScanBase + 2 * kSlotsPerThread * used_records()) scan();
+    }
+
+    // Frees the calling thread's retired objects that no thread currently protects.
+    void scan() {
+        Record& record = record_for_this_thread();
+        std::vector<void*> protected_now;
+        const std::size_t used = used_records();
+        protected_now.reserve(used * kSlotsPerThread);
+        for (std::size_t t = 0; t < used; ++t) {
+            for (const auto& hazard : records_[t].hazards) {
+                if (void* p = hazard.load(std::memory_order_seq_cst)) protected_now.push_back(p);
+            }
+        }
+        std::sort(protected_now.begin(), protected_now.end());
+        std::vector<Retired> keep;
+        std::size_t freed = 0;
+        for (Retired& r : record.retired) {
+            if (std::binary_search(protected_now.begin(), protected_now.end(), r.object)) {
+                keep.push_back(r);
+            } else {
+                r.deleter(r.object);
+                ++freed;
+            }
+        }
+        record.retired.swap(keep);
+        pending_.fetch_sub(freed, std::memory_order_relaxed);
+    }
+
+    // Retired objects not yet freed, over all threads.
+    std::size_t pending() const { return pending_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t kScanBase = 64;
+
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+    };
+
+    // One per thread index. Only the thread owning the index touches `retired` and
+    // `guarded`; the hazards are read by every scanning thread. Padded by
+    // kFalseSharingPad so the slots of different threads never share a cache line.
+    struct Record {
+        std::atomic<void*> hazards[kSlotsPerThread] = {};
+        bool guarded = false;
+        std::vector<Retired> retired; // Objects of an exited thread wait for the index's next owner
+        char padding[kFalseSharingPad];
+    };
+
+    Record& record_for_this_thread() {
+        const std::size_t index = rcu_detail::thread_index();
+        std::size_t used = used_.load(std::memory_order_relaxed);
+        while (used <= index && !used_.compare_exchange_weak(used, index + 1, std::memory_order_seq_cst)) {
+        }
+        return records_[index];
+    }
+
+    // Thread indices are dense, so scans only read records below the highest one used.
+    std::size_t used_records() const { return used_.load(std::memory_order_seq_cst); }
+
+    Record records_[rcu_detail::kMaxThreads];
+    std::atomic<std::size_t> used_{0};
+    std::atomic<std::size_t> pending_{0};
+};
+
+/*
+Explanation:
+A lock-free structure unlinks a node with one compare-and-swap, but other threads
+may have loaded a pointer to that node just before and still be about to read it.
+Deleting it immediately would make them read freed memory (and, if the memory is
+reused, fall for the ABA problem). Safe memory reclamation decides when deletion is
+safe. Two schemes, both in this directory:
+
+Epoch-based reclamation (`EpochDomain`, rcu.hpp):
+-   A thread pins the current epoch for a whole operation; retired nodes are freed
+    once every pinned thread has moved past the epoch of their retirement.
+-   Cheap for readers (one store per operation, no per-node work), but one thread
+    that stays pinned (or is preempted while pinned) holds back all reclamation, so
+    memory is unbounded in the worst case.
+
+Hazard pointers (`HazardDomain`, this file):
+-   Before dereferencing a shared node, a thread writes its address into one of its
+    own hazard slots (`Guard::protect`) and re-checks that the node is still
+    reachable. A retired node is freed by `scan()` only if no slot contains it.
+-   Each protect costs a sequentially consistent store (a full fence on x86) per
+    node, more than an epoch pin, but the number of unreclaimed nodes is bounded
+    (at most the slots in use plus each thread's batch), and a stalled thread
+    holds back only the nodes it protects.
+-   Scans run when a thread's retired list reaches a batch size proportional to the
+    number of slots, so each retire costs O(1) amortized.
+
+Both share the thread indices of rcu.hpp (at most 256 threads at once).
+`lock_free_structures.hpp` builds a Treiber stack and a Michael-Scott queue on either
+scheme; `bench/bench_reclamation.cpp` compares them with
+`std::atomic<std::shared_ptr<T>>` versions.
+
+Usage Example:
+```cpp
+HazardDomain& domain = HazardDomain::global();
+std::atomic<Node*> head;
+{
+    HazardDomain::Guard guard(domain);
+    Node* n = guard.protect(0, head);        // Safe to dereference while protected
+    if (n && head.compare_exchange_strong(n, n->next)) {
+        guard.clear(0);
+        domain.retire(n);                    // Deleted once no thread protects it
+    }
+}
+```
+*/
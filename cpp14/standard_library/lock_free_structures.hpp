@@ -0,0 +1,260 @@
+// lock_free_structures.hpp
+// Lock-free stack and queue whose nodes are reclaimed safely, with the reclamation
+// scheme as a policy.
+// - LockFreeStack<T, Reclamation>: Treiber stack (push/try_pop)
+// - LockFreeQueue<T, Reclamation>: Michael-Scott queue (push/try_pop), multi-producer
+//   multi-consumer, unbounded
+// - HazardReclamation: hazard pointers (hazard_pointers.hpp), the default
+// - EpochReclamation: epoch-based reclamation (EpochDomain in rcu.hpp)
+#pragma once
+
+#include <atomic>
+#include <new>          // For placement new
+#include <type_traits>  // For std::aligned_storage
+#include <utility>      // For std::move
+
+#include "../../cpp11/standard_library/contention.hpp" // kFalseSharingPad
+#include "hazard_pointers.hpp" // HazardDomain
+#include "rcu.hpp"             // EpochDomain
+
+// A reclamation policy provides:
+//   Domain                      where retired nodes wait
+//   Guard(Domain&)              held for the duration of one operation
+//   guard.protect(i, atomic)    a pointer that stays valid while the guard lives
+//   guard.clear(i)              drops protection i early
+//   retire(domain, node)        frees the node once no guard can still use it
+struct HazardReclamation {
+    using Domain = HazardDomain;
+    using Guard = HazardDomain::Guard;
+
+    static Domain& default_domain() { return HazardDomain::global(); }
+
+    template<typename Node>
+    static void retire(Domain& domain, Node* node) { domain.retire(node); }
+};
+
+struct EpochReclamation {
+    using Domain = EpochDomain;
+
+    // Pinning protects every node reachable during the operation, so protect() is a
+    // plain load.
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) : guard_(domain) {}
+
+        template<typename T>
+        T* protect(std::size_t, const std::atomic<T*>& src) { return src.load(std::memory_order_seq_cst); }
+
+        void clear(std::size_t) {}
+
+    private:
+        EpochDomain::Guard guard_;
+    };
+
+    static Domain& default_domain() { return EpochDomain::global(); }
+
+    template<typename Node>
+    static void retire(Domain& domain, Node* node) { domain.retire(node); }
+};
+
+template<typename T, typename Reclamation = HazardReclamation>
+class LockFreeStack {
+public:
+    explicit LockFreeStack(typename Reclamation::Domain& domain = Reclamation::default_domain())
+        : domain_(domain), head_(nullptr) {}
+
+    // No other thread may use the stack anymore.
+    ~LockFreeStack() {
+        Node* n = head_.load(std::memory_order_relaxed);
+        while (n != nullptr) {
+            Node* next = n->next;
+            delete n;
+            n = next;
+        }
+    }
+
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool try_pop(T& out) {
+        typename Reclamation::Guard guard(domain_);
+        for (;;) {
+            Node* top = guard.protect(0, head_); // top cannot be freed (or reused: no ABA) while protected
+            if (top == nullptr) return false;
+            Node* next = top->next;
+            if (head_.compare_exchange_weak(top, next, std::memory_order_acquire, std::memory_order_relaxed)) {
+                out = std::move(top->value); // Only the winning thread touches the value
+                guard.clear(0);
+                Reclamation::retire(domain_, top);
+                return true;
+            }
+        }
+    }
+
+    // A snapshot: may be outdated as soon as it returns.
+    bool empty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    struct Node {
+        explicit Node(T v) : value(std::move(v)), next(nullptr) {}
+        T value;
+        Node* next;
+    };
+
+    typename Reclamation::Domain& domain_;
+    std::atomic<Node*> head_;
+};
+
+template<typename T, typename Reclamation = HazardReclamation>
+class LockFreeQueue {
+public:
+    explicit LockFreeQueue(typename Reclamation::Domain& domain = Reclamation::default_domain())
+        : domain_(domain) {
+        Node* dummy = new Node();
+        head_.store(dummy, std::memory_order_relaxed);
+        tail_.store(dummy, std::memory_order_relaxed);
+    }
+
+    // No other thread may use the queue anymore. Destroys the values still queued.
+    ~LockFreeQueue() {
+        Node* n = head_.load(std::memory_order_relaxed);
+        bool has_value = false; // The dummy holds no value
+        while (n != nullptr) {
+            Node* next = n->next.load(std::memory_order_relaxed);
+            delete_node(n, has_value);
+            has_value = true;
+            n = next;
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node();
+        ::new (static_cast<void*>(&node->storage)) T(std::move(value));
+        typename Reclamation::Guard guard(domain_);
+        for (;;) {
+            Node* tail = guard.protect(0, tail_);
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (tail != tail_.load(std::memory_order_acquire)) continue;
+            if (next == nullptr) {
+                if (tail->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed)) {
+                    // Swing the tail; if this fails, another thread already helped.
+                    tail_.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+                    return;
+                }
+            } else {
+                // The tail lags behind: help the pushing thread that linked `next`.
+                tail_.compare_exchange_strong(tail, next, std::memory_order_release, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        typename Reclamation::Guard guard(domain_);
+        for (;;) {
+            Node* head = guard.protect(0, head_);
+            Node* next = guard.protect(1, head->next);
+            if (head != head_.load(std::memory_order_acquire)) continue; // head was retired meanwhile
+            if (next == nullptr) return false;
+            Node* tail = tail_.load(std::memory_order_acquire);
+            if (head == tail) {
+                tail_.compare_exchange_strong(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                // `next` is the new dummy; its value belongs to this thread alone and it
+                // stays allocated while protected (slot 1).
+                T* value = reinterpret_cast<T*>(&next->storage);
+                out = std::move(*value);
+                value->~T();
+                guard.clear(0);
+                Reclamation::retire(domain_, head);
+                return true;
+            }
+        }
+    }
+
+    // A snapshot: may be outdated as soon as it returns. The head is protected like
+    // in try_pop(), since a concurrent pop may retire it while its `next` is read.
+    bool empty() const {
+        typename Reclamation::Guard guard(domain_);
+        Node* head = guard.protect(0, head_);
+        return head->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    // The first node is always a dummy whose value was already taken (or never set),
+    // so push and pop work on different ends without special cases.
+    struct Node {
+        Node() : next(nullptr) {}
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::atomic<Node*> next;
+    };
+
+    static void delete_node(Node* n, bool has_value) {
+        if (has_value) reinterpret_cast<T*>(&n->storage)->~T();
+        delete n;
+    }
+
+    typename Reclamation::Domain& domain_;
+    // Head and tail are written by different threads (consumers, producers), so each
+    // gets its own kFalseSharingPad.
+    char padding0_[kFalseSharingPad];
+    std::atomic<Node*> head_;
+    char padding1_[kFalseSharingPad - sizeof(std::atomic<Node*>)];
+    std::atomic<Node*> tail_;
+    char padding2_[kFalseSharingPad - sizeof(std::atomic<Node*>)];
+};
+
+/*
+Explanation:
+Both structures are the classic lock-free designs; what makes them usable in C++ is
+the reclamation policy, which answers "when may a popped node be deleted?":
+-   `LockFreeStack` (Treiber): push links a new node in front of the head with a CAS;
+    pop reads the head, reads its `next`, and swings the head with a CAS. Between
+    reading the head and reading `next`, another thread may pop and delete that node;
+    with a protected head (hazard pointer or epoch pin) it cannot be deleted, and
+    since it cannot be reused either, the CAS cannot succeed on a recycled address
+    (the ABA problem).
+-   `LockFreeQueue` (Michael-Scott): a linked list with a dummy head node. Producers
+    link at the tail and swing `tail_`; consumers swing `head_` to the next node,
+    which becomes the new dummy, and take its value. A thread that finds `tail_`
+    lagging helps by advancing it, so no thread ever waits for another.
+    A pop protects two nodes (head and next), hence two hazard slots per thread.
+
+Policies:
+-   `HazardReclamation` (default): per-node protection, bounded garbage, a seq_cst
+    store per protected pointer.
+-   `EpochReclamation`: reuses `EpochDomain` from rcu.hpp. A pin per operation and
+    plain loads, but retire() there takes a mutex and a type-erased deleter per node,
+    and a preempted thread delays all reclamation.
+
+Why not `std::atomic<std::shared_ptr<Node>>` (C++20)? It makes reclamation automatic
+(the reference count keeps a node alive while anyone holds it), but libstdc++
+implements it with a lock (a spin lock in the control-block pointer's low bit) and
+every load is a reference-count increment plus decrement on a shared cache line.
+`bench/bench_reclamation.cpp` compares both policies with stack and queue versions
+built on `std::atomic<std::shared_ptr>`.
+
+Usage Example:
+```cpp
+LockFreeQueue<std::string> queue;                  // Hazard pointers, global domain
+queue.push("message");
+std::string out;
+if (queue.try_pop(out)) std::cout << out << '\n';
+
+LockFreeStack<int, EpochReclamation> stack;        // Epoch-based reclamation
+stack.push(42);
+int top;
+stack.try_pop(top);
+```
+*/
@@ -0,0 +1,328 @@
+// object_pool.hpp
+// Typed object pool with per-thread caches for create/destroy-heavy code paths.
+// - ObjectPool<T>: fixed-size slots carved from large chunks; freed slots are reused
+//   - make_unique(args...): std::unique_ptr<T, ObjectPool<T>::Deleter>, which
+//     returns the slot to the pool (like WidgetDeleter in std_make_unique.cpp)
+//   - make_shared(args...): std::shared_ptr<T> with the same deleter
+//   - create(args...) / destroy(p): the raw interface
+// - ObjectPoolOptions: batch size (slots moved between a thread and the pool at
+//   once) and chunk size
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>      // For std::unique_ptr, std::shared_ptr
+#include <mutex>
+#include <new>         // For ::operator new, placement new
+#include <type_traits> // For std::aligned_storage, std::is_same
+#include <utility>     // For std::forward
+#include <vector>
+
+namespace object_pool_detail {
+
+// A free slot holds the link to the next free slot in its own storage.
+struct FreeNode {
+    FreeNode* next;
+};
+
+struct FreeList {
+    FreeNode* head = nullptr;
+    std::size_t count = 0;
+
+    void push(void* p) {
+        FreeNode* node = static_cast<FreeNode*>(p);
+        node->next = head;
+        head = node;
+        ++count;
+    }
+
+    void* pop() {
+        FreeNode* node = head;
+        head = node->next;
+        --count;
+        return node;
+    }
+
+    // Detaches the first `n` nodes (n <= count) as a list of their own.
+    FreeList split(std::size_t n) {
+        FreeList front;
+        front.head = head;
+        front.count = n;
+        FreeNode* last = head;
+        for (std::size_t i = 1; i < n; ++i) last = last->next;
+        head = last->next;
+        last->next = nullptr;
+        count -= n;
+        return front;
+    }
+};
+
+// The shared part of a pool: owns the chunks and the batches of free slots that no
+// thread caches. Every access takes the mutex, but threads only come here once per
+// batch. Kept alive by shared_ptr from the pool and from the thread caches, so a
+// thread that exits after its pool is gone can still tell that it must not give its
+// slots back.
+class Depot {
+public:
+    Depot(std::size_t slot_size, std::size_t batch, std::size_t chunk_slots)
+        : slot_size_(slot_size), batch_(batch), chunk_slots_(chunk_slots) {}
+
+    ~Depot() { close(); }
+
+    Depot(const Depot&) = delete;
+    Depot& operator=(const Depot&) = delete;
+
+    // A batch of free slots; carves a new chunk if none is left.
+    FreeList take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (batches_.empty()) carve();
+        FreeList list = batches_.back();
+        batches_.pop_back();
+        return list;
+    }
+
+    void give(const FreeList& list) {
+        if (list.count == 0) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!closed_.load(std::memory_order_relaxed)) batches_.push_back(list);
+    }
+
+    // Frees all chunks; slots still cached by threads are forgotten.
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_.store(true, std::memory_order_release);
+        batches_.clear();
+        for (void* chunk : chunks_) ::operator delete(chunk);
+        chunks_.clear();
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+    std::size_t batch() const { return batch_; }
+
+    std::size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return chunks_.size() * chunk_slots_;
+    }
+
+private:
+    void carve() {
+        char* chunk = static_cast<char*>(::operator new(slot_size_ * chunk_slots_));
+        chunks_.push_back(chunk);
+        // Batches are pushed from the end of the chunk, so the first one handed out
+        // starts at the chunk's beginning and walks it in address order.
+        for (std::size_t end = chunk_slots_; end > 0;) {
+            const std::size_t begin = end > batch_ ? end - batch_ : 0;
+            FreeList list;
+            for (std::size_t i = end; i > begin; --i) list.push(chunk + (i - 1) * slot_size_);
+            batches_.push_back(list);
+            end = begin;
+        }
+    }
+
+    const std::size_t slot_size_;
+    const std::size_t batch_;
+    const std::size_t chunk_slots_;
+    mutable std::mutex mutex_;
+    std::atomic<bool> closed_{false};
+    std::vector<FreeList> batches_;
+    std::vector<void*> chunks_;
+};
+
+// One thread's free slots for one pool. When the thread exits, they go back to the
+// depot (unless the pool was destroyed meanwhile).
+struct Cache {
+    explicit Cache(std::shared_ptr<Depot> d) : depot(std::move(d)) {}
+    ~Cache() { depot->give(free); }
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    FreeList free;
+    std::shared_ptr<Depot> depot;
+};
+
+// The caches of the current thread, one per pool it has used (keyed by pool id; ids
+// are never reused, so a new pool at the address of a destroyed one cannot pick up
+// the old cache).
+struct ThreadCaches {
+    std::vector<std::pair<std::uint64_t, std::unique_ptr<Cache>>> caches;
+    std::uint64_t last_id = 0; // Most recently used entry: the common case of one pool
+    Cache* last = nullptr;
+};
+
+inline ThreadCaches& thread_caches() {
+    thread_local ThreadCaches caches;
+    return caches;
+}
+
+inline std::uint64_t next_pool_id() {
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+}
+
+inline Cache& cache_for(std::uint64_t id, const std::shared_ptr<Depot>& depot) {
+    ThreadCaches& mine = thread_caches();
+    if (mine.last_id == id) return *mine.last;
+    Cache* found = nullptr;
+    for (auto& entry : mine.caches) {
+        if (entry.first == id) found = entry.second.get();
+    }
+    if (found == nullptr) {
+        // First use of this pool by this thread: forget caches of destroyed pools.
+        for (std::size_t i = 0; i < mine.caches.size();) {
+            if (mine.caches[i].second->depot->closed()) {
+                mine.caches[i] = std::move(mine.caches.back());
+                mine.caches.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        mine.caches.emplace_back(id, std::unique_ptr<Cache>(new Cache(depot)));
+        found = mine.caches.back().second.get();
+    }
+    mine.last_id = id;
+    mine.last = found;
+    return *found;
+}
+
+} // namespace object_pool_detail
+
+struct ObjectPoolOptions {
+    std::size_t batch = 64;        // Slots a thread takes from / returns to the pool at once
+    std::size_t chunk_slots = 1024; // Slots per chunk allocated from operator new
+};
+
+template<typename T>
+class ObjectPool {
+    // Storage for one T, or the free-list link while the slot is unused.
+    union Slot {
+        object_pool_detail::FreeNode node;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+public:
+    // Destroys the object and returns its slot, like WidgetDeleter does with delete.
+    class Deleter {
+    public:
+        Deleter() : pool_(nullptr) {}
+        explicit Deleter(ObjectPool* pool) : pool_(pool) {}
+        void operator()(T* p) const { pool_->destroy(p); }
+
+    private:
+        ObjectPool* pool_;
+    };
+
+    using UniquePtr = std::unique_ptr<T, Deleter>;
+
+    explicit ObjectPool(const ObjectPoolOptions& options = ObjectPoolOptions())
+        : id_(object_pool_detail::next_pool_id()),
+          depot_(std::make_shared<object_pool_detail::Depot>(sizeof(Slot), options.batch < 1 ? 1 : options.batch,
+                                                             options.chunk_slots < 1 ? 1 : options.chunk_slots)) {}
+
+    // Every object must have been destroyed; slots cached by other threads are
+    // released with the chunks.
+    ~ObjectPool() { depot_->close(); }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        void* p = allocate();
+        try {
+            return ::new (p) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(p);
+            throw;
+        }
+    }
+
+    // May be called from any thread; the slot goes to that thread's cache.
+    void destroy(T* p) {
+        if (p == nullptr) return;
+        p->~T();
+        deallocate(p);
+    }
+
+    // pool.make_unique<Widget>(...) and pool.make_unique(...) mean the same.
+    template<typename U = T, typename... Args>
+    UniquePtr make_unique(Args&&... args) {
+        static_assert(std::is_same<U, T>::value, "ObjectPool<T> only creates T");
+        return UniquePtr(create(std::forward<Args>(args)...), Deleter(this));
+    }
+
+    // The object comes from the pool, the control block still from operator new.
+    template<typename U = T, typename... Args>
+    std::shared_ptr<T> make_shared(Args&&... args) {
+        static_assert(std::is_same<U, T>::value, "ObjectPool<T> only creates T");
+        return std::shared_ptr<T>(make_unique(std::forward<Args>(args)...));
+    }
+
+    // Slots carved so far (live objects plus free slots).
+    std::size_t capacity() const { return depot_->capacity(); }
+
+private:
+    void* allocate() {
+        object_pool_detail::Cache& cache = object_pool_detail::cache_for(id_, depot_);
+        if (cache.free.count == 0) cache.free = depot_->take();
+        return cache.free.pop();
+    }
+
+    void deallocate(void* p) {
+        object_pool_detail::Cache& cache = object_pool_detail::cache_for(id_, depot_);
+        cache.free.push(p);
+        // Bounded cache: a thread that only frees (consumer of another thread's
+        // objects) hands full batches back instead of hoarding them.
+        if (cache.free.count >= 2 * depot_->batch()) depot_->give(cache.free.split(depot_->batch()));
+    }
+
+    const std::uint64_t id_;
+    const std::shared_ptr<object_pool_detail::Depot> depot_;
+};
+
+/*
+Explanation:
+`std::make_unique<Widget>(...)` calls the global `operator new` once per object, and
+the unique_ptr's destructor calls `operator delete`. General-purpose allocators are
+fast, but they handle every size, keep per-size bookkeeping, and may return memory
+to the system or take locks under contention. Code that creates and destroys many
+objects of one type (messages, tasks, nodes) can do better with a pool.
+
+`ObjectPool<T>`:
+-   Slots of exactly `sizeof(T)` are carved from chunks of `chunk_slots` slots. A
+    free slot stores the link to the next free slot in itself, so free lists cost
+    no extra memory. Destroying an object pushes its slot onto a free list; the
+    next create pops it again (still warm in the cache).
+-   Each thread has its own free list per pool (thread-local, no locks, no atomics).
+    Threads exchange slots with the shared depot in batches of `batch`: a thread
+    with an empty list takes a batch, a thread that accumulated two batches (because
+    it destroys objects another thread created) gives one back. The depot's mutex is
+    taken once per batch, not once per object.
+-   `make_unique` returns `std::unique_ptr<T, ObjectPool<T>::Deleter>`: the custom
+    deleter pattern of `WidgetDeleter` in std_make_unique.cpp, with a deleter that
+    returns the slot instead of calling `delete`. The deleter holds a pointer to the
+    pool, so the unique_ptr is two pointers wide.
+-   `make_shared` wraps such a unique_ptr in a `std::shared_ptr`; its control block
+    is still allocated with `operator new` (std::allocate_shared would need slots of
+    the control block's size).
+
+Rules: the pool must outlive every object created from it (destroy them before the
+pool); the pool never returns chunks to the system before it is destroyed; slots
+cached by a thread go back to the depot when that thread exits.
+
+`bench/bench_object_pool.cpp` compares churn-heavy create/destroy loops with
+`std::make_unique`.
+
+Usage Example:
+```cpp
+ObjectPool<Widget> pool;
+{
+    auto w = pool.make_unique<Widget>(1, "Pooled");  // unique_ptr<Widget, ObjectPool<Widget>::Deleter>
+    w->show();
+}                                                   // ~Widget(), slot back in the pool
+auto again = pool.make_unique<Widget>(2, "Reused"); // Same slot, no operator new
+std::shared_ptr<Widget> shared = pool.make_shared<Widget>(3, "Shared");
+```
+*/
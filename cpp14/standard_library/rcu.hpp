@@ -0,0 +1,334 @@
+// rcu.hpp
+// Read-copy-update for read-mostly shared state: readers pin an epoch and read the
+// current version without locks or retries (wait-free), writers publish a new
+// version with one atomic swap and the old one is freed after a grace period.
+// - EpochDomain: epoch-based reclamation (pin/unpin, retire, synchronize)
+// - RcuCell<T>: one published T, updated copy-on-write
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // For std::function
+#include <memory>      // For std::unique_ptr
+#include <mutex>
+#include <stdexcept>   // For std::runtime_error
+#include <utility>     // For std::move
+#include <vector>
+
+#include "../../cpp11/standard_library/contention.hpp" // SpinBackoff, kFalseSharingPad
+
+namespace rcu_detail {
+
+constexpr std::size_t kMaxThreads = 256;
+
+// Process-wide registry of thread indices. A thread claims the lowest free index on
+// its first read-side critical section and returns it when it exits, so indices
+// stay dense and every domain can use a fixed array of per-thread slots.
+class ThreadRegistry {
+public:
+    static ThreadRegistry& instance() {
+        static ThreadRegistry registry;
+        return registry;
+    }
+
+    std::size_t claim() {
+        for (std::size_t i = 0; i < kMaxThreads; ++i) {
+            bool expected = false;
+            if (!used_[i].load(std::memory_order_relaxed) &&
+                used_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return i;
+            }
+        }
+        throw std::runtime_error("rcu: more than 256 threads use read-side critical sections at once");
+    }
+
+    void release(std::size_t index) { used_[index].store(false, std::memory_order_release); }
+
+private:
+    ThreadRegistry() {
+        for (auto& u : used_) u.store(false, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> used_[kMaxThreads];
+};
+
+class ThreadIndex {
+public:
+    ThreadIndex() : index_(ThreadRegistry::instance().claim()) {}
+    ~ThreadIndex() { ThreadRegistry::instance().release(index_); }
+    std::size_t get() const { return index_; }
+
+private:
+    std::size_t index_;
+};
+
+inline std::size_t thread_index() {
+    thread_local ThreadIndex index;
+    return index.get();
+}
+
+} // namespace rcu_detail
+
+// Epoch-based reclamation. A reader announces the current epoch in its own slot
+// while it may hold pointers to shared objects (pin), and clears it afterwards.
+// A writer that unlinked an object retires it with the epoch of the unlinking; the
+// object is deleted once no slot shows that epoch or an older one, i.e. once every
+// reader that might have seen it has left its critical section (the grace period).
+class EpochDomain {
+public:
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // No reader may be pinned anymore; everything still retired is freed.
+    ~EpochDomain() {
+        for (Retired& r : retired_) r.deleter();
+    }
+
+    // A domain for objects that do not need their own.
+    static EpochDomain& global() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    // RAII read-side critical section. Pinning is a load and a store, never waits,
+    // and may be nested.
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) : domain_(&domain) { domain_->pin(); }
+        ~Guard() { if (domain_) domain_->unpin(); }
+        Guard(Guard&& other) noexcept : domain_(other.domain_) { other.domain_ = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+    private:
+        EpochDomain* domain_;
+    };
+
+    Guard pin_guard() { return Guard(*this); }
+
+    void pin() {
+        Slot& slot = slots_[rcu_detail::thread_index()];
+        if (slot.nesting++ == 0) {
+            // seq_cst: the announcement must be visible before this reader loads any
+            // shared pointer, or a writer could miss it (see synchronize()).
+            slot.epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+    }
+
+    void unpin() {
+        Slot& slot = slots_[rcu_detail::thread_index()];
+        if (--slot.nesting == 0) slot.epoch.store(kQuiescent, std::memory_order_release);
+    }
+
+    // Schedules deleter() to run after the grace period of an object that is no longer
+    // reachable for new readers. Frees older retired objects when possible.
+    void retire(std::function<void()> deleter) {
+        const std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> lock(retired_mutex_);
+            retired_.push_back(Retired{epoch, std::move(deleter)});
+            if (retired_.size() < reclaim_at_) return;
+            ready = take_reclaimable(oldest_pinned_epoch());
+            // While a pinned reader holds reclamation back, the list only grows; scanning
+            // again only after it doubled keeps retire() amortized O(1).
+            update_reclaim_threshold();
+        }
+        for (Retired& r : ready) r.deleter(); // Deleters run outside the lock
+    }
+
+    template<typename T>
+    void retire(T* object) {
+        retire([object] { delete object; });
+    }
+
+    // Blocks until every reader that was pinned at the time of the call has unpinned,
+    // then frees everything retired before the call. Must not be called while pinned.
+    void synchronize() {
+        const std::uint64_t target = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        for (Slot& slot : slots_) {
+            SpinBackoff backoff;
+            for (;;) {
+                const std::uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+                if (e == kQuiescent || e >= target) break;
+                backoff.pause();
+            }
+        }
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> lock(retired_mutex_);
+            ready = take_reclaimable(target);
+            update_reclaim_threshold();
+        }
+        for (Retired& r : ready) r.deleter();
+    }
+
+    // Number of retired objects that are still waiting for their grace period.
+    std::size_t pending() const {
+        std::lock_guard<std::mutex> lock(retired_mutex_);
+        return retired_.size();
+    }
+
+private:
+    static constexpr std::uint64_t kQuiescent = 0;
+    static constexpr std::size_t kReclaimBatch = 64;
+
+    // Padded to kFalseSharingPad so readers announcing their epochs never share a cache line.
+    struct Slot {
+        std::atomic<std::uint64_t> epoch{kQuiescent};
+        unsigned nesting = 0; // Only touched by the owning thread
+        char padding[kFalseSharingPad - sizeof(std::atomic<std::uint64_t>) - sizeof(unsigned)];
+    };
+
+    struct Retired {
+        std::uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    // Objects retired at epoch e are safe to free when every pinned reader announced an epoch > e.
+    std::uint64_t oldest_pinned_epoch() const {
+        std::uint64_t oldest = UINT64_MAX;
+        for (const Slot& slot : slots_) {
+            const std::uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+            if (e != kQuiescent && e < oldest) oldest = e;
+        }
+        return oldest;
+    }
+
+    // Caller holds retired_mutex_.
+    void update_reclaim_threshold() {
+        const std::size_t twice = 2 * retired_.size();
+        reclaim_at_ = twice > kReclaimBatch ? twice : kReclaimBatch;
+    }
+
+    // Caller holds retired_mutex_.
+    std::vector<Retired> take_reclaimable(std::uint64_t safe_before) {
+        std::vector<Retired> ready, keep;
+        for (Retired& r : retired_) (r.epoch < safe_before ? ready : keep).push_back(std::move(r));
+        retired_.swap(keep);
+        return ready;
+    }
+
+    std::atomic<std::uint64_t> epoch_{1}; // 0 is kQuiescent
+    Slot slots_[rcu_detail::kMaxThreads];
+    mutable std::mutex retired_mutex_;
+    std::vector<Retired> retired_;
+    std::size_t reclaim_at_ = kReclaimBatch; // Size of retired_ that triggers the next scan
+};
+
+// A single RCU-protected value. read() pins the domain and returns a handle to the
+// current version, which stays valid (and unchanged) for the handle's lifetime, even
+// if writers publish newer versions meanwhile. Writers copy, modify and publish;
+// they are serialized by a mutex so that no update is lost.
+template<typename T>
+class RcuCell {
+public:
+    class ReadHandle {
+    public:
+        const T& operator*() const { return *value_; }
+        const T* operator->() const { return value_; }
+        const T* get() const { return value_; }
+
+    private:
+        friend class RcuCell;
+        ReadHandle(EpochDomain::Guard guard, const T* value) : guard_(std::move(guard)), value_(value) {}
+
+        EpochDomain::Guard guard_;
+        const T* value_;
+    };
+
+    explicit RcuCell(T initial, EpochDomain& domain = EpochDomain::global())
+        : domain_(domain), current_(new T(std::move(initial))) {}
+
+    ~RcuCell() {
+        // Versions retired earlier may still be in the domain; the current one is ours.
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // Wait-free: one epoch announcement and one pointer load.
+    ReadHandle read() const {
+        EpochDomain::Guard guard(domain_);
+        return ReadHandle(std::move(guard), current_.load(std::memory_order_seq_cst));
+    }
+
+    // A copy of the current version.
+    T snapshot() const { return *read(); }
+
+    // Publishes a new version built by the caller.
+    void store(T value) {
+        std::unique_ptr<T> fresh(new T(std::move(value)));
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        publish(std::move(fresh));
+    }
+
+    // Copy-on-write update: f modifies a private copy of the current version, which
+    // is then published. Readers keep seeing the old version until the swap.
+    template<typename F>
+    void update(F f) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        std::unique_ptr<T> fresh(new T(*current_.load(std::memory_order_relaxed)));
+        f(*fresh);
+        publish(std::move(fresh));
+    }
+
+    EpochDomain& domain() const { return domain_; }
+
+private:
+    // Caller holds writer_mutex_.
+    void publish(std::unique_ptr<T> fresh) {
+        const T* old = current_.exchange(fresh.release(), std::memory_order_seq_cst);
+        domain_.retire(const_cast<T*>(old));
+    }
+
+    EpochDomain& domain_;
+    std::atomic<const T*> current_;
+    std::mutex writer_mutex_;
+};
+
+/*
+Explanation:
+Read-copy-update (RCU) splits shared state into immutable versions:
+-   Readers load a pointer to the current version and use it. They never write to
+    shared memory except their own epoch slot, never wait, and never retry.
+-   Writers copy the current version, modify the copy, and publish it with one atomic
+    pointer swap. Readers that started before the swap keep using the old version;
+    readers that start afterwards see the new one. Each reader sees a consistent
+    snapshot, never a half-updated state.
+-   The hard part is knowing when the old version can be deleted: some reader might
+    still be using it. That is what the epoch domain solves.
+
+Epoch-based reclamation (`EpochDomain`):
+-   A global epoch counter. A reader copies it into its own (padded) slot when it
+    enters a critical section and clears the slot when it leaves.
+-   `retire()` records the epoch at which an object was unlinked and advances the epoch.
+    Readers that pin later cannot reach the object anymore.
+-   The object may be freed once every slot is empty or shows a newer epoch: all
+    readers that could have seen it are gone. Retired objects are freed in batches;
+    `synchronize()` waits for the grace period explicitly.
+-   Readers and writers use sequentially consistent operations for the slot and the
+    pointer, so a writer either sees a reader's announcement or the reader sees the
+    new pointer (never neither).
+
+Costs: every update allocates and copies the whole value, and a reader that stays
+pinned for a long time delays reclamation (memory grows, nothing breaks). RCU pays
+off when reads vastly outnumber writes. Threads that pin are limited to 256 at once.
+
+Usage Example:
+```cpp
+struct Config { int value; std::vector<std::string> log; };
+RcuCell<Config> config(Config{0, {}});
+
+// Reader (any thread, wait-free):
+auto snap = config.read();
+std::cout << snap->value << " " << snap->log.size() << '\n';
+
+// Writer:
+config.update([](Config& c) { c.value++; c.log.push_back("incremented"); });
+```
+*/
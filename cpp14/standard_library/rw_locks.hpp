@@ -0,0 +1,339 @@
+// rw_locks.hpp
+// Reader-writer locks that scale better than std::shared_timed_mutex for read-mostly data:
+// - DistributedSharedMutex: per-slot reader counters, readers never share a cache line
+// - TicketRWLock: writer-preferring lock, writers served in FIFO (ticket) order
+// - SeqLock<T>: optimistic, lock-free reads of a small trivially copyable value
+// The two mutexes meet the SharedTimedMutex requirements, so they work with
+// std::unique_lock, std::shared_lock and std::lock_guard like std::shared_timed_mutex.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>     // For std::memcpy
+#include <mutex>       // For std::mutex, std::lock_guard
+#include <type_traits> // For std::is_trivially_copyable
+
+#include "../../cpp11/standard_library/contention.hpp" // SpinBackoff, kFalseSharingPad
+
+namespace rw_detail {
+
+// Hands out a small per-thread number once; used to pick a reader slot.
+inline unsigned thread_slot() {
+    static std::atomic<unsigned> next{0};
+    thread_local unsigned slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+// Adds the timed members of SharedTimedMutex on top of try_lock()/try_lock_shared().
+template<typename Derived>
+class TimedTryLocks {
+public:
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return try_lock_until(std::chrono::steady_clock::now() + timeout);
+    }
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        return retry_until(deadline, [this] { return self().try_lock(); });
+    }
+    template<typename Rep, typename Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + timeout);
+    }
+    template<typename Clock, typename Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        return retry_until(deadline, [this] { return self().try_lock_shared(); });
+    }
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+
+    template<typename Clock, typename Duration, typename TryFn>
+    static bool retry_until(const std::chrono::time_point<Clock, Duration>& deadline, TryFn try_fn) {
+        SpinBackoff backoff;
+        for (;;) {
+            if (try_fn()) return true;
+            if (Clock::now() >= deadline) return false;
+            backoff.pause();
+        }
+    }
+};
+
+} // namespace rw_detail
+
+// Readers register in one of kSlots counters chosen by thread, so concurrent readers
+// on different cores touch different cache lines. A writer raises a flag and waits
+// until every counter drops to zero; this makes writes more expensive, which is the
+// intended trade-off for data that is read far more often than written.
+class DistributedSharedMutex : public rw_detail::TimedTryLocks<DistributedSharedMutex> {
+public:
+    static constexpr std::size_t kSlots = 64;
+
+    DistributedSharedMutex() = default;
+    DistributedSharedMutex(const DistributedSharedMutex&) = delete;
+    DistributedSharedMutex& operator=(const DistributedSharedMutex&) = delete;
+
+    void lock() {
+        writer_mutex_.lock(); // Writers queue up here, readers never touch it
+        writer_.store(true, std::memory_order_seq_cst);
+        for (Slot& slot : slots_) {
+            SpinBackoff backoff;
+            while (slot.readers.load(std::memory_order_seq_cst) != 0) backoff.pause();
+        }
+    }
+
+    bool try_lock() {
+        if (!writer_mutex_.try_lock()) return false;
+        writer_.store(true, std::memory_order_seq_cst);
+        for (Slot& slot : slots_) {
+            if (slot.readers.load(std::memory_order_seq_cst) != 0) {
+                unlock();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock() {
+        writer_.store(false, std::memory_order_release);
+        writer_mutex_.unlock();
+    }
+
+    void lock_shared() {
+        std::atomic<int>& readers = my_slot().readers;
+        SpinBackoff backoff;
+        for (;;) {
+            // Announce first, then check: a writer that raised its flag before our
+            // increment sees it; otherwise we see the writer's flag and back off.
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writer_.load(std::memory_order_seq_cst)) return;
+            readers.fetch_sub(1, std::memory_order_release);
+            while (writer_.load(std::memory_order_relaxed)) backoff.pause();
+        }
+    }
+
+    bool try_lock_shared() {
+        std::atomic<int>& readers = my_slot().readers;
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        if (!writer_.load(std::memory_order_seq_cst)) return true;
+        readers.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void unlock_shared() {
+        my_slot().readers.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    // One kFalseSharingPad per slot, so no two reader counters share a cache line.
+    struct Slot {
+        std::atomic<int> readers{0};
+        char padding[kFalseSharingPad - sizeof(std::atomic<int>)];
+    };
+
+    Slot& my_slot() { return slots_[rw_detail::thread_slot() % kSlots]; }
+
+    Slot slots_[kSlots];
+    std::atomic<bool> writer_{false};
+    std::mutex writer_mutex_;
+};
+
+// Writer-preferring reader-writer lock. Writers draw a ticket and are served in
+// order; while any writer holds or waits for a ticket, new readers wait. Under a
+// steady stream of writes readers can starve, under reads writers cannot.
+// All state is in one cache line, so it is cheap to create but readers still
+// contend on readers_; prefer DistributedSharedMutex for many concurrent readers.
+class TicketRWLock : public rw_detail::TimedTryLocks<TicketRWLock> {
+public:
+    TicketRWLock() = default;
+    TicketRWLock(const TicketRWLock&) = delete;
+    TicketRWLock& operator=(const TicketRWLock&) = delete;
+
+    void lock() {
+        const unsigned ticket = next_ticket_.fetch_add(1, std::memory_order_seq_cst);
+        SpinBackoff backoff;
+        while (now_serving_.load(std::memory_order_acquire) != ticket) backoff.pause();
+        while (readers_.load(std::memory_order_seq_cst) != 0) backoff.pause();
+    }
+
+    bool try_lock() {
+        unsigned serving = now_serving_.load(std::memory_order_acquire);
+        unsigned expected = serving;
+        if (!next_ticket_.compare_exchange_strong(expected, serving + 1, std::memory_order_seq_cst)) {
+            return false; // Another writer holds or waits for the lock
+        }
+        if (readers_.load(std::memory_order_seq_cst) != 0) {
+            unlock(); // Give the ticket back by serving it
+            return false;
+        }
+        return true;
+    }
+
+    void unlock() {
+        now_serving_.fetch_add(1, std::memory_order_release);
+    }
+
+    void lock_shared() {
+        SpinBackoff backoff;
+        for (;;) {
+            while (writers_pending()) backoff.pause();
+            readers_.fetch_add(1, std::memory_order_seq_cst);
+            if (!writers_pending()) return;
+            readers_.fetch_sub(1, std::memory_order_release); // A writer arrived meanwhile
+        }
+    }
+
+    bool try_lock_shared() {
+        if (writers_pending()) return false;
+        readers_.fetch_add(1, std::memory_order_seq_cst);
+        if (!writers_pending()) return true;
+        readers_.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void unlock_shared() {
+        readers_.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    bool writers_pending() const {
+        return next_ticket_.load(std::memory_order_seq_cst) != now_serving_.load(std::memory_order_seq_cst);
+    }
+
+    std::atomic<unsigned> next_ticket_{0};
+    std::atomic<unsigned> now_serving_{0};
+    std::atomic<int> readers_{0};
+};
+
+// Sequence lock for small trivially copyable values (counters, coordinates, config
+// snapshots). Readers never write shared memory: they copy the value and retry if a
+// writer was active meanwhile (odd or changed sequence number). The value is kept in
+// atomic words so the racy copy is well-defined. Writers are serialized by a mutex.
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock<T> requires a trivially copyable T");
+
+public:
+    SeqLock() : SeqLock(T{}) {}
+    explicit SeqLock(const T& value) { write_words(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T load() const {
+        SpinBackoff backoff;
+        for (;;) {
+            const std::uint64_t before = seq_.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                std::uint64_t copy[kWords];
+                for (std::size_t i = 0; i < kWords; ++i) copy[i] = words_[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == before) {
+                    T value;
+                    std::memcpy(&value, copy, sizeof(T));
+                    return value;
+                }
+            }
+            backoff.pause();
+        }
+    }
+
+    void store(const T& value) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        begin_write();
+        write_words(value);
+        end_write();
+    }
+
+    // Read-modify-write under the writer lock: f receives a copy and returns the new value.
+    template<typename F>
+    T update(F f) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        T value = read_words();
+        value = f(value);
+        begin_write();
+        write_words(value);
+        end_write();
+        return value;
+    }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    void begin_write() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void end_write() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void write_words(const T& value) {
+        std::uint64_t copy[kWords] = {};
+        std::memcpy(copy, &value, sizeof(T));
+        for (std::size_t i = 0; i < kWords; ++i) words_[i].store(copy[i], std::memory_order_relaxed);
+    }
+
+    T read_words() const {
+        std::uint64_t copy[kWords];
+        for (std::size_t i = 0; i < kWords; ++i) copy[i] = words_[i].load(std::memory_order_relaxed);
+        T value;
+        std::memcpy(&value, copy, sizeof(T));
+        return value;
+    }
+
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> words_[kWords];
+    std::mutex writer_mutex_;
+};
+
+/*
+Explanation:
+`std::shared_timed_mutex` keeps its reader count in one word. Every `lock_shared()`
+and `unlock_shared()` is an atomic read-modify-write of that word, so with many
+readers on many cores the cache line holding it bounces between cores and readers
+effectively serialize, even though none of them ever waits for a writer.
+
+DistributedSharedMutex (a "big reader" lock):
+-   64 reader counters, each on its own 128-byte slot. A thread always uses the same
+    slot, so readers on different cores do not write to shared cache lines.
+-   A writer takes a writer mutex, raises a flag, and waits until all counters are zero.
+    Readers increment their counter and then check the flag (and back off if it is up).
+    Both sides use sequentially consistent operations, so at least one of them sees
+    the other (the classic Dekker pattern).
+-   Reads scale almost linearly; writes cost a scan of 64 counters.
+
+TicketRWLock (writer-preferring):
+-   Writers take a ticket (`next_ticket_`) and wait for `now_serving_` to reach it,
+    so writers are served first-come first-served.
+-   `next_ticket_ != now_serving_` means a writer holds or waits for the lock. New
+    readers wait for that to clear, so a waiting writer is never starved by a
+    continuous flow of readers (unlike many reader-preferring implementations).
+
+SeqLock<T>:
+-   For small trivially copyable values. Readers do not modify any shared memory,
+    so they do not slow each other down at all; they only retry when a write overlapped.
+-   Writers bump a sequence number to odd, write, and bump it back to even.
+-   Not suitable for values containing pointers that a writer might free (a reader
+    could copy a pointer that is being replaced); see rcu.hpp for that case.
+
+Waiting: all locks spin briefly with a CPU pause hint and then yield, instead of
+sleeping in the kernel. That is ideal for short critical sections; for long ones a
+blocking mutex wastes less CPU.
+
+Usage Example:
+```cpp
+DistributedSharedMutex m;                       // Drop-in for std::shared_timed_mutex
+{ std::shared_lock<DistributedSharedMutex> r(m); read(); }
+{ std::unique_lock<DistributedSharedMutex> w(m); write(); }
+if (m.try_lock_shared_for(std::chrono::milliseconds(10))) { read(); m.unlock_shared(); }
+
+struct Point { double x, y; };
+SeqLock<Point> position(Point{0, 0});
+position.store(Point{1, 2});
+Point p = position.load();                      // Never a torn x/y pair
+```
+*/
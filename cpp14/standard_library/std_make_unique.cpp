@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 
+#include "../../cpp11/standard_library/allocation_tracker.hpp" // AllocationScope: counts operator new/delete calls
+#include "object_pool.hpp" // ObjectPool: make_unique from a pool with a slot-returning deleter
+
 // A sample class to use with std::make_unique
 struct Widget {
     int id;
@@ -82,8 +85,59 @@ int main() {
     }
     std::cout << "\n(std::make_unique does not directly support custom deleters; use unique_ptr constructor for that.)" << std::endl; // Corrected newline
 
+    // 5. What make_unique and moves cost, counted by allocation_tracker.hpp
+    // (a wrong count makes main return 1)
+    std::cout << "\n--- Counting Allocations ---" << std::endl;
+    bool counts_ok = true;
+    {
+        std::string name = "Counted"; // Short: fits std::string's small buffer
+        std::vector<double> values(1000, 1.0);
+
+        AllocationScope make_scope;
+        // make_unique forwards the rvalues to Widget's constructor, which moves them:
+        // the only allocation is the Widget itself, not a copy of the 1000 doubles.
+        auto counted = std::make_unique<Widget>(5, std::move(name), std::move(values));
+        const long long created = make_scope.allocations();
+
+        AllocationScope move_scope;
+        std::unique_ptr<Widget> new_owner = std::move(counted);
+        const long long moved = move_scope.allocations();
+        counts_ok = created == 1 && moved == 0;
+        std::cout << "make_unique with moved arguments: " << created << " allocation(s); moving the unique_ptr: "
+                  << moved << (counts_ok ? " (as expected)" : " (UNEXPECTED)") << std::endl;
+
+        std::vector<double> more(1000, 2.0);
+        AllocationScope copy_scope;
+        auto copied = std::make_unique<Widget>(6, std::string("Copied"), std::vector<double>(more)); // Copies `more`
+        std::cout << "make_unique with a copied vector: " << copy_scope.allocations() << " allocation(s)" << std::endl;
+    }
+
+    // 6. A pool for churn-heavy code: unique_ptr with a pool-returning deleter
+    std::cout << "\n--- Object Pool (object_pool.hpp) ---" << std::endl;
+    {
+        ObjectPool<Widget> pool;
+        const Widget* first_address = nullptr;
+        {
+            auto pooled = pool.make_unique<Widget>(8, "Pooled"); // First create carves a chunk
+            first_address = pooled.get();
+            pooled->show();
+        } // ObjectPool<Widget>::Deleter: ~Widget(), slot back to the pool
+
+        AllocationScope churn_scope;
+        bool same_slot = true;
+        for (int i = 0; i < 3; ++i) {
+            ObjectPool<Widget>::UniquePtr w = pool.make_unique<Widget>(9 + i, "Churn");
+            same_slot = same_slot && w.get() == first_address;
+        }
+        std::cout << "3 create/destroy cycles from the pool: " << churn_scope.allocations()
+                  << " allocation(s), " << (same_slot ? "always the same slot" : "different slots")
+                  << " (pool capacity " << pool.capacity() << " slots)" << std::endl;
+    }
+
+    if (!counts_ok) std::cout << "ERROR: an allocation count differs from the expected one!" << std::endl;
+
     std::cout << "\nEnd of main. Widgets will be destroyed by unique_ptrs." << std::endl; // Corrected newline
-    return 0;
+    return counts_ok ? 0 : 1;
 }
 
 /*
@@ -146,6 +200,28 @@ Custom Deleters:
     constructor directly:
     `std::unique_ptr<MyType, MyDeleter> ptr(new MyType(), MyDeleter());`
 
+Counting Allocations (`allocation_tracker.hpp`, section 5):
+-   `allocation_tracker.hpp` (from cpp11/standard_library) replaces the global
+    `operator new`/`operator delete` with counting versions; `AllocationScope`
+    reports the calls made since it was created.
+-   `std::make_unique<Widget>(5, std::move(name), std::move(values))` makes exactly
+    one allocation (the Widget): perfect forwarding passes the rvalues on, and
+    Widget's constructor moves the vector's buffer instead of copying it. Moving
+    the resulting `unique_ptr` allocates nothing. Passing a copy of a vector costs
+    a second allocation.
+
+Object Pool (`object_pool.hpp`, section 6):
+-   `ObjectPool<Widget>` hands out fixed-size slots carved from large chunks and
+    reuses freed slots; each thread keeps its own free list, refilled from and
+    returned to the shared pool in batches.
+-   `pool.make_unique<Widget>(args...)` returns
+    `std::unique_ptr<Widget, ObjectPool<Widget>::Deleter>`: the custom deleter of
+    section 4, except that it destroys the Widget and returns the slot instead of
+    calling `delete`. Create/destroy cycles after the first make no allocation at
+    all (the slot is reused), which the AllocationScope confirms.
+-   The pool must outlive every object it created. See
+    `bench/bench_object_pool.cpp` for churn loops against `std::make_unique`.
+
 Recommendation:
 Always prefer `std::make_unique` over direct use of `new` when creating
 `std::unique_ptr`s for single objects or default-initialized arrays, unless a
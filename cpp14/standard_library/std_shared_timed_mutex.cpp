@@ -1,25 +1,29 @@
 // std_shared_timed_mutex.cpp
 #include <iostream>
 #include <thread>
+#include <atomic>         // For std::atomic (counters in run_rw_workload)
 #include <mutex>          // For std::mutex, std::lock_guard, std::unique_lock
 #include <shared_mutex>   // For std::shared_timed_mutex (C++14), std::shared_lock (C++14)
 #include <vector>
 #include <chrono>
 #include <sstream>      // For std::ostringstream
 #include <string>       // For std::to_string, std::string
-#include <algorithm>    // For std::count
 #include <ctime>        // For time (for srand)
 
+#include "rw_locks.hpp"  // DistributedSharedMutex, TicketRWLock, SeqLock
+#include "append_log.hpp" // Lock-free AppendLog with an O(1) entry count
+#include "rcu.hpp"        // RcuCell: wait-free reads of published snapshots
+#include "lock_free_structures.hpp" // LockFreeQueue, LockFreeStack with hazard pointers / epochs
+
 // A shared resource
 struct SharedData {
-    int value = 0;
-    std::string log;
+    int value = 0;                          // Guarded by mutex_
+    AppendLog<std::string> log;             // Lock-free, needs no mutex
     mutable std::shared_timed_mutex mutex_;
 
     void add_log(const std::string& entry) {
         std::this_thread::sleep_for(std::chrono::milliseconds(5));
-        log += entry;
-        log += "\n"; // Corrected newline
+        log.push_back(entry);
     }
 };
 
@@ -34,8 +38,9 @@ void writer_thread(SharedData& data, int id, int num_writes) {
             data.value++;
             std::string entry = "Writer " + std::to_string(id) + " (TID: " + tid_str.substr(0,4) + 
                                 ") wrote value: " + std::to_string(data.value);
-            data.add_log(entry);
-            std::cout << entry << std::endl;
+        lock.unlock(); // The log is lock-free: appending (slow here) no longer blocks readers
+        data.add_log(entry);
+        std::cout << entry << std::endl;
         std::this_thread::sleep_for(std::chrono::milliseconds(10 + (rand() % 20)));
     }
 }
@@ -50,11 +55,65 @@ void reader_thread(const SharedData& data, int id, int num_reads) {
         std::shared_lock<std::shared_timed_mutex> lock(data.mutex_);
             std::string entry = "Reader " + std::to_string(id) + " (TID: " + tid_str.substr(0,4) + 
                                 ") read value: " + std::to_string(data.value);
-            std::cout << entry << " (Log entries: " << std::count(data.log.begin(), data.log.end(), '\n') << ")" << std::endl; // Corrected count for newline
+            std::cout << entry << " (Log entries: " << data.log.size() << ")" << std::endl; // O(1), no scan of the log
         std::this_thread::sleep_for(std::chrono::milliseconds(5 + (rand() % 10)));
     }
 }
 
+// Readers check that two fields always match; one writer updates both under the lock.
+// Works unchanged with any type that has lock()/unlock()/lock_shared()/unlock_shared().
+template<typename RWMutex>
+void run_rw_workload(const char* name) {
+    RWMutex mtx;
+    long long first = 0, second = 0;
+    std::atomic<long long> reads{0}, mismatches{0};
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < 4; ++r) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < 100000; ++i) {
+                std::shared_lock<RWMutex> lock(mtx);
+                if (first != second) mismatches++;
+                reads++;
+            }
+        });
+    }
+    workers.emplace_back([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            std::unique_lock<RWMutex> lock(mtx);
+            ++first;
+            ++second;
+        }
+    });
+    for (auto& t : workers) t.join();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << reads << " reads, " << first << " writes in " << elapsed.count() << " ms" << std::endl;
+    if (mismatches != 0 || first != 1000) std::cout << "ERROR: " << name << " let a reader see a half-done write!" << std::endl;
+}
+
+// What the readers actually need: a consistent (value, log) pair, published via RCU.
+struct SharedSnapshot {
+    int value = 0;
+    std::vector<std::string> log;
+};
+
+void rcu_writer_thread(RcuCell<SharedSnapshot>& data, int id, int num_writes) {
+    for (int i = 0; i < num_writes; ++i) {
+        // Copy, modify, publish: readers see either the old or the new version, never a mix.
+        data.update([id](SharedSnapshot& s) {
+            s.value++;
+            s.log.push_back("Writer " + std::to_string(id) + " wrote value: " + std::to_string(s.value));
+        });
+    }
+}
+
+void rcu_reader_thread(const RcuCell<SharedSnapshot>& data, int num_reads, std::atomic<int>& inconsistent) {
+    for (int i = 0; i < num_reads; ++i) {
+        auto snapshot = data.read(); // Wait-free; the version stays alive while `snapshot` exists
+        if (snapshot->log.size() != static_cast<size_t>(snapshot->value)) inconsistent++;
+    }
+}
+
 int main() {
     SharedData shared_resource;
     srand(static_cast<unsigned int>(time(nullptr)));
@@ -80,7 +139,7 @@ int main() {
     std::cout << "\n--- Final Log Content ---" << std::endl; // Corrected newline
     {
         std::shared_lock<std::shared_timed_mutex> lock(shared_resource.mutex_);
-        std::cout << shared_resource.log << std::endl;
+        shared_resource.log.for_each([](const std::string& entry) { std::cout << entry << "\n"; });
         std::cout << "Final value: " << shared_resource.value << std::endl;
     }
 
@@ -131,6 +190,91 @@ int main() {
 
     if (t_shared_holder.joinable()) t_shared_holder.join();
 
+
+    std::cout << "\n--- Scalable Reader-Writer Locks (rw_locks.hpp) ---" << std::endl;
+    // All readers of a std::shared_timed_mutex update the same reader count, so that cache
+    // line bounces between cores. These alternatives are drop-in replacements.
+    run_rw_workload<std::shared_timed_mutex>("std::shared_timed_mutex");
+    run_rw_workload<DistributedSharedMutex>("DistributedSharedMutex (per-slot reader counters)");
+    run_rw_workload<TicketRWLock>("TicketRWLock (writer-preferring)");
+
+    DistributedSharedMutex distributed_mtx; // Supports the timed members too
+    if (distributed_mtx.try_lock_shared_for(std::chrono::milliseconds(100))) {
+        std::cout << "DistributedSharedMutex acquired a shared lock via try_lock_shared_for." << std::endl;
+        distributed_mtx.unlock_shared();
+    }
+
+    // A SeqLock suits small plain values: readers copy without writing any shared memory.
+    struct Snapshot { int value; int log_entries; };
+    SeqLock<Snapshot> snapshot(Snapshot{shared_resource.value, static_cast<int>(shared_resource.log.size())});
+    snapshot.update([](Snapshot s) { s.value++; s.log_entries++; return s; });
+    Snapshot current = snapshot.load();
+    std::cout << "SeqLock snapshot: value " << current.value << ", log entries " << current.log_entries << std::endl;
+
+
+    std::cout << "\n--- RCU Snapshots (rcu.hpp) ---" << std::endl;
+    // Writers publish whole new versions; readers never lock, wait or retry.
+    RcuCell<SharedSnapshot> published(SharedSnapshot{});
+    std::atomic<int> inconsistent{0};
+    std::vector<std::thread> rcu_threads;
+    rcu_threads.emplace_back(rcu_writer_thread, std::ref(published), 1, 500);
+    rcu_threads.emplace_back(rcu_writer_thread, std::ref(published), 2, 500);
+    for (int i = 0; i < 4; ++i) {
+        rcu_threads.emplace_back(rcu_reader_thread, std::cref(published), 20000, std::ref(inconsistent));
+    }
+    for (auto& t : rcu_threads) t.join();
+    {
+        auto final_snapshot = published.read();
+        std::cout << "RCU final value: " << final_snapshot->value << ", log entries: " << final_snapshot->log.size()
+                  << ", last entry: \"" << final_snapshot->log.back() << "\"" << std::endl;
+        if (final_snapshot->value != 1000) std::cout << "ERROR: an RCU update was lost!" << std::endl;
+    }
+    if (inconsistent != 0) std::cout << "ERROR: " << inconsistent << " RCU reads saw an inconsistent snapshot!" << std::endl;
+    published.domain().synchronize(); // Wait for the grace period and free all old versions
+    std::cout << "Old versions still waiting for reclamation: " << published.domain().pending() << std::endl;
+
+
+
+    std::cout << "\n--- Lock-Free Stack and Queue (lock_free_structures.hpp) ---" << std::endl;
+    // Writers hand log lines to consumers without any lock; popped nodes are freed
+    // only when no other thread can still be reading them (hazard pointers).
+    {
+        LockFreeQueue<std::string> messages;
+        std::atomic<int> consumed{0};
+        std::atomic<bool> producers_done{false};
+        std::vector<std::thread> queue_threads;
+        for (int id = 1; id <= 2; ++id) {
+            queue_threads.emplace_back([&messages, id] {
+                for (int i = 0; i < 1000; ++i) messages.push("Writer " + std::to_string(id) + " message " + std::to_string(i));
+            });
+        }
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < 2; ++c) {
+            consumers.emplace_back([&] {
+                std::string line;
+                for (;;) {
+                    if (messages.try_pop(line)) consumed++;
+                    else if (producers_done.load()) { if (messages.empty()) break; }
+                    else std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& t : queue_threads) t.join();
+        producers_done.store(true);
+        for (auto& t : consumers) t.join();
+        std::cout << "LockFreeQueue: " << consumed.load() << " of 2000 messages consumed" << std::endl;
+        if (consumed != 2000) std::cout << "ERROR: the lock-free queue lost or duplicated messages!" << std::endl;
+        std::cout << "Retired queue nodes waiting in HazardDomain::global(): " << HazardDomain::global().pending() << std::endl;
+
+        LockFreeStack<int, EpochReclamation> stack; // Same interface, epoch-based reclamation
+        for (int i = 1; i <= 3; ++i) stack.push(i);
+        int top = 0;
+        stack.try_pop(top);
+        std::cout << "LockFreeStack<int, EpochReclamation>: popped " << top << " (last in, first out)" << std::endl;
+        std::cout << "Retired stack nodes and RCU snapshots waiting in EpochDomain::global(): "
+                  << EpochDomain::global().pending() << std::endl;
+    }
+
     return 0;
 }
 
@@ -188,7 +332,46 @@ Comparison with `std::shared_mutex` (C++17):
     `_until` timed locking methods.
 -   `std::shared_timed_mutex` is the one available in C++14 for shared locking with timed capabilities.
 
+Scalable Alternatives (`rw_locks.hpp`, next to this file):
+-   `DistributedSharedMutex`: readers increment one of many padded counters instead
+    of a shared one, so reads scale with the number of cores; writes get slower.
+-   `TicketRWLock`: writer-preferring, writers are served in arrival order.
+-   `SeqLock<T>`: for small trivially copyable values; reads are retried instead of locked.
+Both mutexes provide the same members as `std::shared_timed_mutex` (including the
+timed ones), so they work with `std::shared_lock` and `std::unique_lock` unchanged.
+`bench/bench_rw_locks.cpp` measures them against the standard mutexes.
+
+The Log (`append_log.hpp`):
+-   `SharedData::log` used to be a `std::string` appended to under the exclusive lock,
+    and readers counted its lines with `std::count`, an O(n) scan on every read.
+-   It is now an `AppendLog<std::string>`: writers append without any lock (so the
+    slow `add_log` runs after the exclusive lock is released and never blocks readers),
+    and `log.size()` is a single atomic load. Entries from different writers may be
+    logged in a different order than their values were assigned.
+`bench/bench_append_log.cpp` compares both designs.
+
+Snapshots with RCU (`rcu.hpp`):
+-   Readers often need a *consistent* view of several fields (here: the value and the
+    log that matches it). `RcuCell<SharedSnapshot>` publishes immutable versions:
+    writers copy the current version, modify the copy and swap a pointer; readers
+    get a handle to the current version without locking, waiting or retrying.
+-   Old versions are freed by epoch-based reclamation once no reader can still hold
+    them (after a "grace period"). Updates cost a full copy, so this suits data that
+    is read far more often than written.
+`bench/bench_rcu.cpp` compares it with the shared-lock version and stress-tests it.
+
+Lock-Free Stack and Queue (`lock_free_structures.hpp`, `hazard_pointers.hpp`):
+-   `LockFreeQueue<T>` (Michael-Scott) and `LockFreeStack<T>` (Treiber) push and pop
+    with compare-and-swap only; no thread ever blocks another.
+-   The hard part is freeing popped nodes while other threads may still read them.
+    Hazard pointers (the default) let each thread announce the few nodes it is
+    using; `EpochReclamation` reuses the `EpochDomain` of rcu.hpp instead.
+`bench/bench_reclamation.cpp` compares both with `std::atomic<std::shared_ptr>`
+versions of the same structures.
+
 How to compile:
 g++ -std=c++14 std_shared_timed_mutex.cpp -o shared_timed_mutex_example -pthread
+(`rw_locks.hpp`, `append_log.hpp`, `rcu.hpp`, `hazard_pointers.hpp` and
+`lock_free_structures.hpp` must be in the same directory)
 ./shared_timed_mutex_example
 */
@@ -0,0 +1,232 @@
+// numa_buffer.hpp
+// NUMA-aware buffers for the parallel algorithms: an allocator that hands out
+// untouched pages (so the threads that initialize the data decide where it lives),
+// a parallel first-touch initializer, and optional page interleaving via libnuma.
+// Define HAVE_LIBNUMA and link with -lnuma to enable the libnuma parts.
+#pragma once
+
+#include <cstddef>
+#include <new>         // For std::bad_alloc, ::operator new with alignment
+#include <string>
+#include <utility>     // For std::forward
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>  // For mmap, munmap
+#include <unistd.h>    // For sysconf
+#endif
+
+#ifdef HAVE_LIBNUMA
+#include <numa.h>      // For numa_available, numa_interleave_memory
+#include <numaif.h>    // For move_pages
+#endif
+
+#include "work_stealing_pool.hpp"
+
+// Where the pages of a NumaAllocator allocation end up.
+enum class NumaPolicy {
+    first_touch, // Kernel default: each page goes to the node of the thread that writes it first
+    interleave   // Pages are spread round-robin over all nodes (libnuma only, else first_touch)
+};
+
+namespace numa_detail {
+
+inline std::size_t page_size() {
+#if defined(__linux__)
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+inline std::size_t round_to_pages(std::size_t bytes) {
+    const std::size_t page = page_size();
+    return (bytes + page - 1) / page * page;
+}
+
+inline bool libnuma_usable() {
+#ifdef HAVE_LIBNUMA
+    static const bool usable = ::numa_available() >= 0;
+    return usable;
+#else
+    return false;
+#endif
+}
+
+// Fresh anonymous pages are not backed by memory until written, so nothing is
+// placed yet. malloc cannot promise that: it recycles memory that earlier code
+// (possibly a thread on another node) has already touched.
+inline void* allocate_pages(std::size_t bytes, NumaPolicy policy) {
+    bytes = round_to_pages(bytes);
+#if defined(__linux__)
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+#else
+    void* p = ::operator new(bytes, std::align_val_t(page_size()));
+#endif
+#ifdef HAVE_LIBNUMA
+    if (policy == NumaPolicy::interleave && libnuma_usable()) {
+        ::numa_interleave_memory(p, bytes, ::numa_all_nodes_ptr); // mbind(MPOL_INTERLEAVE)
+    }
+#else
+    (void)policy;
+#endif
+    return p;
+}
+
+inline void deallocate_pages(void* p, std::size_t bytes) {
+#if defined(__linux__)
+    ::munmap(p, round_to_pages(bytes));
+#else
+    (void)bytes;
+    ::operator delete(p, std::align_val_t(page_size()));
+#endif
+}
+
+} // namespace numa_detail
+
+// Allocator for large parallel buffers. Every allocation gets its own fresh pages,
+// and value-less construct() default-initializes instead of value-initializing,
+// so `numa_vector<int> v(n)` does not write (and thereby place) a single page.
+// Call parallel_first_touch() afterwards to initialize the data from the pool.
+template<typename T>
+class NumaAllocator {
+public:
+    using value_type = T;
+
+    NumaAllocator(NumaPolicy policy = NumaPolicy::first_touch) noexcept : policy_(policy) {}
+    template<typename U>
+    NumaAllocator(const NumaAllocator<U>& other) noexcept : policy_(other.policy()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(numa_detail::allocate_pages(n * sizeof(T), policy_));
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        numa_detail::deallocate_pages(p, n * sizeof(T));
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        if constexpr (sizeof...(Args) == 0) {
+            ::new (static_cast<void*>(p)) U; // Default-init: no write for trivial types
+        } else {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+    }
+
+    NumaPolicy policy() const noexcept { return policy_; }
+
+private:
+    NumaPolicy policy_;
+};
+
+template<typename T, typename U>
+bool operator==(const NumaAllocator<T>& a, const NumaAllocator<U>& b) { return a.policy() == b.policy(); }
+template<typename T, typename U>
+bool operator!=(const NumaAllocator<T>& a, const NumaAllocator<U>& b) { return !(a == b); }
+
+template<typename T>
+using numa_vector = std::vector<T, NumaAllocator<T>>;
+
+// Writes gen(i) to data[i] from the pool's workers, so the pages of each chunk are
+// placed on the node of the worker that initialized it. Use the same grain as the
+// later parallel passes so that, as far as work stealing allows, the same workers
+// come back to the same chunks.
+template<typename T, typename Gen>
+void parallel_first_touch(WorkStealingPool& pool, T* data, std::size_t n, Gen gen,
+                          std::size_t grain = 0) {
+    parallel_for(pool, n, grain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) data[i] = gen(i);
+    });
+}
+
+// Number of NUMA nodes (1 without libnuma or on non-NUMA machines).
+inline int numa_node_count() {
+#ifdef HAVE_LIBNUMA
+    if (numa_detail::libnuma_usable()) return ::numa_num_configured_nodes();
+#endif
+    return 1;
+}
+
+// For every NUMA node, how many pages of [data, data + bytes) currently live there.
+// Empty if this cannot be determined (no libnuma). Pages never written are skipped.
+inline std::vector<std::size_t> numa_page_histogram(const void* data, std::size_t bytes) {
+    std::vector<std::size_t> histogram;
+#ifdef HAVE_LIBNUMA
+    if (!numa_detail::libnuma_usable() || bytes == 0) return histogram;
+    histogram.assign(static_cast<std::size_t>(::numa_max_node() + 1), 0);
+    const std::size_t page = numa_detail::page_size();
+    const std::size_t first = reinterpret_cast<std::size_t>(data) / page * page;
+    const std::size_t count = (reinterpret_cast<std::size_t>(data) + bytes - first + page - 1) / page;
+    std::vector<void*> pages(count);
+    std::vector<int> status(count);
+    for (std::size_t i = 0; i < count; ++i) pages[i] = reinterpret_cast<void*>(first + i * page);
+    // With a null node list move_pages() moves nothing and reports each page's node.
+    if (::move_pages(0, static_cast<unsigned long>(count), pages.data(), nullptr, status.data(), 0) != 0) {
+        histogram.clear();
+        return histogram;
+    }
+    for (int node : status) {
+        if (node >= 0 && static_cast<std::size_t>(node) < histogram.size()) ++histogram[static_cast<std::size_t>(node)];
+    }
+#else
+    (void)data;
+    (void)bytes;
+#endif
+    return histogram;
+}
+
+// One-line description of what this build/machine supports, for logs and benchmark context.
+inline std::string numa_support_summary() {
+#ifdef HAVE_LIBNUMA
+    if (numa_detail::libnuma_usable()) {
+        return "libnuma, " + std::to_string(numa_node_count()) + " node(s)";
+    }
+    return "libnuma linked, but the kernel has no NUMA support";
+#else
+    return "no libnuma (first-touch only)";
+#endif
+}
+
+/*
+Explanation:
+On a multi-socket machine every socket has its own memory controller. A thread can
+read memory attached to another socket, but with higher latency and through a link
+with far less bandwidth than the local controller. Linux decides where a page lives
+when it is first *written* ("first touch"), not when it is allocated.
+
+The trap in `parallel_algorithms.cpp`-style code:
+```cpp
+std::vector<int> v(n);                   // Value-initialization writes every page...
+std::iota(v.begin(), v.end(), 1);        // ...from the main thread, so all pages are on its node
+std::reduce(std::execution::par, ...);   // All threads now compete for one socket's bandwidth
+```
+
+This header avoids both writes:
+-   `NumaAllocator` maps fresh pages per allocation (malloc may hand back memory
+    that was already touched) and default-initializes in `construct()`, so creating
+    `numa_vector<int> v(n)` places nothing.
+-   `parallel_first_touch(pool, v.data(), n, gen)` then initializes chunks from the
+    pool's workers, spreading the pages over the nodes the workers run on. Placement
+    follows the workers, so it works best with pinned threads and the same chunking
+    in the later parallel passes.
+-   `NumaPolicy::interleave` asks the kernel (via libnuma's `mbind(MPOL_INTERLEAVE)`)
+    to spread pages round-robin over all nodes regardless of who touches them. That
+    gives every thread the same average bandwidth and is the robust choice when the
+    work partitioning is not under your control (e.g. `std::execution::par` via TBB).
+-   `numa_page_histogram()` reports where the pages of a buffer actually ended up.
+
+libnuma is optional: build with `-DHAVE_LIBNUMA ... -lnuma` (the CMake files do this
+automatically when libnuma is installed). Without it interleaving falls back to
+first touch. On a single-node machine all placements are the same and the
+benchmarks show no difference, which is expected.
+
+Usage Example:
+```cpp
+WorkStealingPool pool;
+numa_vector<int> v(n, NumaAllocator<int>(NumaPolicy::first_touch)); // No page touched yet
+parallel_first_touch(pool, v.data(), v.size(), [](std::size_t i) { return int(i + 1); });
+long long sum = parallel_reduce(pool, v.begin(), v.end(), 0LL);
+```
+*/
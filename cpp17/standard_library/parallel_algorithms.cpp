@@ -3,10 +3,16 @@
 #include <vector>
 #include <algorithm>  // For std::sort, std::for_each, std::transform, std::reduce
 #include <execution>  // Key header for parallel execution policies (C++17)
-#include <numeric>    // For std::iota, std::reduce (though reduce is also in <algorithm> in C++17)
+#include <numeric>    // For std::iota, std::reduce, std::inclusive_scan (though reduce is also in <algorithm> in C++17)
 #include <chrono>     // For timing
 #include <iomanip>    // For std::fixed, std::setprecision
 
+#include "work_stealing_pool.hpp" // Our own work-stealing backend (parallel_sort/transform/reduce)
+#include "radix_sort.hpp"         // Parallel MSD/LSD radix sorts for integer keys
+#include "simd_kernels.hpp"       // SSE4.1/AVX2/AVX-512 kernels chosen at runtime via CPUID
+#include "parallel_scan.hpp"      // Blocked two-pass parallel prefix sums and copy_if
+#include "numa_buffer.hpp"        // First-touch/interleaved buffers for multi-socket machines
+
 // Helper function to print a vector
 template<typename T>
 void print_vector(const std::string& title, const std::vector<T>& v, size_t limit = 10) {
@@ -34,8 +40,13 @@ int main() {
     std::vector<int> v_orig(data_size);
     std::iota(v_orig.begin(), v_orig.end(), 1); // Fill with 1, 2, ..., data_size
 
-    std::vector<int> v_seq, v_par, v_par_unseq;
-    std::vector<long long> v_transformed_seq(data_size), v_transformed_par(data_size);
+    // A work-stealing pool, timed side by side with the standard execution policies.
+    // Unlike std::execution::par, it uses all cores even if the stdlib has no parallel backend.
+    WorkStealingPool pool; // One worker per hardware thread; pass a count to override
+    std::cout << "Work-stealing pool workers: " << pool.size() << std::endl;
+
+    std::vector<int> v_seq, v_par, v_par_unseq, v_pool, v_radix_msd, v_radix_lsd;
+    std::vector<long long> v_transformed_seq(data_size), v_transformed_par(data_size), v_transformed_pool(data_size);
 
     // --- 1. std::sort ---
     std::cout << "\n--- 1. std::sort ---" << std::endl;
@@ -44,6 +55,9 @@ int main() {
     std::reverse(v_seq.begin(), v_seq.end()); // Make it unsorted (worst case for some sorts)
     v_par = v_seq;
     v_par_unseq = v_seq;
+    v_pool = v_seq;
+    v_radix_msd = v_seq;
+    v_radix_lsd = v_seq;
 
     auto start_time = std::chrono::high_resolution_clock::now();
     std::sort(std::execution::seq, v_seq.begin(), v_seq.end());
@@ -70,6 +84,29 @@ int main() {
     print_vector("Sorted v_par_unseq", v_par_unseq);
      if(v_seq != v_par_unseq) std::cout << "ERROR: par_unseq sort differs from seq sort!" << std::endl;
 
+    start_time = std::chrono::high_resolution_clock::now();
+    parallel_sort(pool, v_pool.begin(), v_pool.end());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_pool_sort = end_time - start_time;
+    std::cout << "parallel_sort (work-stealing pool) time: " << time_pool_sort.count() << " ms" << std::endl;
+    print_vector("Sorted v_pool", v_pool);
+    if(v_seq != v_pool) std::cout << "ERROR: pool sort differs from seq sort!" << std::endl;
+
+    // Radix sorts do not compare elements at all: they distribute them by the bytes of the key.
+    start_time = std::chrono::high_resolution_clock::now();
+    radix_sort_msd(pool, v_radix_msd.begin(), v_radix_msd.end());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_radix_msd_sort = end_time - start_time;
+    std::cout << "radix_sort_msd (in-place, pool) time: " << time_radix_msd_sort.count() << " ms" << std::endl;
+    if(v_seq != v_radix_msd) std::cout << "ERROR: MSD radix sort differs from seq sort!" << std::endl;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    radix_sort_lsd(pool, v_radix_lsd.begin(), v_radix_lsd.end());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_radix_lsd_sort = end_time - start_time;
+    std::cout << "radix_sort_lsd (stable, pool) time: " << time_radix_lsd_sort.count() << " ms" << std::endl;
+    if(v_seq != v_radix_lsd) std::cout << "ERROR: LSD radix sort differs from seq sort!" << std::endl;
+
 
     // --- 2. std::for_each ---
     // Note: Operations in parallel for_each should be independent and thread-safe.
@@ -107,6 +144,24 @@ int main() {
     // Check correctness (optional)
     // if(v_transformed_seq != v_transformed_par) std::cout << "ERROR: par transform differs from seq!" << std::endl;
 
+    start_time = std::chrono::high_resolution_clock::now();
+    parallel_transform(pool, v_orig.begin(), v_orig.end(), v_transformed_pool.begin(), complex_calculation);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_pool_transform = end_time - start_time;
+    std::cout << "parallel_transform (work-stealing pool) time: " << time_pool_transform.count() << " ms" << std::endl;
+    print_vector("Transformed v_pool", v_transformed_pool);
+    if(v_transformed_seq != v_transformed_pool) std::cout << "ERROR: pool transform differs from seq!" << std::endl;
+
+    // Explicit SIMD version of complex_calculation, single-threaded, best instruction set for this CPU.
+    const SimdKernels& simd = simd_kernels();
+    std::vector<long long> v_transformed_simd(v_orig.size());
+    start_time = std::chrono::high_resolution_clock::now();
+    simd.complex_calculation_map(v_orig.data(), v_transformed_simd.data(), v_orig.size());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_simd_transform = end_time - start_time;
+    std::cout << "complex_calculation_map (" << simd_level_name(simd.level) << ", 1 thread) time: " << time_simd_transform.count() << " ms" << std::endl;
+    if(!std::equal(v_transformed_simd.begin(), v_transformed_simd.end(), v_transformed_seq.begin())) std::cout << "ERROR: SIMD transform differs from seq!" << std::endl;
+
 
     // --- 4. std::reduce (parallel sum) ---
     // std::reduce is like std::accumulate but can be parallelized.
@@ -115,7 +170,7 @@ int main() {
     v_orig.resize(data_size); // Restore original size for reduce
     std::iota(v_orig.begin(), v_orig.end(), 1);
 
-    long long sum_seq, sum_par, sum_par_unseq;
+    long long sum_seq, sum_par, sum_par_unseq, sum_pool;
 
     start_time = std::chrono::high_resolution_clock::now();
     sum_seq = std::reduce(std::execution::seq, v_orig.begin(), v_orig.end(), 0LL); // 0LL is initial sum
@@ -139,10 +194,103 @@ int main() {
     std::cout << "std::reduce (par_unseq) sum: " << sum_par_unseq << ", time: " << time_par_unseq_reduce.count() << " ms" << std::endl;
     if(sum_seq != sum_par_unseq) std::cout << "ERROR: par_unseq reduce sum differs from seq!" << std::endl;
 
+    start_time = std::chrono::high_resolution_clock::now();
+    sum_pool = parallel_reduce(pool, v_orig.begin(), v_orig.end(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_pool_reduce = end_time - start_time;
+    std::cout << "parallel_reduce (work-stealing pool) sum: " << sum_pool << ", time: " << time_pool_reduce.count() << " ms" << std::endl;
+    if(sum_seq != sum_pool) std::cout << "ERROR: pool reduce sum differs from seq!" << std::endl;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    long long sum_simd = simd.sum_i32(v_orig.data(), v_orig.size());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_simd_reduce = end_time - start_time;
+    std::cout << "sum_i32 (" << simd_level_name(simd.level) << ", 1 thread) sum: " << sum_simd << ", time: " << time_simd_reduce.count() << " ms" << std::endl;
+    if(sum_seq != sum_simd) std::cout << "ERROR: SIMD reduce sum differs from seq!" << std::endl;
+
+
+    // --- 5. std::inclusive_scan (parallel prefix sum) ---
+    // Every output depends on all inputs before it, so a scan cannot simply be split into
+    // independent chunks like transform or reduce. Parallel versions need two passes.
+    std::cout << "\n--- 5. std::inclusive_scan (prefix sum) ---" << std::endl;
+    std::vector<long long> prefix_seq(data_size), prefix_par(data_size), prefix_par_unseq(data_size), prefix_pool(data_size);
+
+    start_time = std::chrono::high_resolution_clock::now();
+    std::inclusive_scan(std::execution::seq, v_orig.begin(), v_orig.end(), prefix_seq.begin(), std::plus<>(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_seq_scan = end_time - start_time;
+    std::cout << "std::inclusive_scan (seq) last: " << prefix_seq.back() << ", time: " << time_seq_scan.count() << " ms" << std::endl;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    std::inclusive_scan(std::execution::par, v_orig.begin(), v_orig.end(), prefix_par.begin(), std::plus<>(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_par_scan = end_time - start_time;
+    std::cout << "std::inclusive_scan (par) last: " << prefix_par.back() << ", time: " << time_par_scan.count() << " ms" << std::endl;
+    if(prefix_seq != prefix_par) std::cout << "ERROR: par inclusive_scan differs from seq!" << std::endl;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    std::inclusive_scan(std::execution::par_unseq, v_orig.begin(), v_orig.end(), prefix_par_unseq.begin(), std::plus<>(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_par_unseq_scan = end_time - start_time;
+    std::cout << "std::inclusive_scan (par_unseq) last: " << prefix_par_unseq.back() << ", time: " << time_par_unseq_scan.count() << " ms" << std::endl;
+    if(prefix_seq != prefix_par_unseq) std::cout << "ERROR: par_unseq inclusive_scan differs from seq!" << std::endl;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    parallel_inclusive_scan_init(pool, v_orig.begin(), v_orig.end(), prefix_pool.begin(), std::plus<>(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_pool_scan = end_time - start_time;
+    std::cout << "parallel_inclusive_scan (work-stealing pool) last: " << prefix_pool.back() << ", time: " << time_pool_scan.count() << " ms" << std::endl;
+    if(prefix_seq != prefix_pool) std::cout << "ERROR: pool inclusive_scan differs from seq!" << std::endl;
+
+    // Exclusive scan: element i gets the sum of everything *before* it.
+    parallel_exclusive_scan(pool, v_orig.begin(), v_orig.end(), prefix_pool.begin(), 0LL);
+    print_vector("parallel_exclusive_scan", prefix_pool);
+
+    // Stream compaction: keep the multiples of 7, in order. Built on the same two-pass scan.
+    std::vector<int> multiples_of_7(data_size);
+    start_time = std::chrono::high_resolution_clock::now();
+    multiples_of_7.erase(parallel_copy_if(pool, v_orig.begin(), v_orig.end(), multiples_of_7.begin(),
+                                          [](int x) { return x % 7 == 0; }), multiples_of_7.end());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_pool_copy_if = end_time - start_time;
+    std::cout << "parallel_copy_if kept " << multiples_of_7.size() << " elements, time: " << time_pool_copy_if.count() << " ms" << std::endl;
+    print_vector("Multiples of 7", multiples_of_7);
+    if(multiples_of_7.size() != data_size / 7) std::cout << "ERROR: parallel_copy_if kept the wrong number of elements!" << std::endl;
+
+
+    // --- 6. Memory placement (first touch) ---
+    // v_orig was filled by std::iota on this thread, so on a NUMA machine all of its pages
+    // sit on this thread's node. A numa_vector is left untouched until the pool's workers
+    // initialize it, which spreads its pages over the nodes the workers run on.
+    std::cout << "\n--- 6. First-touch placement (" << numa_support_summary() << ") ---" << std::endl;
+    numa_vector<int> v_first_touch(data_size);
+    parallel_first_touch(pool, v_first_touch.data(), v_first_touch.size(), [](size_t i) { return static_cast<int>(i + 1); });
+
+    start_time = std::chrono::high_resolution_clock::now();
+    long long sum_first_touch_par = std::reduce(std::execution::par, v_first_touch.begin(), v_first_touch.end(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_first_touch_par = end_time - start_time;
+    std::cout << "std::reduce (par, first-touch buffer) sum: " << sum_first_touch_par << ", time: " << time_first_touch_par.count() << " ms"
+              << " (single-thread filled: " << time_par_reduce.count() << " ms)" << std::endl;
+    if(sum_seq != sum_first_touch_par) std::cout << "ERROR: reduce over the first-touch buffer differs from seq!" << std::endl;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    long long sum_first_touch_pool = parallel_reduce(pool, v_first_touch.begin(), v_first_touch.end(), 0LL);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> time_first_touch_pool = end_time - start_time;
+    std::cout << "parallel_reduce (pool, first-touch buffer) sum: " << sum_first_touch_pool << ", time: " << time_first_touch_pool.count() << " ms"
+              << " (single-thread filled: " << time_pool_reduce.count() << " ms)" << std::endl;
+    if(sum_seq != sum_first_touch_pool) std::cout << "ERROR: pool reduce over the first-touch buffer differs from seq!" << std::endl;
+
+    std::vector<size_t> pages_per_node = numa_page_histogram(v_first_touch.data(), v_first_touch.size() * sizeof(int));
+    if(!pages_per_node.empty()) print_vector("Pages of the first-touch buffer per NUMA node", pages_per_node);
+
 
     std::cout << "\nNote: Actual performance gains from parallel policies depend heavily on the hardware," << std::endl;
     std::cout << "the nature of the operation, data size, and the quality of the standard library implementation." << std::endl;
     std::cout << "Overhead of parallelization can make it slower for small datasets or trivial operations." << std::endl;
+    std::cout << "If std::execution::par is no faster than seq, your standard library probably has no parallel backend" << std::endl;
+    std::cout << "(e.g. libstdc++ without TBB); the work-stealing pool rows show what the cores can actually do." << std::endl;
 
     return 0;
 }
@@ -209,6 +357,25 @@ std::transform(std::execution::par, data.begin(), data.end(), results.begin(),
                [](int x){ return x * x; });
 ```
 
+Standard Library Backends and the Work-Stealing Pool:
+-   libstdc++ implements the parallel overloads on top of Intel TBB. If it was built
+    without TBB, `par` and `par_unseq` silently run sequentially.
+-   `work_stealing_pool.hpp` (next to this file) provides `WorkStealingPool` with
+    `parallel_sort`, `parallel_transform` and `parallel_reduce`. They are timed next
+    to the standard policies above, so you can see real multi-core scaling and judge
+    how good your standard library's backend is.
+-   `simd_kernels.hpp` contains hand-written SSE4.1/AVX2/AVX-512 kernels for the sum
+    and for `complex_calculation`, picked at runtime with CPUID. They show what the
+    hardware can do when vectorization is not left to the compiler and library.
+-   `parallel_scan.hpp` adds a blocked two-pass parallel prefix sum
+    (`parallel_inclusive_scan`, `parallel_inclusive_scan_init`, `parallel_exclusive_scan`,
+    `parallel_transform_inclusive_scan`) and stream compaction (`parallel_copy_if`).
+-   `numa_buffer.hpp` provides `numa_vector` (untouched fresh pages) and
+    `parallel_first_touch`, so large inputs are spread over all NUMA nodes instead of
+    landing on the node of the thread that happened to fill them (see section 6).
+-   `radix_sort.hpp` adds parallel radix sorts for integer keys (in-place MSD and
+    stable LSD), an alternative sort strategy to the comparison-based `std::sort`.
+
 Considerations:
 -   Overhead: Parallel execution has overhead (thread creation, synchronization, task division).
     For small datasets or very fast operations, parallel versions might be slower than sequential ones.
@@ -229,9 +396,18 @@ Considerations:
     unspecified order and out of sequence, making it suitable for parallel execution.
     The operation should ideally be associative and commutative for best results.
 
+`std::inclusive_scan` / `std::exclusive_scan`:
+-   Parallel-friendly versions of `std::partial_sum` (C++17). `inclusive_scan` writes
+    x0, x0+x1, x0+x1+x2, ...; `exclusive_scan` writes init, init+x0, init+x0+x1, ...
+-   The operation must be associative; parallel implementations scan blocks
+    independently and then fix them up with the totals of the preceding blocks.
+
 How to compile:
 -   g++: `g++ -std=c++17 parallel_algorithms.cpp -o parallel_algorithms_example -pthread -TBB` (or other threading library like OpenMP if the libstdc++ is configured for it)
     Often, just `-pthread` is enough if the default libstdc++ supports it. Some implementations might require linking against Intel TBB (`-ltbb`).
+    libstdc++ uses TBB automatically whenever its headers are installed, so in that case `-ltbb` is required.
+    `work_stealing_pool.hpp`, `radix_sort.hpp`, `simd_kernels.hpp`, `parallel_scan.hpp` and `numa_buffer.hpp` must be in the same directory (they are included with quotes).
+    Add `-DHAVE_LIBNUMA -lnuma` to enable page interleaving and placement reports via libnuma.
 -   Clang: `clang++ -std=c++17 parallel_algorithms.cpp -o parallel_algorithms_example -pthread` (similar to g++, may depend on libc++ configuration)
 -   MSVC: `/std:c++17 /EHsc` (Parallel algorithms are generally supported).
     Check your compiler/library documentation for specific flags for parallel algorithm support.
@@ -0,0 +1,284 @@
+// radix_sort.hpp
+// Parallel radix sorts for 32/64-bit integer keys on top of work_stealing_pool.hpp:
+// -   radix_sort_msd: in-place MSD ("American flag") sort, buckets recursed in parallel.
+// -   radix_sort_lsd: stable LSD sort through a scratch buffer, usable for key-value records.
+// Both take an optional key function, so records like std::pair<key, value> can be sorted by key.
+#pragma once
+
+#include <algorithm>   // For std::sort, std::copy
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>    // For std::iterator_traits
+#include <limits>
+#include <type_traits>
+#include <utility>     // For std::swap
+#include <vector>
+
+#include "work_stealing_pool.hpp"
+
+// Maps an integral key to an unsigned one with the same ordering: signed keys get
+// their sign bit flipped so negative values sort before positive ones.
+template<typename Key>
+constexpr std::make_unsigned_t<Key> to_radix_key(Key key) {
+    static_assert(std::is_integral_v<Key>, "radix sort needs integral keys");
+    using U = std::make_unsigned_t<Key>;
+    U u = static_cast<U>(key);
+    if constexpr (std::is_signed_v<Key>) {
+        u ^= U(1) << (std::numeric_limits<U>::digits - 1);
+    }
+    return u;
+}
+
+// Default key function: the element itself is the key.
+struct RadixIdentityKey {
+    template<typename T>
+    constexpr const T& operator()(const T& value) const { return value; }
+};
+
+namespace radix_detail {
+
+constexpr unsigned kDigitBits = 8;
+constexpr std::size_t kBuckets = std::size_t{1} << kDigitBits;
+using Histogram = std::array<std::size_t, kBuckets>;
+
+template<typename KeyFn, typename T>
+using key_type_t = std::decay_t<std::invoke_result_t<const KeyFn&, const T&>>;
+
+template<typename KeyFn, typename T>
+inline std::size_t digit_of(const KeyFn& key_fn, const T& value, unsigned shift) {
+    return static_cast<std::size_t>((to_radix_key(key_fn(value)) >> shift) & (kBuckets - 1));
+}
+
+// Splits [0, n) into at most pool.size()*4 chunks of at least min_chunk elements.
+inline std::size_t chunk_count(std::size_t n, const WorkStealingPool& pool, std::size_t min_chunk = 1 << 15) {
+    std::size_t chunks = std::min<std::size_t>(pool.size() * 4, (n + min_chunk - 1) / min_chunk);
+    return std::max<std::size_t>(1, chunks);
+}
+
+// Buckets at or below this size are finished with a comparison sort.
+constexpr std::size_t kMsdSmallBucket = 64;
+// Buckets above this size are recursed as separate pool tasks.
+constexpr std::size_t kMsdParallelBucket = 1 << 14;
+
+template<typename RandomIt, typename KeyFn>
+void sort_small(RandomIt first, RandomIt last, const KeyFn& key_fn) {
+    std::sort(first, last, [&key_fn](const auto& a, const auto& b) {
+        return to_radix_key(key_fn(a)) < to_radix_key(key_fn(b));
+    });
+}
+
+// In-place permutation of a range into buckets by the digit at `shift` (American
+// flag sort). `counts` is the histogram of that digit over the range.
+template<typename RandomIt, typename KeyFn>
+void permute_in_place(RandomIt first, unsigned shift, const KeyFn& key_fn,
+                      const Histogram& counts, Histogram& bucket_begin) {
+    Histogram next{}, bucket_end{};
+    std::size_t offset = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        bucket_begin[b] = offset;
+        next[b] = offset;
+        offset += counts[b];
+        bucket_end[b] = offset;
+    }
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        while (next[b] < bucket_end[b]) {
+            // Swap the element at next[b] to where it belongs until one that belongs in b arrives.
+            std::size_t d = digit_of(key_fn, first[next[b]], shift);
+            while (d != b) {
+                std::swap(first[next[b]], first[next[d]++]);
+                d = digit_of(key_fn, first[next[b]], shift);
+            }
+            ++next[b];
+        }
+    }
+}
+
+template<typename RandomIt, typename KeyFn>
+void msd_recurse(WorkStealingPool& pool, RandomIt first, std::size_t n, int shift, const KeyFn& key_fn) {
+    if (n <= kMsdSmallBucket || shift < 0) {
+        if (shift >= 0) sort_small(first, first + n, key_fn);
+        return;
+    }
+    Histogram counts{};
+    for (std::size_t i = 0; i < n; ++i) ++counts[digit_of(key_fn, first[i], static_cast<unsigned>(shift))];
+
+    Histogram bucket_begin{};
+    permute_in_place(first, static_cast<unsigned>(shift), key_fn, counts, bucket_begin);
+
+    TaskGroup group(pool);
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        const std::size_t size = counts[b];
+        if (size <= 1) continue;
+        RandomIt bucket = first + static_cast<std::ptrdiff_t>(bucket_begin[b]);
+        if (size >= kMsdParallelBucket) {
+            group.run([&pool, bucket, size, shift, &key_fn] {
+                msd_recurse(pool, bucket, size, shift - static_cast<int>(kDigitBits), key_fn);
+            });
+        } else {
+            msd_recurse(pool, bucket, size, shift - static_cast<int>(kDigitBits), key_fn);
+        }
+    }
+    group.wait();
+}
+
+} // namespace radix_detail
+
+// In-place MSD radix sort. The top-level histogram is computed in parallel, each
+// of the 256 resulting buckets is then sorted recursively as its own pool task.
+// Not stable; use radix_sort_lsd when equal keys must keep their order.
+template<typename RandomIt, typename KeyFn = RadixIdentityKey>
+void radix_sort_msd(WorkStealingPool& pool, RandomIt first, RandomIt last, KeyFn key_fn = KeyFn{}) {
+    using namespace radix_detail;
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using Key = key_type_t<KeyFn, T>;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const int top_shift = static_cast<int>(sizeof(Key) * 8 - kDigitBits);
+    if (n <= kMsdParallelBucket || pool.size() == 1) {
+        msd_recurse(pool, first, n, top_shift, key_fn);
+        return;
+    }
+
+    // Top level: parallel histogram, then one in-place permutation pass.
+    const std::size_t chunks = chunk_count(n, pool);
+    const std::size_t chunk_len = (n + chunks - 1) / chunks;
+    std::vector<Histogram> local(chunks, Histogram{});
+    parallel_for(pool, chunks, 1, [&](std::size_t c_begin, std::size_t c_end) {
+        for (std::size_t c = c_begin; c < c_end; ++c) {
+            const std::size_t end = std::min(n, (c + 1) * chunk_len);
+            for (std::size_t i = c * chunk_len; i < end; ++i) {
+                ++local[c][digit_of(key_fn, first[i], static_cast<unsigned>(top_shift))];
+            }
+        }
+    });
+    Histogram counts{};
+    for (const Histogram& h : local) {
+        for (std::size_t b = 0; b < kBuckets; ++b) counts[b] += h[b];
+    }
+    Histogram bucket_begin{};
+    permute_in_place(first, static_cast<unsigned>(top_shift), key_fn, counts, bucket_begin);
+
+    parallel_for(pool, kBuckets, 1, [&](std::size_t b_begin, std::size_t b_end) {
+        for (std::size_t b = b_begin; b < b_end; ++b) {
+            if (counts[b] > 1) {
+                msd_recurse(pool, first + static_cast<std::ptrdiff_t>(bucket_begin[b]), counts[b],
+                            top_shift - static_cast<int>(kDigitBits), key_fn);
+            }
+        }
+    });
+}
+
+// Stable LSD radix sort, one pass per 8-bit digit. Every pass computes per-chunk
+// histograms in parallel, turns them into per-chunk write offsets, and scatters
+// the chunks in parallel into a scratch buffer. Passes in which all keys share the
+// same digit (e.g. the high bytes of small values) are skipped.
+// Needs contiguous storage such as std::vector.
+template<typename RandomIt, typename KeyFn = RadixIdentityKey>
+void radix_sort_lsd(WorkStealingPool& pool, RandomIt first, RandomIt last, KeyFn key_fn = KeyFn{}) {
+    using namespace radix_detail;
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using Key = key_type_t<KeyFn, T>;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n <= kMsdSmallBucket) {
+        std::stable_sort(first, last, [&key_fn](const T& a, const T& b) {
+            return to_radix_key(key_fn(a)) < to_radix_key(key_fn(b));
+        });
+        return;
+    }
+
+    std::vector<T> scratch(n);
+    const std::size_t chunks = chunk_count(n, pool);
+    const std::size_t chunk_len = (n + chunks - 1) / chunks;
+    std::vector<Histogram> local(chunks);
+
+    // Ping-pong between the input range and the scratch buffer.
+    T* buffers[2] = {&*first, scratch.data()};
+    int src = 0;
+    for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += kDigitBits) {
+        const T* in = buffers[src];
+        T* out = buffers[1 - src];
+
+        parallel_for(pool, chunks, 1, [&](std::size_t c_begin, std::size_t c_end) {
+            for (std::size_t c = c_begin; c < c_end; ++c) {
+                Histogram h{};
+                const std::size_t end = std::min(n, (c + 1) * chunk_len);
+                for (std::size_t i = c * chunk_len; i < end; ++i) ++h[digit_of(key_fn, in[i], shift)];
+                local[c] = h;
+            }
+        });
+
+        // Exclusive prefix sum in (digit, chunk) order gives every chunk its write offsets.
+        std::size_t offset = 0;
+        bool trivial = false;
+        for (std::size_t b = 0; b < kBuckets && !trivial; ++b) {
+            std::size_t total = 0;
+            for (std::size_t c = 0; c < chunks; ++c) {
+                std::size_t count = local[c][b];
+                local[c][b] = offset;
+                offset += count;
+                total += count;
+            }
+            trivial = (total == n);
+        }
+        if (trivial) continue; // Every key has the same digit: this pass would not move anything
+
+        parallel_for(pool, chunks, 1, [&](std::size_t c_begin, std::size_t c_end) {
+            for (std::size_t c = c_begin; c < c_end; ++c) {
+                Histogram& write_pos = local[c];
+                const std::size_t end = std::min(n, (c + 1) * chunk_len);
+                for (std::size_t i = c * chunk_len; i < end; ++i) {
+                    out[write_pos[digit_of(key_fn, in[i], shift)]++] = in[i];
+                }
+            }
+        });
+        src = 1 - src;
+    }
+
+    if (src == 1) {
+        const T* sorted = scratch.data();
+        T* dest = &*first;
+        parallel_for(pool, n, 0, [&](std::size_t begin, std::size_t end) {
+            std::copy(sorted + begin, sorted + end, dest + begin);
+        });
+    }
+}
+
+/*
+Explanation:
+Radix sorts do not compare elements; they distribute them by the digits of an
+integer key. For fixed-width keys the work is O(n * digits) instead of the
+O(n log n) of comparison sorts, and every pass is a sequential sweep over memory.
+
+Key Mapping:
+-   `to_radix_key()` converts a key to an unsigned integer with the same order.
+    For signed types the sign bit is flipped, so `-5 < 3` still holds afterwards.
+-   A key function selects the key of a record: `[](const auto& p) { return p.first; }`
+    sorts `std::pair<std::uint64_t, Payload>` by key, carrying the payload along.
+
+LSD (least significant digit first), `radix_sort_lsd`:
+-   One pass per 8-bit digit from the lowest to the highest. Each pass is a stable
+    counting sort, so after the last pass the keys are fully ordered.
+-   Parallelization: the input is cut into chunks. Each chunk builds its own
+    256-entry histogram in parallel. A prefix sum over (digit, chunk) assigns every
+    chunk a private write position per digit, so the scatter pass runs in parallel
+    without synchronization and stays stable.
+-   Needs an O(n) scratch buffer. Stable, so it also suits key-value records.
+
+MSD (most significant digit first), `radix_sort_msd`:
+-   Distributes by the top byte in place (American flag sort: elements are swapped
+    directly into their bucket regions) and recurses into each of the 256 buckets
+    with the next byte. Small buckets are finished with `std::sort`.
+-   Parallelization: the top-level histogram is computed by all workers; the
+    buckets are independent sub-problems, so they are sorted in parallel and large
+    nested buckets spawn further tasks. The top-level permutation itself is sequential.
+-   No scratch buffer, but not stable.
+
+Usage Example:
+```cpp
+WorkStealingPool pool;
+std::vector<int> v = ...;
+radix_sort_msd(pool, v.begin(), v.end());
+std::vector<std::pair<std::uint64_t, float>> kv = ...;
+radix_sort_lsd(pool, kv.begin(), kv.end(), [](const auto& p) { return p.first; });
+```
+*/
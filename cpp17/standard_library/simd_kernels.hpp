@@ -0,0 +1,506 @@
+// simd_kernels.hpp
+// Hand-vectorized kernels for the workloads in parallel_algorithms.cpp, written with
+// SSE4.1 / AVX2 / AVX-512 intrinsics and selected at runtime via CPUID:
+// -   sum of int32 values (widened to int64, so it cannot overflow like an int32 sum)
+// -   min/max of int32 values
+// -   element-wise complex_calculation() map (int32 -> int64)
+// Every kernel has a scalar fallback, which is also what non-x86 targets get.
+// Only function-level target attributes are used, so no -mavx2 style flags are
+// required: the binary runs everywhere and picks the best kernels it can.
+#pragma once
+
+#include <algorithm>   // For std::min, std::max
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>     // For std::getenv
+#include <cstring>     // For std::strcmp
+#include <limits>
+#include <utility>     // For std::pair
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define SIMD_KERNELS_X86 0
+#endif
+
+// GCC and Clang need every function that uses an instruction set beyond the
+// compile flags to be annotated; MSVC allows intrinsics everywhere.
+#if SIMD_KERNELS_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+enum class SimdLevel { scalar = 0, sse4_1 = 1, avx2 = 2, avx512 = 3 };
+
+inline const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::sse4_1: return "sse4.1";
+        case SimdLevel::avx2: return "avx2";
+        case SimdLevel::avx512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+// Same computation as complex_calculation() in parallel_algorithms.cpp.
+inline long long complex_calculation_scalar(int val) {
+    long long res = 0;
+    for (int i = 0; i < 500; ++i) {
+        res += static_cast<long long>(val) * val * i / (i + 1);
+        res %= 1000000007;
+    }
+    return res;
+}
+
+namespace simd_detail {
+
+constexpr int kCalcIterations = 500;
+constexpr double kCalcModulus = 1000000007.0;
+// The vector kernels compute complex_calculation() in double precision, which is
+// exact as long as val*val*499 < 2^53. Larger inputs take the scalar path.
+constexpr int kCalcMaxAbs = 1 << 22;
+
+// 1/(i+1) for the quotients in complex_calculation(); multiplication is much
+// cheaper than division and the fix-up step below corrects the rounding.
+struct ReciprocalTable {
+    double inv[kCalcIterations];
+    ReciprocalTable() {
+        for (int i = 0; i < kCalcIterations; ++i) inv[i] = 1.0 / (i + 1);
+    }
+};
+
+inline const ReciprocalTable& reciprocals() {
+    static const ReciprocalTable table;
+    return table;
+}
+
+inline bool calc_in_range(int v) { return v >= -kCalcMaxAbs && v <= kCalcMaxAbs; }
+
+// --- scalar ---
+
+inline long long sum_i32_scalar(const int* data, std::size_t n) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += data[i];
+    return sum;
+}
+
+inline std::pair<int, int> minmax_i32_scalar(const int* data, std::size_t n) {
+    int lo = std::numeric_limits<int>::max(), hi = std::numeric_limits<int>::min();
+    for (std::size_t i = 0; i < n; ++i) {
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+    }
+    return {lo, hi};
+}
+
+inline void complex_calculation_map_scalar(const int* in, long long* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = complex_calculation_scalar(in[i]);
+}
+
+#if SIMD_KERNELS_X86
+
+// --- SSE4.1 (2 x int64 / 2 x double lanes) ---
+
+SIMD_TARGET("sse4.1")
+inline long long sum_i32_sse41(const int* data, std::size_t n) {
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(v));
+        acc1 = _mm_add_epi64(acc1, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+    }
+    alignas(16) long long lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + sum_i32_scalar(data + i, n - i);
+}
+
+SIMD_TARGET("sse4.1")
+inline std::pair<int, int> minmax_i32_sse41(const int* data, std::size_t n) {
+    __m128i lo = _mm_set1_epi32(std::numeric_limits<int>::max());
+    __m128i hi = _mm_set1_epi32(std::numeric_limits<int>::min());
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        lo = _mm_min_epi32(lo, v);
+        hi = _mm_max_epi32(hi, v);
+    }
+    alignas(16) int lo_lanes[4], hi_lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lo_lanes), lo);
+    _mm_store_si128(reinterpret_cast<__m128i*>(hi_lanes), hi);
+    std::pair<int, int> tail = minmax_i32_scalar(data + i, n - i);
+    for (int l = 0; l < 4; ++l) {
+        tail.first = std::min(tail.first, lo_lanes[l]);
+        tail.second = std::max(tail.second, hi_lanes[l]);
+    }
+    return tail;
+}
+
+// floor(x / d) for exact integers x >= 0, d > 0 given inv_d ~ 1/d: the estimate is
+// off by at most one, so one correction in each direction makes it exact.
+SIMD_TARGET("sse4.1")
+inline __m128d exact_div_sse41(__m128d x, __m128d d, __m128d inv_d) {
+    const __m128d one = _mm_set1_pd(1.0);
+    __m128d q = _mm_floor_pd(_mm_mul_pd(x, inv_d));
+    __m128d r = _mm_sub_pd(x, _mm_mul_pd(q, d));
+    q = _mm_sub_pd(q, _mm_and_pd(_mm_cmplt_pd(r, _mm_setzero_pd()), one));
+    q = _mm_add_pd(q, _mm_and_pd(_mm_cmpge_pd(r, d), one));
+    return q;
+}
+
+SIMD_TARGET("sse4.1")
+inline void complex_calculation_map_sse41(const int* in, long long* out, std::size_t n) {
+    const ReciprocalTable& table = reciprocals();
+    const __m128d modulus = _mm_set1_pd(kCalcModulus), inv_modulus = _mm_set1_pd(1.0 / kCalcModulus);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        if (!calc_in_range(in[i]) || !calc_in_range(in[i + 1])) {
+            out[i] = complex_calculation_scalar(in[i]);
+            out[i + 1] = complex_calculation_scalar(in[i + 1]);
+            continue;
+        }
+        __m128d v = _mm_set_pd(in[i + 1], in[i]);
+        __m128d sq = _mm_mul_pd(v, v);
+        __m128d res = _mm_setzero_pd();
+        for (int k = 0; k < kCalcIterations; ++k) {
+            __m128d t = _mm_mul_pd(sq, _mm_set1_pd(k));
+            res = _mm_add_pd(res, exact_div_sse41(t, _mm_set1_pd(k + 1), _mm_set1_pd(table.inv[k])));
+            res = _mm_sub_pd(res, _mm_mul_pd(exact_div_sse41(res, modulus, inv_modulus), modulus));
+        }
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, res);
+        out[i] = static_cast<long long>(lanes[0]);
+        out[i + 1] = static_cast<long long>(lanes[1]);
+    }
+    complex_calculation_map_scalar(in + i, out + i, n - i);
+}
+
+// --- AVX2 (4 x int64 / 4 x double lanes) ---
+
+// Horizontal reductions of one register, shared with the AVX-512 kernels (which
+// first fold their two 256-bit halves).
+SIMD_TARGET("avx2")
+inline long long hsum_epi64_avx2(__m256i v) {
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+SIMD_TARGET("avx2")
+inline std::pair<int, int> hminmax_epi32_avx2(__m256i lo, __m256i hi) {
+    alignas(32) int lo_lanes[8], hi_lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lo_lanes), lo);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hi_lanes), hi);
+    std::pair<int, int> r(lo_lanes[0], hi_lanes[0]);
+    for (int l = 1; l < 8; ++l) {
+        r.first = std::min(r.first, lo_lanes[l]);
+        r.second = std::max(r.second, hi_lanes[l]);
+    }
+    return r;
+}
+
+SIMD_TARGET("avx2")
+inline long long sum_i32_avx2(const int* data, std::size_t n) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    return hsum_epi64_avx2(_mm256_add_epi64(acc0, acc1)) + sum_i32_scalar(data + i, n - i);
+}
+
+SIMD_TARGET("avx2")
+inline std::pair<int, int> minmax_i32_avx2(const int* data, std::size_t n) {
+    __m256i lo = _mm256_set1_epi32(std::numeric_limits<int>::max());
+    __m256i hi = _mm256_set1_epi32(std::numeric_limits<int>::min());
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        lo = _mm256_min_epi32(lo, v);
+        hi = _mm256_max_epi32(hi, v);
+    }
+    const std::pair<int, int> lanes = hminmax_epi32_avx2(lo, hi);
+    std::pair<int, int> tail = minmax_i32_scalar(data + i, n - i);
+    tail.first = std::min(tail.first, lanes.first);
+    tail.second = std::max(tail.second, lanes.second);
+    return tail;
+}
+
+SIMD_TARGET("avx2")
+inline __m256d exact_div_avx2(__m256d x, __m256d d, __m256d inv_d) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d q = _mm256_floor_pd(_mm256_mul_pd(x, inv_d));
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(q, d));
+    q = _mm256_sub_pd(q, _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), one));
+    q = _mm256_add_pd(q, _mm256_and_pd(_mm256_cmp_pd(r, d, _CMP_GE_OQ), one));
+    return q;
+}
+
+SIMD_TARGET("avx2")
+inline void complex_calculation_map_avx2(const int* in, long long* out, std::size_t n) {
+    const ReciprocalTable& table = reciprocals();
+    const __m256d modulus = _mm256_set1_pd(kCalcModulus), inv_modulus = _mm256_set1_pd(1.0 / kCalcModulus);
+    const __m128i max_abs = _mm_set1_epi32(kCalcMaxAbs);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i vi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi32(_mm_abs_epi32(vi), max_abs)) != 0 ||
+            _mm_movemask_epi8(_mm_cmplt_epi32(_mm_abs_epi32(vi), _mm_setzero_si128())) != 0) {
+            complex_calculation_map_scalar(in + i, out + i, 4); // INT_MIN or too large for doubles
+            continue;
+        }
+        __m256d v = _mm256_cvtepi32_pd(vi);
+        __m256d sq = _mm256_mul_pd(v, v);
+        __m256d res = _mm256_setzero_pd();
+        for (int k = 0; k < kCalcIterations; ++k) {
+            __m256d t = _mm256_mul_pd(sq, _mm256_set1_pd(k));
+            res = _mm256_add_pd(res, exact_div_avx2(t, _mm256_set1_pd(k + 1), _mm256_set1_pd(table.inv[k])));
+            res = _mm256_sub_pd(res, _mm256_mul_pd(exact_div_avx2(res, modulus, inv_modulus), modulus));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, res);
+        for (int l = 0; l < 4; ++l) out[i + l] = static_cast<long long>(lanes[l]);
+    }
+    complex_calculation_map_scalar(in + i, out + i, n - i);
+}
+
+// --- AVX-512F (8 x int64 / 8 x double lanes) ---
+// GCC 12 implements the unmasked AVX-512 intrinsics (min/max, cvt, extract, even
+// _mm512_castsi512_si256, and the _mm512_reduce_* built on them) on top of
+// _mm512_undefined_*(), which -Wall reports as -Wmaybe-uninitialized inside
+// avx512fintrin.h (GCC PR 105593). The zero-masking forms with a full mask are the
+// same instructions without the warning, so only those are used below.
+
+SIMD_TARGET("avx512f")
+inline __m256i low_half_avx512(__m512i v) { return _mm512_maskz_extracti64x4_epi64(0xF, v, 0); }
+
+SIMD_TARGET("avx512f")
+inline __m256i high_half_avx512(__m512i v) { return _mm512_maskz_extracti64x4_epi64(0xF, v, 1); }
+
+SIMD_TARGET("avx512f")
+inline long long sum_i32_avx512(const int* data, std::size_t n) {
+    __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        acc0 = _mm512_add_epi64(acc0, _mm512_maskz_cvtepi32_epi64(0xFF, low_half_avx512(v)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_maskz_cvtepi32_epi64(0xFF, high_half_avx512(v)));
+    }
+    // Halves folded by hand rather than with _mm512_reduce_add_epi64 (see above).
+    const __m512i acc = _mm512_add_epi64(acc0, acc1);
+    const __m256i half = _mm256_add_epi64(low_half_avx512(acc), high_half_avx512(acc));
+    return hsum_epi64_avx2(half) + sum_i32_scalar(data + i, n - i);
+}
+
+SIMD_TARGET("avx512f")
+inline std::pair<int, int> minmax_i32_avx512(const int* data, std::size_t n) {
+    __m512i lo = _mm512_set1_epi32(std::numeric_limits<int>::max());
+    __m512i hi = _mm512_set1_epi32(std::numeric_limits<int>::min());
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        lo = _mm512_maskz_min_epi32(0xFFFF, lo, v);
+        hi = _mm512_maskz_max_epi32(0xFFFF, hi, v);
+    }
+    // Halves folded by hand, as in sum_i32_avx512.
+    const std::pair<int, int> lanes = hminmax_epi32_avx2(
+        _mm256_min_epi32(low_half_avx512(lo), high_half_avx512(lo)),
+        _mm256_max_epi32(low_half_avx512(hi), high_half_avx512(hi)));
+    std::pair<int, int> tail = minmax_i32_scalar(data + i, n - i);
+    tail.first = std::min(tail.first, lanes.first);
+    tail.second = std::max(tail.second, lanes.second);
+    return tail;
+}
+
+SIMD_TARGET("avx512f")
+inline __m512d exact_div_avx512(__m512d x, __m512d d, __m512d inv_d) {
+    const __m512d one = _mm512_set1_pd(1.0);
+    __m512d q = _mm512_maskz_roundscale_pd(0xFF, _mm512_mul_pd(x, inv_d), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_sub_pd(x, _mm512_mul_pd(q, d));
+    q = _mm512_mask_sub_pd(q, _mm512_cmp_pd_mask(r, _mm512_setzero_pd(), _CMP_LT_OQ), q, one);
+    q = _mm512_mask_add_pd(q, _mm512_cmp_pd_mask(r, d, _CMP_GE_OQ), q, one);
+    return q;
+}
+
+SIMD_TARGET("avx512f")
+inline void complex_calculation_map_avx512(const int* in, long long* out, std::size_t n) {
+    const ReciprocalTable& table = reciprocals();
+    const __m512d modulus = _mm512_set1_pd(kCalcModulus), inv_modulus = _mm512_set1_pd(1.0 / kCalcModulus);
+    const __m256i max_abs = _mm256_set1_epi32(kCalcMaxAbs);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i abs_v = _mm256_abs_epi32(vi); // INT_MIN stays negative
+        if (_mm256_movemask_epi8(_mm256_cmpgt_epi32(abs_v, max_abs)) != 0 ||
+            _mm256_movemask_epi8(_mm256_cmpgt_epi32(_mm256_setzero_si256(), abs_v)) != 0) {
+            complex_calculation_map_scalar(in + i, out + i, 8);
+            continue;
+        }
+        __m512d v = _mm512_maskz_cvtepi32_pd(0xFF, vi);
+        __m512d sq = _mm512_mul_pd(v, v);
+        __m512d res = _mm512_setzero_pd();
+        for (int k = 0; k < kCalcIterations; ++k) {
+            __m512d t = _mm512_mul_pd(sq, _mm512_set1_pd(k));
+            res = _mm512_add_pd(res, exact_div_avx512(t, _mm512_set1_pd(k + 1), _mm512_set1_pd(table.inv[k])));
+            res = _mm512_sub_pd(res, _mm512_mul_pd(exact_div_avx512(res, modulus, inv_modulus), modulus));
+        }
+        alignas(64) double lanes[8];
+        _mm512_store_pd(lanes, res);
+        for (int l = 0; l < 8; ++l) out[i + l] = static_cast<long long>(lanes[l]);
+    }
+    complex_calculation_map_scalar(in + i, out + i, n - i);
+}
+
+// --- CPU feature detection ---
+
+inline void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(r[i]);
+#else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Which register states the OS saves on context switch (XCR0). A CPU may support
+// AVX while the OS does not enable it, in which case AVX instructions fault.
+inline unsigned long long xgetbv0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    unsigned eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+inline SimdLevel detect_cpu_simd_level() {
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    const unsigned max_leaf = regs[0];
+    cpuid(1, 0, regs);
+    const bool sse41 = (regs[2] >> 19) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool avx = (regs[2] >> 28) & 1;
+    if (!sse41) return SimdLevel::scalar;
+    if (!osxsave || !avx) return SimdLevel::sse4_1;
+
+    const unsigned long long xcr0 = xgetbv0();
+    const bool os_ymm = (xcr0 & 0x6) == 0x6;    // XMM and YMM state
+    const bool os_zmm = (xcr0 & 0xE6) == 0xE6;  // plus opmask, ZMM0-15 upper halves, ZMM16-31
+    if (!os_ymm || max_leaf < 7) return SimdLevel::sse4_1;
+
+    cpuid(7, 0, regs);
+    const bool avx2 = (regs[1] >> 5) & 1;
+    const bool avx512f = (regs[1] >> 16) & 1;
+    if (avx512f && avx2 && os_zmm) return SimdLevel::avx512;
+    if (avx2) return SimdLevel::avx2;
+    return SimdLevel::sse4_1;
+}
+
+#endif // SIMD_KERNELS_X86
+
+} // namespace simd_detail
+
+// Highest instruction set level usable on this machine. The environment variable
+// SIMD_MAX_LEVEL (scalar, sse4.1, avx2, avx512) caps it, e.g. to compare paths.
+inline SimdLevel detect_simd_level() {
+#if SIMD_KERNELS_X86
+    SimdLevel level = simd_detail::detect_cpu_simd_level();
+#else
+    SimdLevel level = SimdLevel::scalar;
+#endif
+    if (const char* cap = std::getenv("SIMD_MAX_LEVEL")) {
+        for (SimdLevel l : {SimdLevel::scalar, SimdLevel::sse4_1, SimdLevel::avx2, SimdLevel::avx512}) {
+            if (std::strcmp(cap, simd_level_name(l)) == 0 && l < level) level = l;
+        }
+    }
+    return level;
+}
+
+// All levels up to the detected one, lowest first (always starts with scalar).
+inline std::vector<SimdLevel> supported_simd_levels() {
+    std::vector<SimdLevel> levels;
+    const SimdLevel best = detect_simd_level();
+    for (SimdLevel l : {SimdLevel::scalar, SimdLevel::sse4_1, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (l <= best) levels.push_back(l);
+    }
+    return levels;
+}
+
+// One set of function pointers per instruction set level.
+struct SimdKernels {
+    SimdLevel level;
+    long long (*sum_i32)(const int* data, std::size_t n);
+    std::pair<int, int> (*minmax_i32)(const int* data, std::size_t n); // {INT_MAX, INT_MIN} if n == 0
+    void (*complex_calculation_map)(const int* in, long long* out, std::size_t n);
+};
+
+// Kernels for a specific level. The caller must make sure the CPU supports it.
+inline SimdKernels simd_kernels_for(SimdLevel level) {
+    using namespace simd_detail;
+    switch (level) {
+#if SIMD_KERNELS_X86
+        case SimdLevel::avx512:
+            return {level, sum_i32_avx512, minmax_i32_avx512, complex_calculation_map_avx512};
+        case SimdLevel::avx2:
+            return {level, sum_i32_avx2, minmax_i32_avx2, complex_calculation_map_avx2};
+        case SimdLevel::sse4_1:
+            return {level, sum_i32_sse41, minmax_i32_sse41, complex_calculation_map_sse41};
+#endif
+        default:
+            return {SimdLevel::scalar, sum_i32_scalar, minmax_i32_scalar, complex_calculation_map_scalar};
+    }
+}
+
+// The best kernels for this machine, resolved once on first use.
+inline const SimdKernels& simd_kernels() {
+    static const SimdKernels kernels = simd_kernels_for(detect_simd_level());
+    return kernels;
+}
+
+/*
+Explanation:
+`std::execution::par_unseq` and `unseq` *allow* vectorization, but whether the
+compiler and standard library actually emit SIMD code (and for which instruction
+set) depends on compile flags: without `-mavx2`, GCC targets baseline SSE2. These
+kernels make the vector code explicit and choose the instruction set at runtime.
+
+Runtime Dispatch:
+-   `detect_simd_level()` queries CPUID for SSE4.1, AVX2 and AVX-512F and uses
+    XGETBV to confirm the operating system saves the wider registers.
+-   `simd_kernels()` resolves a table of function pointers once; every call after
+    that is a single indirect call. `simd_kernels_for(level)` returns the table for
+    a lower level, which is how the benchmark compares the paths side by side.
+-   Each kernel is compiled with `__attribute__((target("avx2")))` etc., so the
+    rest of the program is built for the baseline ISA and still runs on old CPUs.
+
+The Kernels:
+-   `sum_i32`: widens int32 lanes to int64 before adding (`cvtepi32_epi64`), which
+    matches `std::reduce(..., 0LL)` exactly. Two accumulators hide add latency.
+-   `minmax_i32`: `pminsd`/`pmaxsd` over the whole range, then a horizontal reduce.
+-   `complex_calculation_map`: the loop in `complex_calculation()` uses 64-bit
+    integer division, which x86 SIMD does not have. The kernel uses doubles
+    instead: for |val| <= 2^22 every intermediate value is an integer below 2^53
+    and therefore exact. Quotients are estimated with a multiplication by the
+    reciprocal and corrected by one step in each direction, so the result is
+    bit-identical to the scalar version. Out-of-range inputs use the scalar path.
+
+Usage Example:
+```cpp
+const SimdKernels& k = simd_kernels();
+std::cout << "Using " << simd_level_name(k.level) << std::endl;
+long long sum = k.sum_i32(v.data(), v.size());
+```
+*/
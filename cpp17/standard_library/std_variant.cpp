@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <iomanip>  // For std::fixed, std::setprecision
+#include <memory_resource> // For std::pmr::string, std::pmr::vector
+
+#include "arena_resource.hpp" // MonotonicArena + ArenaResource: bump-pointer std::pmr resource
 
 // Visitor struct for std::visit
 struct MyVisitor {
@@ -127,6 +130,33 @@ int main() {
     std::cout << "var_default_str_first holds: \"" << std::get<std::string>(var_default_str_first) << "\"" << std::endl;
 
 
+    // 6. Variants of allocating types in an arena (arena_resource.hpp)
+    std::cout << "\n6. Variants in a request-scoped arena:" << std::endl;
+    {
+        MonotonicArena arena(4096);
+        ArenaResource resource(arena);
+        using Token = std::variant<int, double, std::pmr::string>;
+        for (int request = 1; request <= 2; ++request) {
+            {
+                std::pmr::vector<Token> tokens(&resource); // The vector's buffer comes from the arena
+                tokens.reserve(4);
+                tokens.emplace_back(request);
+                tokens.emplace_back(2.5);
+                // std::variant is not allocator-aware: the vector cannot pass its resource
+                // on, so the string alternative gets it explicitly.
+                tokens.emplace_back(std::in_place_type<std::pmr::string>,
+                                    "a string long enough to need a heap buffer", &resource);
+                const auto& text = std::get<std::pmr::string>(tokens.back());
+                std::cout << "request " << request << ": " << tokens.size() << " tokens, string uses the arena: "
+                          << std::boolalpha << (text.get_allocator().resource() == &resource)
+                          << ", arena bytes used: " << arena.bytes_used() << std::endl;
+            } // Destructors run; the memory stays in the arena until reset()
+            arena.reset(); // The next request reuses the same block
+        }
+        std::cout << "blocks allocated over both requests: " << arena.block_count() << std::endl;
+    }
+
+
     std::cout << "\nVariant example finished." << std::endl;
     return 0;
 }
@@ -183,6 +213,19 @@ Key Features:
         the old value cannot be restored. This is a rare state.
     -   `v.valueless_by_exception()` checks for this.
 
+6.  Allocating alternatives and memory resources (`arena_resource.hpp`):
+    -   A variant stores its alternative inline, but an alternative such as a string
+        or a vector still allocates its own buffer. With `std::pmr::string` and an
+        `ArenaResource` over a `MonotonicArena`, those buffers are bump-allocated
+        from a block that `arena.reset()` recycles after each request.
+    -   `std::variant` itself is not allocator-aware (it has no `allocator_type`), so
+        a `std::pmr::vector<std::variant<...>>` cannot pass its resource on to the
+        string inside: emplace it with `std::in_place_type<std::pmr::string>` and
+        the resource as the last constructor argument. Otherwise the string silently
+        uses the default resource (the global heap).
+    -   See `bench/bench_arena_resource.cpp` for request-scoped workloads on the global
+        heap, `std::pmr::monotonic_buffer_resource` and the arena.
+
 Use Cases:
 -   Representing sum types (a value can be one of several distinct types).
 -   Implementing state machines where states have different associated data.
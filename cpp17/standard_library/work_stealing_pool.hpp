@@ -0,0 +1,334 @@
+// work_stealing_pool.hpp
+// A small work-stealing thread pool plus fork-join helpers (parallel_for,
+// parallel_transform, parallel_reduce, parallel_sort) built on top of it.
+// Used by parallel_algorithms.cpp to get real multi-core scaling even when the
+// standard library's std::execution::par backend runs sequentially.
+#pragma once
+
+#include <algorithm>   // For std::sort, std::inplace_merge, std::min
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>  // For std::function, std::less
+#include <iterator>    // For std::distance, std::advance
+#include <memory>      // For std::unique_ptr
+#include <mutex>
+#include <numeric>     // For std::accumulate
+#include <thread>
+#include <utility>     // For std::move
+#include <vector>
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // num_workers == 0 means "one worker per hardware thread".
+    explicit WorkStealingPool(unsigned num_workers = 0) {
+        if (num_workers == 0) {
+            num_workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        queues_.reserve(num_workers);
+        for (unsigned i = 0; i < num_workers; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        threads_.reserve(num_workers);
+        for (unsigned i = 0; i < num_workers; ++i) {
+            threads_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (std::thread& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+    // Pushes a task. From a worker thread it goes to the bottom of that worker's
+    // own deque (LIFO, cache-warm); from outside it is spread round-robin.
+    void submit(Task task) {
+        const WorkerInfo& self = current_worker();
+        std::size_t index;
+        if (self.pool == this) {
+            index = self.index;
+        } else {
+            index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        }
+        pending_.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            // Taking the lock orders this notify after a sleeper's predicate check.
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    // Runs one queued task on the calling thread if any is available.
+    // Lets threads that wait on a TaskGroup help instead of blocking.
+    bool try_run_one() {
+        const WorkerInfo& self = current_worker();
+        std::size_t home = self.pool == this ? self.index : 0;
+        Task task;
+        if (pop_or_steal(home, task)) {
+            task();
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct WorkerInfo {
+        const WorkStealingPool* pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static WorkerInfo& current_worker() {
+        thread_local WorkerInfo info;
+        return info;
+    }
+
+    // The owner takes from the back of its own deque; thieves take from the
+    // front of other deques, so they grab the oldest (usually largest) tasks.
+    bool pop_or_steal(std::size_t home, Task& out) {
+        {
+            WorkerQueue& own = *queues_[home];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                out = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+            WorkerQueue& victim = *queues_[(home + offset) % queues_.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(std::size_t index) {
+        current_worker().pool = this;
+        current_worker().index = index;
+        Task task;
+        for (;;) {
+            if (pop_or_steal(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] {
+                return stopping_ || pending_.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping_ && pending_.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_queue_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stopping_ = false;
+};
+
+// Fork-join scope: run() spawns tasks into the pool, wait() blocks until all of
+// them finished, executing queued work on the waiting thread in the meantime.
+// Helping (rather than sleeping) is what makes nested parallelism deadlock-free.
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template<typename F>
+    void run(F&& f) {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([this, fn = std::forward<F>(f)]() mutable {
+            fn();
+            outstanding_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait() {
+        while (outstanding_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.try_run_one()) std::this_thread::yield();
+        }
+    }
+
+private:
+    WorkStealingPool& pool_;
+    std::atomic<std::size_t> outstanding_{0};
+};
+
+// Picks a chunk size that gives each worker several chunks (so stealing can
+// balance uneven work) without making chunks so small that overhead dominates.
+inline std::size_t default_grain_size(std::size_t n, const WorkStealingPool& pool,
+                                      std::size_t min_grain = 1024) {
+    std::size_t chunks = static_cast<std::size_t>(pool.size()) * 8;
+    return std::max(min_grain, (n + chunks - 1) / chunks);
+}
+
+// Calls body(begin, end) for consecutive sub-ranges of [0, n).
+template<typename Body>
+void parallel_for(WorkStealingPool& pool, std::size_t n, std::size_t grain, Body body) {
+    if (n == 0) return;
+    if (grain == 0) grain = default_grain_size(n, pool);
+    if (n <= grain || pool.size() == 1) {
+        body(std::size_t{0}, n);
+        return;
+    }
+    TaskGroup group(pool);
+    for (std::size_t begin = grain; begin < n; begin += grain) {
+        std::size_t end = std::min(n, begin + grain);
+        group.run([&body, begin, end] { body(begin, end); });
+    }
+    body(std::size_t{0}, std::min(n, grain)); // The caller works on the first chunk itself
+    group.wait();
+}
+
+template<typename InputIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(WorkStealingPool& pool, InputIt first, InputIt last,
+                            OutputIt d_first, UnaryOp op, std::size_t grain = 0) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    parallel_for(pool, n, grain, [&](std::size_t begin, std::size_t end) {
+        InputIt in = first;
+        std::advance(in, begin);
+        OutputIt out = d_first;
+        std::advance(out, begin);
+        for (std::size_t i = begin; i < end; ++i, ++in, ++out) {
+            *out = op(*in);
+        }
+    });
+    std::advance(d_first, n);
+    return d_first;
+}
+
+// Like std::reduce: op must be associative and commutative, init is folded in once.
+template<typename InputIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(WorkStealingPool& pool, InputIt first, InputIt last, T init,
+                  BinaryOp op = BinaryOp{}, std::size_t grain = 0) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if (n == 0) return init;
+    if (grain == 0) grain = default_grain_size(n, pool);
+    const std::size_t num_chunks = (n + grain - 1) / grain;
+    std::vector<T> partials(num_chunks, T{});
+    parallel_for(pool, num_chunks, 1, [&](std::size_t chunk_begin, std::size_t chunk_end) {
+        for (std::size_t c = chunk_begin; c < chunk_end; ++c) {
+            InputIt it = first;
+            std::advance(it, c * grain);
+            const std::size_t end = std::min(n, (c + 1) * grain);
+            T acc = *it;
+            ++it;
+            for (std::size_t i = c * grain + 1; i < end; ++i, ++it) {
+                acc = op(std::move(acc), *it);
+            }
+            partials[c] = std::move(acc);
+        }
+    });
+    return std::accumulate(partials.begin(), partials.end(), std::move(init), op);
+}
+
+// Sorts equal-sized runs in parallel, then merges neighbouring runs pairwise
+// (each merge round is itself parallel) until one sorted run is left.
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_sort(WorkStealingPool& pool, RandomIt first, RandomIt last,
+                   Compare comp = Compare{}, std::size_t min_run = 1 << 14) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n <= min_run || pool.size() == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    std::size_t runs = std::min<std::size_t>(pool.size() * 4, (n + min_run - 1) / min_run);
+    const std::size_t run_len = (n + runs - 1) / runs;
+    runs = (n + run_len - 1) / run_len;
+
+    parallel_for(pool, runs, 1, [&](std::size_t r_begin, std::size_t r_end) {
+        for (std::size_t r = r_begin; r < r_end; ++r) {
+            std::sort(first + r * run_len, first + std::min(n, (r + 1) * run_len), comp);
+        }
+    });
+
+    for (std::size_t width = run_len; width < n; width *= 2) {
+        const std::size_t pairs = (n + 2 * width - 1) / (2 * width);
+        parallel_for(pool, pairs, 1, [&](std::size_t p_begin, std::size_t p_end) {
+            for (std::size_t p = p_begin; p < p_end; ++p) {
+                const std::size_t lo = p * 2 * width;
+                const std::size_t mid = std::min(n, lo + width);
+                const std::size_t hi = std::min(n, lo + 2 * width);
+                if (mid < hi) std::inplace_merge(first + lo, first + mid, first + hi, comp);
+            }
+        });
+    }
+}
+
+/*
+Explanation:
+The C++17 execution policies only *permit* parallelism; whether `std::execution::par`
+actually uses more than one core is up to the standard library build. libstdc++
+forwards to Intel TBB when it was configured with it and otherwise runs the
+"parallel" algorithms sequentially. This header provides a self-contained backend
+so the showcase can demonstrate real scaling on any toolchain.
+
+Work Stealing:
+-   Every worker owns a deque. Tasks spawned by a worker are pushed to the back of
+    its own deque and popped from the back again (LIFO), which keeps the most
+    recently touched data hot in that core's cache.
+-   An idle worker steals from the *front* of another worker's deque (FIFO). In
+    divide-and-conquer algorithms the oldest task is usually the biggest chunk,
+    so a single steal moves a lot of work.
+-   Each deque is guarded by its own mutex, so contention only happens between an
+    owner and a thief of the same deque. Thieves use `try_to_lock` and simply move
+    on to the next victim instead of queueing up behind a busy lock.
+-   Sleeping workers are woken through one condition variable when new work appears.
+
+Fork-Join (`TaskGroup`):
+-   `run()` spawns a task, `wait()` returns once all spawned tasks finished.
+-   While waiting, the thread executes queued tasks itself. This is essential when
+    tasks spawn nested tasks: a blocked waiter would otherwise hold a worker hostage
+    and could deadlock a pool with few workers.
+
+Algorithms:
+-   `parallel_for(pool, n, grain, body)`: calls `body(begin, end)` on chunks of [0, n).
+-   `parallel_transform(pool, first, last, d_first, op)`: like `std::transform`.
+-   `parallel_reduce(pool, first, last, init, op)`: like `std::reduce`; `op` must be
+    associative and commutative because chunks are combined in unspecified grouping.
+-   `parallel_sort(pool, first, last, comp)`: sorts runs in parallel and merges them
+    pairwise in parallel rounds. Not stable (uses `std::sort` per run).
+
+Usage Example:
+```cpp
+WorkStealingPool pool;            // One worker per hardware thread
+WorkStealingPool pool4(4);        // Exactly four workers
+parallel_sort(pool, v.begin(), v.end());
+long long sum = parallel_reduce(pool, v.begin(), v.end(), 0LL);
+```
+*/
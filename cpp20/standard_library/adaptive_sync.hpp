@@ -0,0 +1,197 @@
+// adaptive_sync.hpp
+// A latch and a barrier for very short phases: a waiting thread first spins (with the
+// CPU's pause instruction) for a bounded time, and only then parks in the kernel with
+// a Linux futex. Releasing threads make a futex system call only if someone is parked.
+// - AdaptiveLatch: single use, like std::latch
+// - AdaptiveBarrier<Completion>: reusable, like std::barrier (with a completion function)
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>    // For INT_MAX
+#include <cstddef>
+#include <cstdint>
+#include <thread>     // For std::thread::hardware_concurrency
+#include <utility>    // For std::move
+
+#if defined(__linux__)
+#include <linux/futex.h> // FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h> // SYS_futex
+#include <unistd.h>      // syscall
+#endif
+
+#include "../../cpp11/standard_library/contention.hpp" // cpu_pause, kFalseSharingPad
+
+namespace adaptive_detail {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+              std::atomic<std::uint32_t>::is_always_lock_free,
+              "futex words must be plain 32-bit integers");
+
+// Sleeps while `word` still holds `expected`. May return spuriously; callers re-check.
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    word.wait(expected, std::memory_order_acquire); // Portable fallback (C++20)
+#endif
+}
+
+inline void futex_wake_all(std::atomic<std::uint32_t>& word) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    word.notify_all();
+#endif
+}
+
+// Spinning only helps if the thread we wait for can run at the same time.
+inline std::chrono::nanoseconds default_spin() {
+    return std::thread::hardware_concurrency() > 1 ? std::chrono::microseconds(20) : std::chrono::nanoseconds(0);
+}
+
+// Waits until ready() is true: spins for up to `spin`, then sleeps on `word` (which the
+// releasing side changes before waking). `parked` counts sleepers so that releases
+// can skip the wake-up system call when nobody sleeps.
+template<typename Ready>
+void spin_then_park(Ready ready, std::atomic<std::uint32_t>& word, std::atomic<std::uint32_t>& parked,
+                    std::chrono::nanoseconds spin) {
+    if (ready()) return;
+    if (spin.count() > 0) {
+        const auto deadline = std::chrono::steady_clock::now() + spin;
+        for (unsigned i = 1;; ++i) {
+            cpu_pause();
+            if (ready()) return;
+            if (i % 64 == 0 && std::chrono::steady_clock::now() >= deadline) break; // Clock reads are not free
+        }
+    }
+    // seq_cst: either the releaser sees parked > 0 and wakes us, or we see its change.
+    parked.fetch_add(1, std::memory_order_seq_cst);
+    for (;;) {
+        const std::uint32_t value = word.load(std::memory_order_seq_cst);
+        if (ready()) break;
+        futex_wait(word, value); // Returns at once if word != value
+    }
+    parked.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Padded so that the words waiters spin on do not share a line with other data.
+struct alignas(kFalseSharingPad) PaddedWord {
+    std::atomic<std::uint32_t> value{0};
+};
+
+} // namespace adaptive_detail
+
+// Drop-in for std::latch: count_down, wait, try_wait, arrive_and_wait.
+class AdaptiveLatch {
+public:
+    explicit AdaptiveLatch(std::ptrdiff_t expected, std::chrono::nanoseconds spin = adaptive_detail::default_spin())
+        : spin_(spin) {
+        count_.value.store(static_cast<std::uint32_t>(expected), std::memory_order_relaxed);
+    }
+
+    AdaptiveLatch(const AdaptiveLatch&) = delete;
+    AdaptiveLatch& operator=(const AdaptiveLatch&) = delete;
+
+    void count_down(std::ptrdiff_t n = 1) {
+        const std::uint32_t before = count_.value.fetch_sub(static_cast<std::uint32_t>(n), std::memory_order_seq_cst);
+        if (before == static_cast<std::uint32_t>(n) && parked_.value.load(std::memory_order_seq_cst) != 0) {
+            adaptive_detail::futex_wake_all(count_.value);
+        }
+    }
+
+    bool try_wait() const noexcept { return count_.value.load(std::memory_order_acquire) == 0; }
+
+    void wait() const {
+        adaptive_detail::spin_then_park([this] { return try_wait(); }, count_.value, parked_.value, spin_);
+    }
+
+    void arrive_and_wait(std::ptrdiff_t n = 1) {
+        count_down(n);
+        wait();
+    }
+
+private:
+    mutable adaptive_detail::PaddedWord count_;  // The futex word
+    mutable adaptive_detail::PaddedWord parked_;
+    const std::chrono::nanoseconds spin_;
+};
+
+struct NoCompletion {
+    void operator()() noexcept {}
+};
+
+// Drop-in for the common use of std::barrier: arrive_and_wait() by a fixed number of
+// participants, phase after phase. The completion function runs on the last thread
+// to arrive, before anyone is released.
+template<typename Completion = NoCompletion>
+class AdaptiveBarrier {
+public:
+    explicit AdaptiveBarrier(std::ptrdiff_t participants, Completion completion = Completion(),
+                             std::chrono::nanoseconds spin = adaptive_detail::default_spin())
+        : participants_(static_cast<std::uint32_t>(participants)), completion_(std::move(completion)), spin_(spin) {}
+
+    AdaptiveBarrier(const AdaptiveBarrier&) = delete;
+    AdaptiveBarrier& operator=(const AdaptiveBarrier&) = delete;
+
+    void arrive_and_wait() {
+        // The generation (the futex word) changes exactly once per phase.
+        const std::uint32_t generation = generation_.value.load(std::memory_order_acquire);
+        if (arrived_.value.fetch_add(1, std::memory_order_acq_rel) + 1 == participants_) {
+            // Last to arrive: nobody can arrive for the next phase before the generation changes.
+            arrived_.value.store(0, std::memory_order_relaxed);
+            completion_();
+            generation_.value.fetch_add(1, std::memory_order_seq_cst);
+            if (parked_.value.load(std::memory_order_seq_cst) != 0) adaptive_detail::futex_wake_all(generation_.value);
+            return;
+        }
+        adaptive_detail::spin_then_park(
+            [this, generation] { return generation_.value.load(std::memory_order_acquire) != generation; },
+            generation_.value, parked_.value, spin_);
+    }
+
+private:
+    const std::uint32_t participants_;
+    Completion completion_;
+    const std::chrono::nanoseconds spin_;
+    adaptive_detail::PaddedWord arrived_;
+    adaptive_detail::PaddedWord generation_;
+    adaptive_detail::PaddedWord parked_;
+};
+
+/*
+Explanation:
+When a thread waits for an event that is only a microsecond away, the way it waits
+determines how late it notices the event:
+-   Sleeping in the kernel (futex, which `std::latch`/`std::barrier` use in libstdc++
+    after a short spin) frees the CPU, but waking takes a system call on the
+    releasing side and a scheduler wake-up on the waiting side: several
+    microseconds, sometimes much more.
+-   Spinning notices the event within nanoseconds (one cache-line transfer), but
+    burns the CPU and, with more threads than cores, can delay the very thread
+    it is waiting for.
+
+The adaptive primitives do both: spin with `pause` (which saves power and frees
+execution resources for the SMT sibling) for a bounded time (20 us by default, 0 on
+single-CPU machines), then park on a futex. A `parked` counter lets the releasing
+thread skip the `FUTEX_WAKE` system call entirely when every waiter is still spinning.
+
+Memory ordering: the waiter increments `parked` and then re-reads the word; the
+releaser changes the word and then reads `parked`. Both sides use sequentially
+consistent operations, so at least one of them sees the other: either the waiter sees
+the release and does not sleep, or the releaser sees the sleeper and wakes it.
+
+On systems without futexes, `std::atomic::wait`/`notify_all` (C++20) are used instead.
+`bench/bench_adaptive_sync.cpp` measures the release-to-wake latency against
+`std::latch` and `std::barrier`.
+
+Usage Example:
+```cpp
+AdaptiveLatch done(4);
+// in each of 4 workers: ...work...; done.count_down();
+done.wait();
+
+AdaptiveBarrier<> phase(4);
+// in each of 4 workers, every step: compute(step); phase.arrive_and_wait();
+```
+*/
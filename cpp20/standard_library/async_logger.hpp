@@ -0,0 +1,440 @@
+// async_logger.hpp
+// Asynchronous logging for many threads. log() only copies the format string's address
+// and the arguments into the calling thread's own lock-free ring buffer; a background
+// thread formats the records and writes them to the output in large batches.
+// - AsyncLogger: log(format, args...), flush(), dropped()
+// - Placeholders are "{}" (like std::format, without format specs; "{{" and "}}" escape)
+// - Records of one thread keep their order; records of different threads may interleave
+#pragma once
+
+#include <atomic>
+#include <charconv>           // For std::to_chars
+#include <chrono>
+#include <concepts>           // C++20 concepts
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>             // For std::FILE, std::fwrite, std::fflush
+#include <functional>         // For std::function
+#include <memory>             // For std::shared_ptr, std::unique_ptr
+#include <mutex>
+#include <new>                // For placement new
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>              // For std::tuple, std::apply
+#include <type_traits>
+#include <utility>            // For std::forward, std::move
+#include <vector>
+
+#include "../../cpp11/standard_library/contention.hpp" // kFalseSharingPad
+
+namespace async_log_detail {
+
+// One record: the formatting function plus the captured arguments, in 256 bytes.
+inline constexpr std::size_t kSlotSize = 256;
+
+inline std::size_t round_up_pow2(std::size_t n) {
+    std::size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// --- Formatting (runs on the background thread) ---
+
+inline void append(std::string& out, const std::string& text) { out += text; }
+inline void append(std::string& out, bool value) { out += value ? "true" : "false"; }
+inline void append(std::string& out, char value) { out += value; }
+
+template<typename T>
+    requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+void append(std::string& out, T value) {
+    char buffer[64];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+inline void append(std::string& out, const void* pointer) {
+    char buffer[2 + 2 * sizeof(void*)] = {'0', 'x'};
+    const auto result = std::to_chars(buffer + 2, buffer + sizeof(buffer), reinterpret_cast<std::uintptr_t>(pointer), 16);
+    out.append(buffer, result.ptr);
+}
+
+// What a record stores for an argument of type T: text is copied into a std::string
+// (the caller's buffer may be gone by the time the record is formatted), everything
+// else by value.
+template<typename T>
+using stored_t = std::conditional_t<std::is_convertible_v<const std::decay_t<T>&, std::string_view>,
+                                    std::string, std::decay_t<T>>;
+
+template<typename T>
+concept Loggable = std::constructible_from<stored_t<T>, T> &&
+                   requires(std::string& out, const stored_t<T>& value) { append(out, value); };
+
+template<typename T>
+void append_erased(std::string& out, const void* value) {
+    append(out, *static_cast<const T*>(value));
+}
+
+// Replaces each "{}" in `format` with the next argument. Surplus "{}" are copied as
+// they are, surplus arguments are ignored.
+template<typename... Args>
+void expand_placeholders(std::string& out, const char* format, const Args&... args) {
+    using Appender = void (*)(std::string&, const void*);
+    const void* values[] = {static_cast<const void*>(&args)..., nullptr}; // nullptr: never empty
+    const Appender appenders[] = {&append_erased<Args>..., nullptr};
+    std::size_t next = 0;
+    const char* literal = format; // Start of the text not yet copied
+    const char* p = format;
+    for (; *p != '\0'; ++p) {
+        const bool open = p[0] == '{', close = p[0] == '}';
+        if ((open && p[1] == '{') || (close && p[1] == '}')) {
+            out.append(literal, p + 1); // Keep one brace
+            literal = p + 2;
+            ++p;
+        } else if (open && p[1] == '}' && next < sizeof...(Args)) {
+            out.append(literal, p);
+            appenders[next](out, values[next]);
+            ++next;
+            literal = p + 2;
+            ++p;
+        }
+    }
+    out.append(literal, p);
+}
+
+template<typename... Args>
+struct Record {
+    const char* format;
+    std::tuple<Args...> args;
+};
+
+// Formats the record in `payload` as one line of `out`, then destroys it.
+using FormatFn = void (*)(void* payload, std::string& out);
+
+template<typename... Args>
+void format_record(void* payload, std::string& out) {
+    auto* record = static_cast<Record<Args...>*>(payload);
+    std::apply([&](const Args&... args) { expand_placeholders(out, record->format, args...); }, record->args);
+    out += '\n';
+    record->~Record();
+}
+
+struct alignas(64) Slot {
+    FormatFn format = nullptr;
+    alignas(std::max_align_t) unsigned char payload[kSlotSize - alignof(std::max_align_t)];
+};
+static_assert(sizeof(Slot) == kSlotSize, "a slot is exactly kSlotSize bytes");
+
+// Single-producer (the owning thread), single-consumer (the flusher) ring of slots.
+// Records are constructed in place by the producer and formatted in place by the
+// consumer, so nothing is copied twice and nothing is allocated per message.
+class Ring {
+public:
+    explicit Ring(std::size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1), slots_(new Slot[mask_ + 1]) {}
+
+    ~Ring() {
+        std::string discard; // Destroys records nobody formatted
+        drain(discard, mask_ + 1);
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    // Producer: the slot for the next record, or nullptr if the ring is full.
+    Slot* try_claim() {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    // Producer: makes the claimed slot visible to the consumer.
+    void publish() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer: formats up to `max` records into `out`; returns how many.
+    std::size_t drain(std::string& out, std::size_t max) {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+        std::size_t n = 0;
+        for (; head != tail && n < max; ++head, ++n) {
+            Slot& slot = slots_[head & mask_];
+            slot.format(slot.payload, out);
+        }
+        head_.store(head, std::memory_order_release); // Frees the slots for the producer
+        return n;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    std::atomic<bool> owner_exited{false}; // Set when the producing thread ends
+    std::atomic<bool> orphaned{false};     // Set when the logger is destroyed
+
+private:
+    const std::size_t mask_;
+    const std::unique_ptr<Slot[]> slots_;
+    // Each index on its own kFalseSharingPad, so the two sides never write the same line.
+    alignas(kFalseSharingPad) std::atomic<std::uint64_t> head_{0}; // Written by the consumer
+    alignas(kFalseSharingPad) std::atomic<std::uint64_t> tail_{0}; // Written by the producer
+    std::uint64_t cached_head_ = 0;                    // Producer's last view of head_
+};
+
+// The rings of the current thread, one per logger it has used (keyed by logger id).
+struct ThreadRings {
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<Ring>>> rings;
+
+    ~ThreadRings() {
+        for (auto& entry : rings) entry.second->owner_exited.store(true, std::memory_order_release);
+    }
+};
+
+inline ThreadRings& thread_rings() {
+    thread_local ThreadRings rings;
+    return rings;
+}
+
+inline std::uint64_t next_logger_id() {
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+}
+
+} // namespace async_log_detail
+
+enum class OverflowPolicy {
+    block, // log() waits (yielding) until the flusher frees a slot
+    drop   // log() discards the record and counts it in dropped()
+};
+
+struct AsyncLoggerOptions {
+    std::size_t ring_capacity = 4096;              // Records per thread (rounded up to a power of two)
+    OverflowPolicy overflow = OverflowPolicy::block;
+    std::size_t batch_bytes = 64 * 1024;           // Write once this much text is formatted
+    std::chrono::microseconds idle_sleep{200};     // Flusher's nap when every ring is empty
+};
+
+class AsyncLogger {
+public:
+    // Called with each batch of complete lines instead of writing to a FILE*.
+    using Sink = std::function<void(std::string_view batch)>;
+
+    explicit AsyncLogger(std::FILE* out = stdout, AsyncLoggerOptions options = {})
+        : AsyncLogger(out, Sink(), options) {}
+
+    explicit AsyncLogger(Sink sink, AsyncLoggerOptions options = {})
+        : AsyncLogger(nullptr, std::move(sink), options) {}
+
+    // Writes everything logged so far, then stops the flusher. No thread may still be
+    // inside log() at this point.
+    ~AsyncLogger() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_.store(true, std::memory_order_release);
+        }
+        wake_.notify_one();
+        flusher_.join();
+        for (auto& ring : rings_) ring->orphaned.store(true, std::memory_order_release);
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // Queues one line. `format` must be a string literal (only its address is stored);
+    // the arguments are copied. Returns false if the record was dropped.
+    template<std::size_t N, typename... Args>
+        requires (async_log_detail::Loggable<Args> && ...)
+    bool log(const char (&format)[N], Args&&... args) {
+        using Record = async_log_detail::Record<async_log_detail::stored_t<Args>...>;
+        static_assert(sizeof(Record) <= sizeof(async_log_detail::Slot::payload) &&
+                      alignof(Record) <= alignof(std::max_align_t),
+                      "log arguments do not fit into one record");
+        async_log_detail::Ring& ring = ring_for_this_thread();
+        async_log_detail::Slot* slot = ring.try_claim();
+        while (slot == nullptr) {
+            if (options_.overflow == OverflowPolicy::drop) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield(); // The flusher frees slots as it writes
+            slot = ring.try_claim();
+        }
+        ::new (static_cast<void*>(slot->payload))
+            Record{format, std::tuple<async_log_detail::stored_t<Args>...>(std::forward<Args>(args)...)};
+        slot->format = &async_log_detail::format_record<async_log_detail::stored_t<Args>...>;
+        ring.publish();
+        return true;
+    }
+
+    // Blocks until every record this thread logged before the call has been written
+    // (and the FILE* flushed).
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const std::uint64_t ticket = flush_requested_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        wake_.notify_one();
+        flushed_cv_.wait(lock, [&] { return flush_done_ >= ticket; });
+    }
+
+    // Records discarded because a ring was full (OverflowPolicy::drop only).
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    AsyncLogger(std::FILE* file, Sink sink, AsyncLoggerOptions options)
+        : file_(file), sink_(std::move(sink)), options_(options), id_(async_log_detail::next_logger_id()) {
+        flusher_ = std::thread(&AsyncLogger::flusher_loop, this);
+    }
+
+    async_log_detail::Ring& ring_for_this_thread() {
+        async_log_detail::ThreadRings& mine = async_log_detail::thread_rings();
+        for (auto& entry : mine.rings) {
+            if (entry.first == id_) return *entry.second; // Fast path: no lock, no allocation
+        }
+        // First record of this thread: forget rings of destroyed loggers, register a new one.
+        std::erase_if(mine.rings, [](const auto& entry) { return entry.second->orphaned.load(std::memory_order_acquire); });
+        auto ring = std::make_shared<async_log_detail::Ring>(options_.ring_capacity);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(ring);
+            rings_version_.fetch_add(1, std::memory_order_release);
+        }
+        mine.rings.emplace_back(id_, ring);
+        return *ring;
+    }
+
+    void write(std::string& batch) {
+        if (batch.empty()) return;
+        if (sink_) {
+            sink_(batch);
+        } else {
+            std::fwrite(batch.data(), 1, batch.size(), file_);
+        }
+        batch.clear();
+    }
+
+    void flusher_loop() {
+        std::string batch;
+        batch.reserve(options_.batch_bytes + async_log_detail::kSlotSize * 4);
+        std::vector<std::shared_ptr<async_log_detail::Ring>> rings;
+        std::uint64_t seen_version = 0;
+        std::uint64_t flush_done = 0;
+        for (;;) {
+            // Read before the pass: an empty pass then proves that everything logged
+            // before the stop or flush request has been written.
+            const bool stopping = stop_.load(std::memory_order_acquire);
+            const std::uint64_t flush_target = flush_requested_.load(std::memory_order_acquire);
+            if (rings_version_.load(std::memory_order_acquire) != seen_version) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                rings = rings_;
+                seen_version = rings_version_.load(std::memory_order_relaxed);
+            }
+
+            std::size_t records = 0;
+            bool exited = false;
+            for (const auto& ring : rings) {
+                // At most one ring's worth per visit, so a busy thread cannot starve the others.
+                for (std::size_t visited = 0; visited < ring->capacity();) {
+                    const std::size_t n = ring->drain(batch, 64);
+                    if (n == 0) break;
+                    visited += n;
+                    records += n;
+                    if (batch.size() >= options_.batch_bytes) write(batch);
+                }
+                exited = exited || ring->owner_exited.load(std::memory_order_acquire);
+            }
+            write(batch);
+            if (exited) remove_exited_rings();
+
+            if (records == 0) {
+                if (flush_target != flush_done) {
+                    if (file_ != nullptr) std::fflush(file_);
+                    flush_done = flush_target;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        flush_done_ = flush_target;
+                    }
+                    flushed_cv_.notify_all();
+                }
+                if (stopping) break;
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait_for(lock, options_.idle_sleep, [&] {
+                    return stop_.load(std::memory_order_relaxed) ||
+                           flush_requested_.load(std::memory_order_relaxed) != flush_target;
+                });
+            }
+        }
+        if (file_ != nullptr) std::fflush(file_);
+    }
+
+    // Rings of finished threads are dropped once the flusher has written them out.
+    void remove_exited_rings() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto removed = std::erase_if(rings_, [](const auto& ring) {
+            return ring->owner_exited.load(std::memory_order_acquire) && ring->empty();
+        });
+        if (removed != 0) rings_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    std::FILE* const file_;
+    const Sink sink_;
+    const AsyncLoggerOptions options_;
+    const std::uint64_t id_;
+    std::atomic<std::uint64_t> dropped_{0};
+
+    std::mutex mutex_; // Guards rings_ and flush_done_; also the flusher's idle wait
+    std::condition_variable wake_;       // Wakes the idle flusher (flush requests, shutdown)
+    std::condition_variable flushed_cv_; // Signals flush_done_ changes
+    std::vector<std::shared_ptr<async_log_detail::Ring>> rings_;
+    std::atomic<std::uint64_t> rings_version_{0};
+    std::atomic<std::uint64_t> flush_requested_{0};
+    std::uint64_t flush_done_ = 0;
+    std::atomic<bool> stop_{false};
+    std::thread flusher_; // Last member: starts after everything above is initialized
+};
+
+/*
+Explanation:
+Printing from many threads through `std::osyncstream(std::cout)` is correct but
+expensive on the hot path: every message builds its own buffer, formats the text on
+the calling thread, and on emit takes a lock shared by all threads and makes a
+system call. A worker that logs in a tight loop spends most of its time there.
+
+`AsyncLogger` moves all of that off the calling thread:
+-   Per-thread rings: on its first `log()` a thread registers a single-producer,
+    single-consumer ring with the logger (the only time `log()` takes a lock). After
+    that, a record is written into the thread's own ring with no lock and no
+    read-modify-write atomic: one release store publishes it. Threads never
+    contend with each other, only (rarely) with the flusher for a cache line.
+-   Deferred formatting: a record holds the address of the format string (a string
+    literal) and a copy of the arguments, constructed in place in a 256-byte slot.
+    Numbers are stored as numbers; text is copied into a `std::string` (short
+    strings fit the small-string buffer, so they do not allocate either). The
+    flusher turns the record into text with `std::to_chars` and the `{}`
+    placeholders (GCC 12 has no `<format>` yet, so the formatter is built in).
+-   Batched output: the flusher formats records of all rings into one buffer and
+    writes it with a single `fwrite` per `batch_bytes` (64 KiB), instead of one
+    write per message. When every ring is empty it naps for `idle_sleep`; `log()`
+    never wakes it, so logging costs no system call.
+-   Full rings: with `OverflowPolicy::block` (default), `log()` yields until the
+    flusher catches up; with `OverflowPolicy::drop` the record is discarded and
+    counted in `dropped()`, so a logging burst never stalls the worker.
+
+Ordering: lines of one thread appear in the order they were logged; lines of
+different threads interleave in batches. `flush()` waits until everything the caller
+logged before it has been written; the destructor writes everything still queued.
+
+`bench/bench_async_logger.cpp` compares messages per second and the p99 latency of a
+single logging call with `std::osyncstream`.
+
+Usage Example:
+```cpp
+AsyncLogger logger;                          // Writes to stdout
+// in any thread:
+logger.log("Worker {} completed work after {}ms.", id, ms);
+logger.flush();                              // Before mixing with std::cout, for example
+```
+*/
@@ -0,0 +1,172 @@
+// phased_engine.hpp
+// Persistent workers that compute an iterative, phase-synchronized algorithm (stencils,
+// simulations, Jacobi iterations) on a double-buffered std::vector<T>.
+// - Every phase each worker computes its slice of `next` from all of `current`.
+// - A std::barrier separates the phases; its completion function swaps the buffers
+//   and asks the caller whether to continue, once per phase, while all workers wait.
+// - Threads are created once per engine and reused for every phase and every run().
+#pragma once
+
+#include <algorithm>  // For std::min
+#include <barrier>    // std::barrier (C++20)
+#include <cstddef>
+#include <functional> // For std::function
+#include <span>       // std::span (C++20)
+#include <thread>
+#include <utility>    // For std::move, std::swap
+#include <vector>
+
+template<typename T>
+class PhasedEngine {
+public:
+    // step(current, next, begin, end): write next[begin, end), reading anything in current.
+    using Step = std::function<void(std::span<const T> current, std::span<T> next, std::size_t begin, std::size_t end)>;
+    // on_phase(iteration, current, previous) runs once after each phase (current is the
+    // state just computed, 1-based iteration). Return false to stop early. Must not throw.
+    using OnPhase = std::function<bool(std::size_t iteration, std::span<const T> current, std::span<const T> previous)>;
+
+    // `participants` threads compute every phase: the thread that calls run() plus
+    // participants - 1 persistent workers. 0 means one per hardware thread.
+    explicit PhasedEngine(std::vector<T> initial, unsigned participants = 0)
+        : participants_(participants != 0 ? participants : std::max(1u, std::thread::hardware_concurrency())),
+          current_(std::move(initial)), next_(current_),
+          start_(static_cast<std::ptrdiff_t>(participants_), StartCompletion{this}),
+          phase_(static_cast<std::ptrdiff_t>(participants_), PhaseCompletion{this}) {
+        workers_.reserve(participants_ - 1);
+        for (unsigned i = 1; i < participants_; ++i) workers_.emplace_back(&PhasedEngine::worker_loop, this, i);
+    }
+
+    ~PhasedEngine() {
+        pending_shutdown_ = true;
+        start_.arrive_and_wait(); // Wakes the workers, which see shutdown_ and exit
+        for (std::thread& w : workers_) w.join();
+    }
+
+    PhasedEngine(const PhasedEngine&) = delete;
+    PhasedEngine& operator=(const PhasedEngine&) = delete;
+
+    unsigned participants() const { return participants_; }
+
+    // Runs up to max_iterations phases (fewer if on_phase returns false) and returns the
+    // number of phases run. Must be called from one thread at a time.
+    std::size_t run(std::size_t max_iterations, Step step, OnPhase on_phase = OnPhase()) {
+        if (max_iterations == 0) return 0;
+        // Workers of the previous run may still be on their way to start_, reading
+        // stop_; the new run's settings are installed by start_'s completion function.
+        pending_step_ = std::move(step);
+        pending_on_phase_ = std::move(on_phase);
+        pending_max_iterations_ = max_iterations;
+        start_.arrive_and_wait(); // Releases the workers into the phase loop
+        compute_phases(0);
+        return iteration_;
+    }
+
+    // The state after the last completed phase.
+    std::span<const T> state() const { return current_; }
+
+private:
+    // std::barrier requires completion functions that are nothrow-invocable.
+    struct StartCompletion {
+        PhasedEngine* engine;
+        void operator()() noexcept { engine->begin_run(); }
+    };
+    struct PhaseCompletion {
+        PhasedEngine* engine;
+        void operator()() noexcept { engine->complete_phase(); }
+    };
+
+    // Like complete_phase(), runs while every participant is blocked in start_.
+    void begin_run() {
+        step_ = std::move(pending_step_);
+        on_phase_ = std::move(pending_on_phase_);
+        max_iterations_ = pending_max_iterations_;
+        shutdown_ = pending_shutdown_;
+        iteration_ = 0;
+        stop_ = false;
+    }
+
+    // Runs on exactly one thread while all participants are blocked in the barrier,
+    // so it may touch the buffers and the control flags freely. The barrier makes its
+    // writes visible to every participant of the next phase.
+    void complete_phase() {
+        std::swap(current_, next_);
+        ++iteration_;
+        const bool go_on = !on_phase_ || on_phase_(iteration_, std::span<const T>(current_), std::span<const T>(next_));
+        stop_ = !go_on || iteration_ >= max_iterations_;
+    }
+
+    void compute_phases(unsigned index) {
+        const std::size_t n = current_.size();
+        const std::size_t chunk = (n + participants_ - 1) / participants_;
+        const std::size_t begin = std::min(n, index * chunk), end = std::min(n, begin + chunk);
+        while (!stop_) {
+            if (begin < end) step_(std::span<const T>(current_), std::span<T>(next_), begin, end);
+            phase_.arrive_and_wait();
+        }
+    }
+
+    void worker_loop(unsigned index) {
+        for (;;) {
+            start_.arrive_and_wait();
+            if (shutdown_) return;
+            compute_phases(index);
+        }
+    }
+
+    const unsigned participants_;
+    std::vector<T> current_, next_;
+    std::barrier<StartCompletion> start_;
+    std::barrier<PhaseCompletion> phase_;
+    std::vector<std::thread> workers_;
+
+    // Set by run() or the destructor (only the caller's thread touches these).
+    Step pending_step_;
+    OnPhase pending_on_phase_;
+    std::size_t pending_max_iterations_ = 0;
+    bool pending_shutdown_ = false;
+
+    // Written only inside the completion functions; read after a barrier.
+    Step step_;
+    OnPhase on_phase_;
+    std::size_t max_iterations_ = 0;
+    std::size_t iteration_ = 0;
+    bool stop_ = false;
+    bool shutdown_ = false;
+};
+
+/*
+Explanation:
+Iterative algorithms such as stencils compute generation k+1 from generation k, and
+every cell of k must be complete before any cell of k+1 is computed. Spawning threads
+for every generation and waiting for them with a `std::latch` works, but pays thread
+creation for every iteration, and a `std::latch` cannot be reused.
+
+`PhasedEngine<T>` keeps its threads for its whole lifetime:
+-   `std::barrier` is reusable: when all participants have arrived, it runs its
+    completion function on one of them and then releases everyone into the next phase.
+-   Double buffering: workers read `current` and write only their slice of `next`, so
+    no locks are needed within a phase. The completion function swaps the two vectors
+    (a pointer swap), which is safe because nobody else runs at that moment.
+-   The completion function also calls `on_phase`, which can inspect both generations
+    (e.g. for a convergence check) and stop the loop. Its decision reaches all workers
+    through the barrier.
+-   A second barrier (`start_`) parks the workers between `run()` calls. Its
+    completion function installs the settings of the next run, so they never change
+    while a worker of the previous run might still read them.
+
+The calling thread is one of the participants, so `PhasedEngine(v, 4)` uses 4 threads
+in total. `bench/bench_phased_engine.cpp` compares it with per-iteration thread spawn
+plus `std::latch`.
+
+Usage Example:
+```cpp
+PhasedEngine<double> heat(std::vector<double>(1000, 0.0), 4);
+heat.run(500, [](std::span<const double> cur, std::span<double> next, std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; ++i) {
+        const double left = i > 0 ? cur[i - 1] : 100.0, right = i + 1 < cur.size() ? cur[i + 1] : 0.0;
+        next[i] = (left + cur[i] + right) / 3.0;
+    }
+});
+std::cout << heat.state()[0] << '\n';
+```
+*/
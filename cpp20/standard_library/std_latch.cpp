@@ -6,6 +6,13 @@
 #include <string>
 #include <chrono>   // For std::chrono::milliseconds
 #include <syncstream> // For std::osyncstream (C++20) for synchronized cout
+#include <algorithm> // For std::max
+#include <cmath>    // For std::fabs
+#include <span>     // For std::span (C++20)
+
+#include "phased_engine.hpp" // PhasedEngine: persistent workers synchronized by std::barrier
+#include "adaptive_sync.hpp" // AdaptiveLatch, AdaptiveBarrier: spin, then futex wait
+#include "async_logger.hpp"  // AsyncLogger: per-thread lock-free buffers, background writer
 
 void worker_task(int id, std::latch& completion_latch, int work_duration_ms) {
     // Simulate some work
@@ -21,6 +28,16 @@ void worker_task(int id, std::latch& completion_latch, int work_duration_ms) {
     // completion_latch.arrive_and_wait(); // Alternative: decrement and then wait for others
 }
 
+// Like worker_task, but logs many progress lines through an AsyncLogger: each line is
+// queued in this thread's own buffer and formatted and written by the logger's thread.
+void logged_worker_task(int id, std::latch& completion_latch, AsyncLogger& logger, int steps) {
+    for (int step = 1; step <= steps; ++step) {
+        logger.log("Worker {} finished step {} of {}.", id, step, steps);
+    }
+    logger.log("Worker {} completed {} steps. Decrementing latch.", id, steps);
+    completion_latch.count_down();
+}
+
 void dependent_task(int id, std::latch& start_latch) {
     std::osyncstream(std::cout) << "Dependent task " << id << " is waiting on the latch..." << std::endl;
     
@@ -106,6 +123,96 @@ int main() {
     }
     worker_threads.clear();
 
+    // --- Scenario 4: Repeated phases with std::barrier (PhasedEngine) ---
+    // A latch is used up after one phase. For an iterative computation the same
+    // threads meet at a reusable std::barrier after every iteration instead.
+    std::cout << "\nScenario 4: Heat diffusion along a rod, 4 threads, one std::barrier phase per step." << std::endl;
+    {
+        const std::size_t cells = 16;
+        std::vector<double> rod(cells, 0.0);
+        rod[0] = 100.0; // The left end is held at 100 degrees, the right end at 0
+        PhasedEngine<double> engine(rod, 4);
+
+        auto step = [](std::span<const double> cur, std::span<double> next, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (i == 0 || i + 1 == cur.size()) {
+                    next[i] = cur[i]; // Fixed boundary temperatures
+                } else {
+                    next[i] = cur[i] + 0.25 * (cur[i - 1] - 2.0 * cur[i] + cur[i + 1]);
+                }
+            }
+        };
+        // The barrier's completion step: runs once per phase while all 4 threads wait.
+        auto on_phase = [](std::size_t iteration, std::span<const double> cur, std::span<const double> prev) {
+            double max_change = 0.0;
+            for (std::size_t i = 0; i < cur.size(); ++i) max_change = std::max(max_change, std::fabs(cur[i] - prev[i]));
+            if (iteration % 200 == 0) {
+                std::cout << "  after " << iteration << " phases: middle cell = " << cur[cur.size() / 2]
+                          << ", max change = " << max_change << std::endl;
+            }
+            return max_change > 1e-3; // Stop once the temperatures have settled
+        };
+        const std::size_t phases = engine.run(10000, step, on_phase);
+        std::cout << "Main thread: converged after " << phases << " phases (same " << engine.participants()
+                  << " threads throughout). Temperatures:";
+        for (double t : engine.state()) std::cout << " " << static_cast<int>(t + 0.5);
+        std::cout << std::endl;
+    }
+
+    // --- Scenario 5: Spin-then-park latch and barrier (adaptive_sync.hpp) ---
+    // Same interface as std::latch/std::barrier, but waiters spin briefly before
+    // sleeping in the kernel, which matters when phases last only microseconds.
+    std::cout << "\nScenario 5: AdaptiveLatch and AdaptiveBarrier with very short phases." << std::endl;
+    {
+        const int num_threads = 4;
+        const int num_phases = 1000;
+        std::vector<int> phase_done_by(num_threads, -1);
+        int completed_phases = 0;
+        auto on_completion = [&completed_phases]() noexcept { ++completed_phases; };
+        AdaptiveBarrier<decltype(on_completion)> phase_barrier(num_threads, on_completion);
+        AdaptiveLatch all_finished(num_threads);
+
+        for (int i = 0; i < num_threads; ++i) {
+            worker_threads.emplace_back([&, i]() {
+                for (int phase = 0; phase < num_phases; ++phase) {
+                    phase_done_by[i] = phase;        // A tiny "phase" of work
+                    phase_barrier.arrive_and_wait(); // Everyone finished this phase
+                }
+                all_finished.count_down();
+            });
+        }
+        all_finished.wait();
+        std::cout << "Main thread: " << num_threads << " threads completed " << completed_phases
+                  << " barrier phases; last phase seen by thread 1: " << phase_done_by[0] << std::endl;
+        for (std::thread& t : worker_threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+        worker_threads.clear();
+    }
+
+    // --- Scenario 6: Logging from workers without osyncstream (async_logger.hpp) ---
+    // Workers only copy their arguments into a per-thread ring buffer; the logger's
+    // background thread formats the lines and writes them to stdout in large batches.
+    std::cout << "\nScenario 6: " << num_workers << " workers log through an AsyncLogger." << std::endl;
+    {
+        AsyncLogger logger; // stdout
+        std::latch logged_workers_finished(num_workers);
+        for (int i = 0; i < num_workers; ++i) {
+            worker_threads.emplace_back(logged_worker_task, i + 1, std::ref(logged_workers_finished), std::ref(logger), 3);
+        }
+        logged_workers_finished.wait();
+        logger.log("Main thread: All {} logging workers have finished.", num_workers);
+        logger.flush(); // Everything queued so far is on stdout before std::cout is used again
+        for (std::thread& t : worker_threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+        worker_threads.clear();
+    }
+
     std::cout << "\nstd::latch example finished." << std::endl;
     return 0;
 }
@@ -157,11 +264,38 @@ Use Cases:
     threads arrive, a completion phase function can be executed, and then the
     barrier resets for the next phase. More complex, for cyclic synchronization.
 
+Scenario 4: `std::barrier` and `PhasedEngine` (`phased_engine.hpp`):
+-   Iterative algorithms (stencils, simulations) need all threads to finish step k
+    before any thread starts step k+1. Creating threads and a new latch for every
+    step pays thread creation every time.
+-   `PhasedEngine<T>` keeps its worker threads and meets them at a reusable
+    `std::barrier` after every step. The barrier's completion function runs once
+    per phase while everyone waits: it swaps the double-buffered state and calls
+    a user check (here: has the temperature converged?) that can end the loop.
+-   `bench/bench_phased_engine.cpp` compares it with spawning threads and waiting
+    on a `std::latch` every iteration.
+
+Scenario 5: `AdaptiveLatch` and `AdaptiveBarrier` (`adaptive_sync.hpp`):
+-   Same operations as `std::latch` and `std::barrier` (`count_down`, `wait`,
+    `arrive_and_wait`, completion function), tuned for wake-up latency: a waiter
+    spins with the CPU's `pause` instruction for a bounded time and only then
+    sleeps on a Linux futex. The releasing thread skips the wake-up system call
+    if every waiter is still spinning.
+-   `bench/bench_adaptive_sync.cpp` measures release-to-wake latency against
+    `std::latch` and `std::barrier`.
+
 Thread Safety with Output:
 -   The example uses `std::osyncstream(std::cout)` for printing from multiple
     threads. `std::osyncstream` (C++20, from `<syncstream>`) ensures that output
     operations are atomic with respect to each other, preventing interleaved output
     from different threads on standard streams like `std::cout`.
+-   Scenario 6 uses `AsyncLogger` (`async_logger.hpp`) instead. `osyncstream` formats
+    on the calling thread and takes a global lock to emit every message; `log()`
+    only copies the arguments into the calling thread's own lock-free ring buffer.
+    A background thread formats the `{}` placeholders and writes the lines in large
+    batches; `flush()` waits until they are written. Lines of one thread stay in
+    order. `bench/bench_async_logger.cpp` compares messages per second and p99
+    latency per call with `osyncstream`.
 
 How to compile:
 g++ -std=c++20 std_latch.cpp -o std_latch_example -pthread